@@ -25,10 +25,16 @@
     #include <aio.h>
     #include <errno.h>
 
+    #include "io_uring_ring.h"
+
     /**
      * Async RAII file reader for use with streams that want to take ownership of
      * the underlying FILE pointer. File pointer is closed once the CAsyncFileReader
      * instance gets out of scope.
+     *
+     * Reads are submitted to the shared io_uring instance when available (so
+     * reads of many concurrently served blocks are in flight without a thread
+     * per request) and to POSIX aio otherwise.
      */
     class CAsyncFileReader
     {
@@ -40,12 +46,23 @@
             mOffset = ftell(mFile.get());
             mFileId = fileno(mFile.get());
             assert(mFileId != -1);
+#ifdef USE_IO_URING
+            mRing = CIoUring::Get();
+#endif
         }
 
         ~CAsyncFileReader()
         {
             if(mReadInProgress)
             {
+#ifdef USE_IO_URING
+                if(mRing)
+                {
+                    // buffer must not be written to after we return
+                    mRing->Cancel(*mRequest);
+                    return;
+                }
+#endif
                 aio_cancel(mFileId, &mControllBlock);
             }
         }
@@ -53,6 +70,9 @@
         CAsyncFileReader(CAsyncFileReader&& other)
             : mFileId{other.mFileId}
             , mOffset{other.mOffset}
+#ifdef USE_IO_URING
+            , mRing{other.mRing}
+#endif
             , mEndOfStream{other.mEndOfStream}
         {
             // Check that we aren't moving while read is in progress as
@@ -86,6 +106,13 @@
                 return 0;
             }
 
+#ifdef USE_IO_URING
+            if(mRing)
+            {
+                return ReadIoUring(pch, maxSize);
+            }
+#endif
+
             if(!mReadInProgress)
             {
                 memset(&mControllBlock, 0, sizeof(aiocb));
@@ -137,6 +164,54 @@
             mFile.reset();
         }
 
+#ifdef USE_IO_URING
+        size_t ReadIoUring(char* pch, size_t maxSize)
+        {
+            if(!mReadInProgress)
+            {
+                if(!mRequest)
+                {
+                    mRequest = std::make_unique<CIoUring::Request>();
+                }
+
+                if(!mRing->SubmitRead(*mRequest, mFileId, pch, maxSize, mOffset))
+                {
+                    // ring is full - retry on the next call
+                    return 0;
+                }
+
+                mReadInProgress = true;
+            }
+
+            mRing->Poll();
+            if(!mRequest->done.load(std::memory_order_acquire))
+            {
+                return 0;
+            }
+
+            mReadInProgress = false;
+            int numBytes = mRequest->result;
+
+            if(numBytes < 0)
+            {
+                CloseFile();
+                throw
+                    std::ios_base::failure(
+                        "CAsyncFileReader::Read: read failed");
+            }
+            else if(numBytes > 0)
+            {
+                mOffset += numBytes;
+            }
+            else
+            {
+                mEndOfStream = true;
+            }
+
+            return numBytes;
+        }
+#endif
+
         void EnqueueReadRequest(aiocb& controllBlock)
         {
             if (aio_read(&controllBlock) == -1)
@@ -156,6 +231,11 @@
         UniqueCFile mFile;
         int mFileId;
         size_t mOffset;
+#ifdef USE_IO_URING
+        CIoUring* mRing = nullptr;
+        // request must keep its address while read is in progress
+        std::unique_ptr<CIoUring::Request> mRequest;
+#endif
 #if !defined(__clang__) && defined(__GNUC__)
 	//warning: invalid use of ‘struct aiocb’ with a zero-size array in ‘class CAsyncFileReader’ [-Wpedantic]
         #pragma GCC diagnostic ignored "-Wpedantic"
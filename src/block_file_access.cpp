@@ -277,7 +277,7 @@ bool BlockFileAccess::ReadBlockFromDisk(
 auto BlockFileAccess::GetDiskBlockStreamReader(
     const CDiskBlockPos& pos,
     bool calculateDiskBlockMetadata)
-    -> std::unique_ptr<CBlockStreamReader<CFileReader>>
+    -> std::unique_ptr<CBlockStreamReader<CReadAheadFileReader>>
 {
     UniqueCFile file{ ::OpenBlockFile(pos, OpenDiskType::ReadIfExists, true) };
 
@@ -289,13 +289,26 @@ auto BlockFileAccess::GetDiskBlockStreamReader(
     }
 
     return
-        std::make_unique<CBlockStreamReader<CFileReader>>(
+        std::make_unique<CBlockStreamReader<CReadAheadFileReader>>(
             std::move(file),
             CStreamVersionAndType{SER_DISK, CLIENT_VERSION},
             calculateDiskBlockMetadata,
             pos);
 }
 
+std::unique_ptr<CMappedFileStream> BlockFileAccess::MapBlockData(
+    FILE* file,
+    size_t size)
+{
+    if (size < MIN_MMAP_BLOCK_SIZE ||
+        !gArgs.GetBoolArg("-blockfilemmap", DEFAULT_BLOCK_FILE_MMAP))
+    {
+        return nullptr;
+    }
+
+    return CMappedFileStream::Make(file, size);
+}
+
 bool BlockFileAccess::UndoReadFromDisk(
     CBlockUndo& blockundo,
     const CDiskBlockPos& pos,
@@ -10,7 +10,9 @@
 
 #include "blockstreams.h"
 #include "cfile_util.h"
+#include "mapped_file_stream.h"
 #include "protocol.h"
+#include "read_ahead_file_reader.h"
 #include "streams.h"
 
 class CBlock;
@@ -26,6 +28,13 @@ class CTransaction;
 static constexpr unsigned int BLOCKFILE_CHUNK_SIZE = 0x1000000; // 16 MiB
 /** The pre-allocation chunk size for rev?????.dat files */
 static constexpr unsigned int UNDOFILE_CHUNK_SIZE = 0x100000; // 1 MiB
+/** Default for -blockfilemmap */
+static constexpr bool DEFAULT_BLOCK_FILE_MMAP = true;
+/**
+ * Blocks smaller than this are read into a buffer even if -blockfilemmap is
+ * enabled as mapping and unmapping them costs more than copying.
+ */
+static constexpr size_t MIN_MMAP_BLOCK_SIZE = 64 * 1024;
 
 /**
  * Utility functions for opening block and undo files.
@@ -44,10 +53,18 @@ namespace BlockFileAccess
         const CDiskBlockPos& pos,
         const Config& config);
 
-    std::unique_ptr<CBlockStreamReader<CFileReader>> GetDiskBlockStreamReader(
+    std::unique_ptr<CBlockStreamReader<CReadAheadFileReader>> GetDiskBlockStreamReader(
         const CDiskBlockPos& pos,
         bool calculateDiskBlockMetadata=false);
 
+    /**
+     * Map size bytes of block data at the current position of the block file
+     * into memory. Returns nullptr if memory mapped reads are disabled
+     * (-blockfilemmap), the block is too small to benefit from them or mapping
+     * fails - caller should fall back to reading from file in that case.
+     */
+    std::unique_ptr<CMappedFileStream> MapBlockData(FILE* file, size_t size);
+
     bool UndoReadFromDisk(
         CBlockUndo& blockundo,
         const CDiskBlockPos& pos,
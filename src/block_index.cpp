@@ -274,7 +274,7 @@ void CBlockIndex::SetBlockIndexFileMetaDataIfNotSet(
     SetBlockIndexFileMetaDataIfNotSetNL(metadata, notifyDirty);
 }
 
-std::unique_ptr<CBlockStreamReader<CFileReader>> CBlockIndex::GetDiskBlockStreamReader(
+std::unique_ptr<CBlockStreamReader<CReadAheadFileReader>> CBlockIndex::GetDiskBlockStreamReader(
     bool calculateDiskBlockMetadata) const
 {
     std::lock_guard lock { GetMutex() };
@@ -284,11 +284,11 @@ std::unique_ptr<CBlockStreamReader<CFileReader>> CBlockIndex::GetDiskBlockStream
                 calculateDiskBlockMetadata);
 }
 
-std::unique_ptr<CBlockStreamReader<CFileReader>> CBlockIndex::GetDiskBlockStreamReader(
+std::unique_ptr<CBlockStreamReader<CReadAheadFileReader>> CBlockIndex::GetDiskBlockStreamReader(
     const Config &config, bool calculateDiskBlockMetadata) const
 {
     std::lock_guard lock { GetMutex() };
-    std::unique_ptr<CBlockStreamReader<CFileReader>> blockStreamReader;
+    std::unique_ptr<CBlockStreamReader<CReadAheadFileReader>> blockStreamReader;
     try
     {
         blockStreamReader = BlockFileAccess::GetDiskBlockStreamReader(GetBlockPosNL(), calculateDiskBlockMetadata);
@@ -382,6 +382,11 @@ auto CBlockIndex::StreamBlockFromDisk(
     // We expect that block data on disk is in same format as data sent over the
     // network. If this would change in the future then CBlockStream would need
     // to be used to change the resulting fromat.
+    if (auto mapped = BlockFileAccess::MapBlockData(file.get(), mDiskBlockMetaData.diskDataSize))
+    {
+        return {std::move(mapped), mDiskBlockMetaData};
+    }
+
     return
         {
             std::make_unique<CFixedSizeStream<CAsyncFileReader>>(
@@ -403,6 +408,11 @@ std::unique_ptr<CForwardReadonlyStream> CBlockIndex::StreamSyncBlockFromDisk() c
 
     if (nStatus.hasDiskBlockMetaData())
     {
+        if (auto mapped = BlockFileAccess::MapBlockData(file.get(), mDiskBlockMetaData.diskDataSize))
+        {
+            return mapped;
+        }
+
         return
             std::make_unique<CSyncFixedSizeStream<CFileReader>>(
                 mDiskBlockMetaData.diskDataSize,
@@ -22,6 +22,7 @@
 
 struct CBlockIndexWorkComparator;
 
+class CReadAheadFileReader;
 template<typename Reader>
 class CBlockStreamReader;
 
@@ -795,11 +796,11 @@ public:
     void SetBlockIndexFileMetaDataIfNotSet(
         CDiskBlockMetaData metadata, DirtyBlockIndexStore& notifyDirty) const;
 
-    std::unique_ptr<CBlockStreamReader<CFileReader>> GetDiskBlockStreamReader(
+    std::unique_ptr<CBlockStreamReader<CReadAheadFileReader>> GetDiskBlockStreamReader(
                             bool calculateDiskBlockMetadata=false) const;
 
     // Same as above except that pos is obtained from pindex and some additional checks are performed
-    std::unique_ptr<CBlockStreamReader<CFileReader>> GetDiskBlockStreamReader(
+    std::unique_ptr<CBlockStreamReader<CReadAheadFileReader>> GetDiskBlockStreamReader(
                             const Config &config, bool calculateDiskBlockMetadata=false) const;
 
     BlockStreamAndMetaData StreamBlockFromDisk(int networkVersion, DirtyBlockIndexStore& notifyDirty) const;
@@ -11,6 +11,7 @@
 #include "consensus/validation.h"
 #include "hash.h"
 #include "random.h"
+#include "read_ahead_file_reader.h"
 #include "streams.h"
 #include "txmempool.h"
 #include "validation.h"
@@ -31,7 +32,7 @@ CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock &block)
 }
 
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(
-    CBlockStreamReader<CFileReader>& stream)
+    CBlockStreamReader<CReadAheadFileReader>& stream)
     : nonce{GetRand(std::numeric_limits<uint64_t>::max())}
     , prefilledtxn{1}
 {
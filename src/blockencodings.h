@@ -11,7 +11,7 @@
 
 class Config;
 class CTxMemPool;
-class CFileReader;
+class CReadAheadFileReader;
 template<typename Reader>
 class CBlockStreamReader;
 
@@ -168,7 +168,7 @@ public:
     CBlockHeaderAndShortTxIDs() {}
 
     CBlockHeaderAndShortTxIDs(const CBlock &block);
-    CBlockHeaderAndShortTxIDs(CBlockStreamReader<CFileReader>& stream);
+    CBlockHeaderAndShortTxIDs(CBlockStreamReader<CReadAheadFileReader>& stream);
 
     uint64_t GetShortID(const uint256 &txhash) const;
 
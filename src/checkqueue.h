@@ -13,6 +13,7 @@
 #include <optional>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
 #include <boost/thread/thread.hpp>
@@ -34,6 +35,14 @@
  * done adding work, it temporarily joins the worker pool as an N'th worker,
  * until all jobs are done.
  *
+ * If T defines a Batch type, T must also provide
+ * `std::optional<bool> operator()(const task::CCancellationToken&, T::Batch&)`
+ * which may defer part of the verification to the batch; the batch must then
+ * provide `bool Verify()`. Each worker runs the checks it takes off the queue
+ * against one batch and verifies the batch at the end. If anything fails, the
+ * checks are run again without a batch so that exactly the failing checks are
+ * reported.
+ *
  * NOTE: This class is intended to be used through CCheckQueuePool and not by
  *       itself.
  */
@@ -43,6 +52,12 @@ private:
     static_assert(
         std::is_same_v<std::optional<bool>,
         decltype(std::declval<T>()(std::declval<task::CCancellationToken>()))>);
+
+    //! Whether T supports deferring verification to a batch
+    template <typename U, typename = void>
+    struct HasBatch : std::false_type {};
+    template <typename U>
+    struct HasBatch<U, std::void_t<typename U::Batch>> : std::true_type {};
     /**
      * Scope guard that makes sure that even if an exception is thrown inside
      * Loop() (e.g. by cond.wait(lock);) the worker count will be correct.
@@ -244,22 +259,70 @@ private:
                 fOk = fAllOk;
             }
             // execute work
-            for (T &check : vChecks) {
-                if (!fOk.has_value() || !fOk.value() || mSessionToken->IsCanceled())
-                {
-                    break;
-                }
-
-                fOk = check(*mSessionToken);
-                if (fOk.has_value() && (fOk.value() == false))
-                {
-                    vTempFailedChecks.emplace_back(std::move(check));
-                }
+            if constexpr (HasBatch<T>::value)
+            {
+                fOk = RunBatched(vChecks, vTempFailedChecks, fOk);
+            }
+            else
+            {
+                fOk = Run(vChecks, vTempFailedChecks, fOk);
             }
             vChecks.clear();
         } while (true);
     }
 
+    /** Run checks one by one until one of them fails. */
+    std::optional<bool> Run(
+        std::vector<T>& vChecks,
+        std::vector<T>& vFailedChecks,
+        std::optional<bool> fOk)
+    {
+        for (T &check : vChecks) {
+            if (!fOk.has_value() || !fOk.value() || mSessionToken->IsCanceled())
+            {
+                break;
+            }
+
+            fOk = check(*mSessionToken);
+            if (fOk.has_value() && (fOk.value() == false))
+            {
+                vFailedChecks.emplace_back(std::move(check));
+            }
+        }
+        return fOk;
+    }
+
+    /**
+     * Run checks deferring what they can to a batch that is verified at the
+     * end. Falls back to Run() if a check or the batch fails.
+     */
+    std::optional<bool> RunBatched(
+        std::vector<T>& vChecks,
+        std::vector<T>& vFailedChecks,
+        std::optional<bool> fOk)
+    {
+        typename T::Batch batch;
+        std::optional<bool> fBatchOk = fOk;
+        for (T &check : vChecks) {
+            if (!fBatchOk.has_value() || !fBatchOk.value() || mSessionToken->IsCanceled())
+            {
+                break;
+            }
+
+            fBatchOk = check(*mSessionToken, batch);
+        }
+
+        if (!fBatchOk.has_value() || mSessionToken->IsCanceled())
+        {
+            return fBatchOk;
+        }
+        if (fBatchOk.value() && batch.Verify())
+        {
+            return fBatchOk;
+        }
+        return Run(vChecks, vFailedChecks, fOk);
+    }
+
 public:
     //! Create a new check queue
     CCheckQueue(CCheckQueue&&) = delete;
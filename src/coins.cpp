@@ -11,6 +11,7 @@
 
 #include <cassert>
 #include <config.h>
+#include <unordered_set>
 
 CCoinsViewCache::CCoinsViewCache(const ICoinsView& view)
     : mThreadId{std::this_thread::get_id()}
@@ -76,6 +77,16 @@ std::optional<CoinImpl> CCoinsViewCache::GetCoin(const COutPoint &outpoint, bool
     return coinFromView;
 }
 
+void CCoinsViewCache::PrefetchInputs(const std::vector<CTransactionRef>& txns) const
+{
+    assert(mThreadId == std::this_thread::get_id());
+
+    if (auto outpoints = GetExternalInputs(txns); !outpoints.empty())
+    {
+        mView->PrefetchCoins(std::move(outpoints));
+    }
+}
+
 void CCoinsViewCache::AddCoin(const COutPoint &outpoint, CoinWithScript&& coin,
                               bool possible_overwrite,
                               int32_t genesisActivationHeight) {
@@ -99,6 +110,38 @@ void CCoinsViewCache::AddCoin(const COutPoint &outpoint, CoinWithScript&& coin,
     mCache.AddCoin(outpoint, std::move(coin), possible_overwrite, genesisActivationHeight);
 }
 
+std::vector<COutPoint> GetExternalInputs(const std::vector<CTransactionRef>& txns)
+{
+    std::unordered_set<uint256, SaltedTxidHasher> created;
+    created.reserve(txns.size());
+    size_t inputsCount = 0;
+    for (const auto& tx : txns)
+    {
+        created.insert(tx->GetId());
+        inputsCount += tx->vin.size();
+    }
+
+    std::vector<COutPoint> outpoints;
+    outpoints.reserve(inputsCount);
+    for (const auto& tx : txns)
+    {
+        if (tx->IsCoinBase())
+        {
+            continue;
+        }
+
+        for (const CTxIn& txin : tx->vin)
+        {
+            if (!created.count(txin.prevout.GetTxId()))
+            {
+                outpoints.push_back(txin.prevout);
+            }
+        }
+    }
+
+    return outpoints;
+}
+
 void AddCoins(CCoinsViewCache &cache, const CTransaction &tx, int32_t nHeight, int32_t genesisActivationHeight,
               bool check) {
     bool fCoinbase = tx.IsCoinBase();
@@ -348,6 +391,40 @@ void CoinsStore::Uncache(const std::vector<COutPoint>& vOutpoints)
     }
 }
 
+auto CoinsStore::GetDirtyEntries() const -> DirtyEntries
+{
+    DirtyEntries entries;
+    for (const auto& [outpoint, entry] : cacheCoins) {
+        if (entry.flags & CCoinsCacheEntry::DIRTY) {
+            entries.emplace_back(&outpoint, &entry);
+        }
+    }
+    return entries;
+}
+
+auto CoinsStore::GetDirtyEntry(const COutPoint& outpoint) const -> DirtyEntries::value_type
+{
+    auto it = cacheCoins.find(outpoint);
+    if (it == cacheCoins.end() || !(it->second.flags & CCoinsCacheEntry::DIRTY)) {
+        return {nullptr, nullptr};
+    }
+    return {&it->first, &it->second};
+}
+
+void CoinsStore::MarkWritten(const DirtyEntries& entries)
+{
+    for (const auto& [outpoint, entry] : entries) {
+        CCoinsMap::iterator it = cacheCoins.find(*outpoint);
+        assert(it != cacheCoins.end() && &it->second == entry);
+        if (it->second.GetCoinImpl().IsSpent()) {
+            EraseCoin(it);
+        } else {
+            // The underlying store now has the coin so it is no longer FRESH
+            it->second.flags = 0;
+        }
+    }
+}
+
 void CoinsStore::BatchWrite(CCoinsMap& mapCoins)
 {
     for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
@@ -8,6 +8,7 @@
 
 #include "compressor.h"
 #include "core_memusage.h"
+#include "flat_hash_map.h"
 #include "hash.h"
 #include "memusage.h"
 #include "serialize.h"
@@ -20,6 +21,7 @@
 #include <mutex>
 #include <optional>
 #include <thread>
+#include <vector>
 
 class CoinWithScript;
 
@@ -349,8 +351,13 @@ public:
     size_t DynamicMemoryUsage() const { return coin.DynamicMemoryUsage(); }
 };
 
+#ifdef FLAT_COINS_MAP
+typedef FlatHashMap<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher>
+    CCoinsMap;
+#else
 typedef std::unordered_map<COutPoint, CCoinsCacheEntry, SaltedOutpointHasher>
     CCoinsMap;
+#endif
 
 /**
  * UTXO coins view interface.
@@ -370,6 +377,10 @@ protected:
     //! Retrieve the block hash whose state this CCoinsProvider currently represents
     virtual uint256 GetBestBlock() const = 0;
 
+    //! Load the given coins into view's cache ahead of the GetCoin() calls
+    //! that will request them. Views without a cache of their own ignore it.
+    virtual void PrefetchCoins(std::vector<COutPoint>&& outpoints) const {}
+
     virtual void ReleaseLock() { assert(!"Should not be used!"); }
     virtual void ReLock() { assert(!"Should not be used!"); }
 
@@ -403,6 +414,8 @@ public:
 
     size_t CachedCoinsCount() const { return cacheCoins.size(); }
 
+    bool HaveCoin(const COutPoint& outpoint) const { return cacheCoins.count(outpoint); }
+
     std::optional<CoinImpl> FetchCoin(const COutPoint& outpoint) const;
 
     CCoinsMap MoveOutCoins()
@@ -424,6 +437,22 @@ public:
     void Uncache(const std::vector<COutPoint>& vOutpoints);
     void BatchWrite(CCoinsMap& mapCoins);
 
+    using DirtyEntries =
+        std::vector<std::pair<const COutPoint*, const CCoinsCacheEntry*>>;
+
+    //! Get entries that were modified since they were last written to the
+    //! underlying store. Returned pointers are invalidated by the same calls
+    //! that invalidate references to map values.
+    DirtyEntries GetDirtyEntries() const;
+
+    //! Get the entry of outpoint if it was modified since it was last written
+    //! to the underlying store ({nullptr, nullptr} otherwise).
+    DirtyEntries::value_type GetDirtyEntry(const COutPoint& outpoint) const;
+
+    //! Mark entries returned by GetDirtyEntries() as written to the underlying
+    //! store - spent entries are removed and the rest become unmodified.
+    void MarkWritten(const DirtyEntries& entries);
+
     const CoinImpl& ReplaceWithCoinWithScript(const COutPoint& outpoint, CoinImpl&& newCoin)
     {
         auto it = cacheCoins.find(outpoint);
@@ -551,6 +580,13 @@ public:
     //! set represented by this view
     bool HaveInputs(const CTransaction &tx) const;
 
+    /**
+     * Request the underlying view to bulk load all coins spent by the given
+     * transactions (see GetExternalInputs()) so that the following per-input
+     * lookups (HaveInputs(), GetCoinWithScript(),...) are served from memory.
+     */
+    void PrefetchInputs(const std::vector<CTransactionRef>& txns) const;
+
     //! Same as HaveInputs but with addition of limiting cache size
     //! If result is std::nullopt
     std::optional<bool> HaveInputsLimited(const CTransaction &tx, size_t maxCachedCoinsUsage) const;
@@ -644,6 +680,11 @@ protected:
     const ICoinsView* mView;
 };
 
+//! Return outpoints spent by the given transactions excluding the ones that
+//! spend outputs of transactions inside txns (as those can't be present in the
+//! UTXO set yet).
+std::vector<COutPoint> GetExternalInputs(const std::vector<CTransactionRef>& txns);
+
 //! Utility function to add all of a transaction's outputs to a cache.
 // When check is false, this assumes that overwrites are only possible for
 // coinbase transactions.
@@ -0,0 +1,187 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_COMPACT_SET_H
+#define MVC_COMPACT_SET_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/**
+ * Unordered set intended as a lower overhead replacement for
+ * std::unordered_set when most instances hold only a handful of small
+ * elements (such as mempool parent/child links).
+ *
+ * Elements are kept in a single flat vector, so an empty set allocates
+ * nothing and a small one makes a single allocation, instead of a bucket
+ * array plus a node per element. Small sets are searched linearly. Once a set
+ * grows beyond LINEAR_SEARCH_LIMIT elements a hash index from element to
+ * vector position is built so that lookups stay constant time, and it is
+ * dropped again if the set shrinks well back below that size.
+ *
+ * Erasing moves the last element into the erased position, so erasing
+ * invalidates iterators and doesn't preserve order.
+ */
+template <typename T, typename Hasher>
+class CompactSet
+{
+public:
+    static constexpr size_t LINEAR_SEARCH_LIMIT { 16 };
+
+    using value_type = T;
+    using const_iterator = typename std::vector<T>::const_iterator;
+    using iterator = const_iterator;
+    using index_type = std::unordered_map<T, size_t, Hasher>;
+
+    CompactSet() = default;
+    template <typename InputIt>
+    CompactSet(InputIt first, InputIt last)
+    {
+        for (; first != last; ++first)
+        {
+            insert(*first);
+        }
+    }
+
+    CompactSet(CompactSet&&) noexcept = default;
+    CompactSet& operator=(CompactSet&&) noexcept = default;
+    CompactSet(const CompactSet& other)
+        : items{other.items}
+        , index{other.index ? std::make_unique<index_type>(*other.index) : nullptr}
+    {}
+    CompactSet& operator=(const CompactSet& other)
+    {
+        if (this != &other)
+        {
+            items = other.items;
+            index = other.index ? std::make_unique<index_type>(*other.index) : nullptr;
+        }
+        return *this;
+    }
+
+    const_iterator begin() const { return items.begin(); }
+    const_iterator end() const { return items.end(); }
+    size_t size() const { return items.size(); }
+    bool empty() const { return items.empty(); }
+
+    // Number of elements storage is allocated for
+    size_t capacity() const { return items.capacity(); }
+
+    // Hash index, if we currently have one
+    const index_type* GetIndex() const { return index.get(); }
+
+    const_iterator find(const T& value) const
+    {
+        if (index)
+        {
+            auto it = index->find(value);
+            return it == index->end() ? items.end() : items.begin() + it->second;
+        }
+        return std::find(items.begin(), items.end(), value);
+    }
+
+    size_t count(const T& value) const { return find(value) != items.end(); }
+
+    std::pair<const_iterator, bool> insert(const T& value)
+    {
+        auto it = find(value);
+        if (it != items.end())
+        {
+            return {it, false};
+        }
+
+        items.push_back(value);
+        if (index)
+        {
+            index->emplace(value, items.size() - 1);
+        }
+        else if (items.size() > LINEAR_SEARCH_LIMIT)
+        {
+            BuildIndex();
+        }
+        return {items.end() - 1, true};
+    }
+
+    size_t erase(const T& value)
+    {
+        auto it = find(value);
+        if (it == items.end())
+        {
+            return 0;
+        }
+        erase(it);
+        return 1;
+    }
+
+    void erase(const_iterator it)
+    {
+        size_t pos = static_cast<size_t>(it - items.begin());
+        if (index)
+        {
+            index->erase(items[pos]);
+        }
+        if (pos != items.size() - 1)
+        {
+            items[pos] = std::move(items.back());
+            if (index)
+            {
+                (*index)[items[pos]] = pos;
+            }
+        }
+        items.pop_back();
+
+        if (items.empty())
+        {
+            clear();
+        }
+        else if (index && items.size() < LINEAR_SEARCH_LIMIT / 2)
+        {
+            index.reset();
+        }
+    }
+
+    void clear()
+    {
+        std::vector<T>{}.swap(items);
+        index.reset();
+    }
+
+    // Set equality, ignoring element order
+    template <typename Set>
+    bool ContainsSameAs(const Set& other) const
+    {
+        if (other.size() != items.size())
+        {
+            return false;
+        }
+        for (const T& value : other)
+        {
+            if (!count(value))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+private:
+    void BuildIndex()
+    {
+        index = std::make_unique<index_type>();
+        index->reserve(items.size());
+        for (size_t i = 0; i < items.size(); ++i)
+        {
+            index->emplace(items[i], i);
+        }
+    }
+
+    std::vector<T> items {};
+    std::unique_ptr<index_type> index {nullptr};
+};
+
+#endif // MVC_COMPACT_SET_H
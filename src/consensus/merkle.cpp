@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "merkle.h"
+#include "crypto/sha256.h"
 #include "hash.h"
 #include "utilstrencodings.h"
 
@@ -44,7 +45,7 @@
 */
 
 /* This implements a constant-space merkle root/path calculator, limited to 2^32
- * leaves. */
+ * leaves. It is used for branches; ComputeMerkleRoot() gives the same root. */
 static void MerkleComputation(const std::vector<uint256> &leaves,
                               uint256 *proot, bool *pmutated,
                               uint32_t branchpos,
@@ -144,10 +145,139 @@ static void MerkleComputation(const std::vector<uint256> &leaves,
     if (proot) *proot = h;
 }
 
-uint256 ComputeMerkleRoot(const std::vector<uint256> &leaves, bool *mutated) {
-    uint256 hash;
-    MerkleComputation(leaves, &hash, mutated, -1, nullptr);
-    return hash;
+void CIncrementalMerkleRoot::Add(const uint256 &leaf) {
+    uint256 h = leaf;
+    count++;
+    int level;
+    // Combine with each existing inner value that is now complete; see
+    // MerkleComputation() above.
+    for (level = 0; !(count & (((uint32_t)1) << level)); level++) {
+        mutated |= (inner[level] == h);
+        CHash256()
+            .Write(inner[level].begin(), 32)
+            .Write(h.begin(), 32)
+            .Finalize(h.begin());
+    }
+    inner[level] = h;
+}
+
+uint256 CIncrementalMerkleRoot::GetRoot(bool *pmutated) const {
+    if (count == 0) {
+        if (pmutated) *pmutated = false;
+        return uint256();
+    }
+    // Sweep over the rightmost branch of the tree exactly as
+    // MerkleComputation() does.
+    uint32_t n = count;
+    int level = 0;
+    while (!(n & (((uint32_t)1) << level))) {
+        level++;
+    }
+    uint256 h = inner[level];
+    while (n != (((uint32_t)1) << level)) {
+        CHash256()
+            .Write(h.begin(), 32)
+            .Write(h.begin(), 32)
+            .Finalize(h.begin());
+        n += (((uint32_t)1) << level);
+        level++;
+        while (!(n & (((uint32_t)1) << level))) {
+            CHash256()
+                .Write(inner[level].begin(), 32)
+                .Write(h.begin(), 32)
+                .Finalize(h.begin());
+            level++;
+        }
+    }
+    if (pmutated) *pmutated = mutated;
+    return h;
+}
+
+void CIncrementalCoinbaseMerkleBranch::Add(const uint256 &leaf) {
+    uint256 h = leaf;
+    count++;
+    int level;
+    for (level = 0; !(count & (((uint32_t)1) << level)); level++) {
+        if (count == (((uint32_t)1) << (level + 1))) {
+            // h is the right sibling of the subtree holding the coinbase,
+            // the last step to the new top of the tree
+            complete[level] = h;
+            h.SetNull();
+        } else {
+            CHash256()
+                .Write(inner[level].begin(), 32)
+                .Write(h.begin(), 32)
+                .Finalize(h.begin());
+        }
+    }
+    inner[level] = h;
+}
+
+std::vector<uint256> CIncrementalCoinbaseMerkleBranch::GetBranch() const {
+    std::vector<uint256> branch;
+    if (count < 2) {
+        return branch;
+    }
+    // Levels below top have their right sibling complete
+    int top = 0;
+    while ((((uint32_t)1) << (top + 1)) < count) {
+        branch.push_back(complete[top]);
+        top++;
+    }
+    if (count == (((uint32_t)1) << (top + 1))) {
+        branch.push_back(complete[top]);
+        return branch;
+    }
+    // The right sibling at level top holds leaves [2^top, count); reduce it
+    // the same way as the final sweep of MerkleComputation(), stopping before
+    // it would be combined with the subtree holding the coinbase.
+    uint32_t n = count;
+    int level = 0;
+    while (!(n & (((uint32_t)1) << level))) {
+        level++;
+    }
+    uint256 h = inner[level];
+    while (level < top) {
+        CHash256()
+            .Write(h.begin(), 32)
+            .Write(h.begin(), 32)
+            .Finalize(h.begin());
+        n += (((uint32_t)1) << level);
+        level++;
+        while (level < top && !(n & (((uint32_t)1) << level))) {
+            CHash256()
+                .Write(inner[level].begin(), 32)
+                .Write(h.begin(), 32)
+                .Finalize(h.begin());
+            level++;
+        }
+    }
+    branch.push_back(h);
+    return branch;
+}
+
+uint256 ComputeMerkleRoot(std::vector<uint256> hashes, bool *mutated) {
+    // Compute the tree level by level in place, so that all pairs of a level
+    // are hashed together by SHA256D64(). Mutation is detected the same way as
+    // in MerkleComputation(): two identical hashes combined into a parent.
+    bool mutation = false;
+    while (hashes.size() > 1) {
+        if (mutated) {
+            for (size_t pos = 0; pos + 1 < hashes.size(); pos += 2) {
+                if (hashes[pos] == hashes[pos + 1]) {
+                    mutation = true;
+                }
+            }
+        }
+        if (hashes.size() & 1) {
+            hashes.push_back(hashes.back());
+        }
+        SHA256D64(hashes[0].begin(), hashes[0].begin(), hashes.size() / 2);
+        hashes.resize(hashes.size() / 2);
+    }
+    if (mutated) *mutated = mutation;
+    if (hashes.empty()) return uint256();
+    return hashes[0];
 }
 
 std::vector<uint256> ComputeMerkleBranch(const std::vector<uint256> &leaves,
@@ -184,7 +314,7 @@ uint256 BlockMerkleRoot(const CBlock &block, bool *mutated) {
     for (size_t s = 0; s < block.vtx.size(); s++) {
         leaves[s] = block.vtx[s]->GetId();
     }
-    return ComputeMerkleRoot(leaves, mutated);
+    return ComputeMerkleRoot(std::move(leaves), mutated);
 }
 
 std::vector<uint256> BlockMerkleBranch(const CBlock &block, uint32_t position) {
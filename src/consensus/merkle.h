@@ -12,7 +12,7 @@
 #include "primitives/block.h"
 #include "uint256.h"
 
-uint256 ComputeMerkleRoot(const std::vector<uint256> &leaves,
+uint256 ComputeMerkleRoot(std::vector<uint256> hashes,
                           bool *mutated = nullptr);
 std::vector<uint256> ComputeMerkleBranch(const std::vector<uint256> &leaves,
                                          uint32_t position);
@@ -20,6 +20,61 @@ uint256 ComputeMerkleRootFromBranch(const uint256 &leaf,
                                     const std::vector<uint256> &branch,
                                     uint32_t position);
 
+/**
+ * Computes a Merkle root incrementally as leaves become available, giving
+ * exactly the same result (including mutation detection) as
+ * ComputeMerkleRoot() over the complete list. Limited to 2^32 leaves.
+ */
+class CIncrementalMerkleRoot {
+public:
+    void Add(const uint256 &leaf);
+
+    /**
+     * Get the root of the leaves added so far. *mutated is set to true if a
+     * duplicated subtree was found.
+     */
+    uint256 GetRoot(bool *mutated = nullptr) const;
+
+    uint32_t GetCount() const { return count; }
+
+private:
+    // Number of leaves added so far
+    uint32_t count {0};
+    // Eagerly computed subtree hashes indexed by level, as in
+    // ComputeMerkleRoot()
+    uint256 inner[32];
+    bool mutated {false};
+};
+
+/**
+ * Maintains the Merkle branch of the first leaf (the coinbase of a block) as
+ * the other leaves are appended, giving the same branch as
+ * ComputeMerkleBranch(leaves, 0). The branch doesn't depend on the first leaf,
+ * so its value is never needed. Adding a leaf takes amortised constant time
+ * and GetBranch() takes O(log n) hashes. Limited to 2^32 leaves.
+ */
+class CIncrementalCoinbaseMerkleBranch {
+public:
+    // Append the next leaf after the coinbase
+    void Add(const uint256 &leaf);
+
+    std::vector<uint256> GetBranch() const;
+
+    // Number of leaves including the coinbase
+    uint32_t GetCount() const { return count; }
+
+private:
+    // Number of leaves so far, starting with the coinbase
+    uint32_t count {1};
+    // Eagerly computed subtree hashes indexed by level, as in
+    // CIncrementalMerkleRoot; entries for subtrees that contain the coinbase
+    // are left null
+    uint256 inner[32];
+    // complete[level] is the hash of leaves [2^level, 2^(level+1)), which is
+    // the branch entry at that level once all of them have been added
+    uint256 complete[32];
+};
+
 /**
  * Compute the Merkle root of the transactions in a block.
  * *mutated is set to true if a duplicated subtree was found.
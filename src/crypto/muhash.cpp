@@ -0,0 +1,196 @@
+// Copyright (c) 2017-2020 The Bitcoin Core developers
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "crypto/muhash.h"
+
+#include "crypto/chacha20.h"
+#include "crypto/common.h"
+#include "crypto/sha256.h"
+
+#include <cstring>
+#include <limits>
+
+namespace {
+
+using limb_t = Num3072::limb_t;
+using double_limb_t = unsigned __int128;
+
+//! 2^3072 - MAX_PRIME_DIFF is the modulus
+constexpr limb_t MAX_PRIME_DIFF = 1103717;
+
+} // namespace
+
+Num3072::Num3072(const uint8_t (&data)[BYTE_SIZE]) {
+    for (int i = 0; i < LIMBS; ++i) {
+        limbs[i] = ReadLE64(data + 8 * i);
+    }
+}
+
+void Num3072::SetToOne() {
+    limbs[0] = 1;
+    for (int i = 1; i < LIMBS; ++i) {
+        limbs[i] = 0;
+    }
+}
+
+bool Num3072::IsOverflow() const {
+    if (limbs[0] <= std::numeric_limits<limb_t>::max() - MAX_PRIME_DIFF) {
+        return false;
+    }
+    for (int i = 1; i < LIMBS; ++i) {
+        if (limbs[i] != std::numeric_limits<limb_t>::max()) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Num3072::FullReduce() {
+    // Subtracting the modulus equals adding MAX_PRIME_DIFF and dropping the
+    // 2^3072 bit.
+    double_limb_t carry = MAX_PRIME_DIFF;
+    for (int i = 0; i < LIMBS; ++i) {
+        carry += limbs[i];
+        limbs[i] = static_cast<limb_t>(carry);
+        carry >>= LIMB_SIZE;
+    }
+}
+
+void Num3072::Reduce(const limb_t (&product)[2 * LIMBS]) {
+    // 2^3072 = MAX_PRIME_DIFF (mod 2^3072 - MAX_PRIME_DIFF) so the upper half
+    // is folded into the lower half after multiplying it by MAX_PRIME_DIFF.
+    double_limb_t carry = 0;
+    for (int i = 0; i < LIMBS; ++i) {
+        carry += static_cast<double_limb_t>(product[LIMBS + i]) * MAX_PRIME_DIFF;
+        carry += product[i];
+        limbs[i] = static_cast<limb_t>(carry);
+        carry >>= LIMB_SIZE;
+    }
+
+    // The remaining carry is small (below 2^22) so folding it once more can
+    // overflow 2^3072 at most once, and after that the value is small enough
+    // that the last fold can't overflow.
+    while (carry) {
+        carry *= MAX_PRIME_DIFF;
+        for (int i = 0; i < LIMBS; ++i) {
+            carry += limbs[i];
+            limbs[i] = static_cast<limb_t>(carry);
+            carry >>= LIMB_SIZE;
+        }
+    }
+}
+
+void Num3072::Multiply(const Num3072 &a) {
+    limb_t product[2 * LIMBS] = {};
+    for (int i = 0; i < LIMBS; ++i) {
+        double_limb_t carry = 0;
+        for (int j = 0; j < LIMBS; ++j) {
+            carry += static_cast<double_limb_t>(limbs[i]) * a.limbs[j];
+            carry += product[i + j];
+            product[i + j] = static_cast<limb_t>(carry);
+            carry >>= LIMB_SIZE;
+        }
+        product[i + LIMBS] = static_cast<limb_t>(carry);
+    }
+
+    Reduce(product);
+}
+
+Num3072 Num3072::GetInverse() const {
+    // Fermat's little theorem: a^-1 = a^(p - 2) (mod p), where
+    // p - 2 = 2^3072 - MAX_PRIME_DIFF - 2 has all bits set except for some of
+    // the lowest limb.
+    const limb_t lowestLimb = static_cast<limb_t>(0) - MAX_PRIME_DIFF - 2;
+
+    Num3072 result;
+    for (int i = LIMBS - 1; i >= 0; --i) {
+        const limb_t exponentLimb =
+            i == 0 ? lowestLimb : std::numeric_limits<limb_t>::max();
+        for (int bit = LIMB_SIZE - 1; bit >= 0; --bit) {
+            result.Multiply(result);
+            if ((exponentLimb >> bit) & 1) {
+                result.Multiply(*this);
+            }
+        }
+    }
+
+    return result;
+}
+
+void Num3072::Divide(const Num3072 &a) {
+    Multiply(a.GetInverse());
+}
+
+void Num3072::ToBytes(uint8_t (&out)[BYTE_SIZE]) const {
+    Num3072 reduced{*this};
+    if (reduced.IsOverflow()) {
+        reduced.FullReduce();
+    }
+    for (int i = 0; i < LIMBS; ++i) {
+        WriteLE64(out + 8 * i, reduced.limbs[i]);
+    }
+}
+
+Num3072 MuHash3072::ToNum3072(const uint8_t *data, size_t len) {
+    uint8_t key[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(data, len).Finalize(key);
+
+    uint8_t expanded[Num3072::BYTE_SIZE];
+    ChaCha20(key, sizeof(key)).Output(expanded, sizeof(expanded));
+
+    return Num3072{expanded};
+}
+
+MuHash3072 &MuHash3072::operator*=(const MuHash3072 &mul) {
+    numerator.Multiply(mul.numerator);
+    denominator.Multiply(mul.denominator);
+    return *this;
+}
+
+MuHash3072 &MuHash3072::operator/=(const MuHash3072 &div) {
+    numerator.Multiply(div.denominator);
+    denominator.Multiply(div.numerator);
+    return *this;
+}
+
+MuHash3072 &MuHash3072::Insert(const uint8_t *data, size_t len) {
+    numerator.Multiply(ToNum3072(data, len));
+    return *this;
+}
+
+MuHash3072 &MuHash3072::Remove(const uint8_t *data, size_t len) {
+    denominator.Multiply(ToNum3072(data, len));
+    return *this;
+}
+
+void MuHash3072::Finalize(uint8_t (&out)[32]) const {
+    Num3072 result{numerator};
+    result.Divide(denominator);
+
+    uint8_t data[Num3072::BYTE_SIZE];
+    result.ToBytes(data);
+    CSHA256().Write(data, sizeof(data)).Finalize(out);
+}
+
+void MuHash3072::ToBytes(uint8_t (&out)[SERIALIZED_SIZE]) const {
+    uint8_t (&num)[Num3072::BYTE_SIZE] =
+        *reinterpret_cast<uint8_t (*)[Num3072::BYTE_SIZE]>(out);
+    uint8_t (&den)[Num3072::BYTE_SIZE] =
+        *reinterpret_cast<uint8_t (*)[Num3072::BYTE_SIZE]>(out + Num3072::BYTE_SIZE);
+    numerator.ToBytes(num);
+    denominator.ToBytes(den);
+}
+
+MuHash3072 MuHash3072::FromBytes(const uint8_t (&data)[SERIALIZED_SIZE]) {
+    const uint8_t (&num)[Num3072::BYTE_SIZE] =
+        *reinterpret_cast<const uint8_t (*)[Num3072::BYTE_SIZE]>(data);
+    const uint8_t (&den)[Num3072::BYTE_SIZE] =
+        *reinterpret_cast<const uint8_t (*)[Num3072::BYTE_SIZE]>(data + Num3072::BYTE_SIZE);
+
+    MuHash3072 hash;
+    hash.numerator = Num3072{num};
+    hash.denominator = Num3072{den};
+    return hash;
+}
@@ -0,0 +1,93 @@
+// Copyright (c) 2017-2020 The Bitcoin Core developers
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_CRYPTO_MUHASH_H
+#define MVC_CRYPTO_MUHASH_H
+
+#include <cstdint>
+#include <cstdlib>
+
+/** Number modulo 2^3072 - 1103717 (largest 3072-bit safe prime). */
+class Num3072 {
+public:
+    static constexpr size_t BYTE_SIZE = 384;
+
+    using limb_t = uint64_t;
+    static constexpr int LIMBS = 48;
+    static constexpr int LIMB_SIZE = 64;
+
+    Num3072() { SetToOne(); }
+    explicit Num3072(const uint8_t (&data)[BYTE_SIZE]);
+
+    void SetToOne();
+    void Multiply(const Num3072 &a);
+    void Divide(const Num3072 &a);
+    Num3072 GetInverse() const;
+
+    //! Serialize fully reduced number (little endian)
+    void ToBytes(uint8_t (&out)[BYTE_SIZE]) const;
+
+private:
+    limb_t limbs[LIMBS];
+
+    //! Set to lo + hi * 2^3072 (mod 2^3072 - 1103717) for a 6144-bit product
+    void Reduce(const limb_t (&product)[2 * LIMBS]);
+    //! Whether the number is at least the modulus (only possible as long as
+    //! the number isn't fully reduced)
+    bool IsOverflow() const;
+    void FullReduce();
+};
+
+/**
+ * A class representing MuHash sets.
+ *
+ * MuHash is a hashing algorithm that supports adding set elements in any
+ * order but also deleting in any order. As a result, it can maintain a
+ * running sum for a set of data as a whole, and add/remove when data
+ * is added to or removed from it. A downside of MuHash is that computing
+ * an inverse is relatively expensive. This is solved by representing
+ * the running value as a fraction, and multiplying added elements into
+ * the numerator and removed elements into the denominator. Only when the
+ * final hash is desired, a single modular inverse and multiplication is
+ * needed to combine the two.
+ *
+ * Each set element is hashed to a 3072-bit number using SHA256 followed by
+ * ChaCha20 expansion, and the set hash is the product of all element numbers
+ * modulo 2^3072 - 1103717, hashed with SHA256.
+ */
+class MuHash3072 {
+public:
+    static constexpr size_t SERIALIZED_SIZE = 2 * Num3072::BYTE_SIZE;
+
+    //! Empty set
+    MuHash3072() = default;
+
+    //! Multiply (resulting in a hash for the union of the sets)
+    MuHash3072 &operator*=(const MuHash3072 &mul);
+
+    //! Divide (resulting in a hash for the difference of the sets)
+    MuHash3072 &operator/=(const MuHash3072 &div);
+
+    //! Insert a single element into the set
+    MuHash3072 &Insert(const uint8_t *data, size_t len);
+
+    //! Remove a single element from the set
+    MuHash3072 &Remove(const uint8_t *data, size_t len);
+
+    //! Finalize into a 32-byte hash
+    void Finalize(uint8_t (&out)[32]) const;
+
+    //! Numerator followed by denominator (used for persistence)
+    void ToBytes(uint8_t (&out)[SERIALIZED_SIZE]) const;
+    static MuHash3072 FromBytes(const uint8_t (&data)[SERIALIZED_SIZE]);
+
+private:
+    static Num3072 ToNum3072(const uint8_t *data, size_t len);
+
+    Num3072 numerator;
+    Num3072 denominator;
+};
+
+#endif // MVC_CRYPTO_MUHASH_H
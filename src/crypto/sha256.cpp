@@ -15,6 +15,18 @@
 namespace sha256_sse4 {
 void Transform(uint32_t *s, const unsigned char *chunk, size_t blocks);
 }
+#if defined(__clang__) || defined(__GNUC__)
+namespace sha256_shani {
+void Transform(uint32_t *s, const unsigned char *chunk, size_t blocks);
+}
+namespace sha256d64_sse41 {
+void Transform_4way(unsigned char *out, const unsigned char *in);
+}
+namespace sha256d64_avx2 {
+void Transform_8way(unsigned char *out, const unsigned char *in);
+}
+#define HAVE_SHA256_X86_KERNELS 1
+#endif
 #endif
 #endif
 
@@ -216,6 +228,36 @@ namespace sha256 {
 } // namespace sha256
 
 typedef void (*TransformType)(uint32_t *, const unsigned char *, size_t);
+typedef void (*TransformD64Type)(unsigned char *, const unsigned char *);
+
+/**
+ * Double SHA-256 of a single 64-byte input using the given transform. The
+ * padding block of the first hash is constant and the second hash fits in a
+ * single block.
+ */
+void TransformD64(TransformType tr, unsigned char *out,
+                  const unsigned char *in) {
+    static const unsigned char padding[64] = {
+        0x80, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+        0,    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2, 0};
+    uint32_t s[8];
+    sha256::Initialize(s);
+    tr(s, in, 1);
+    tr(s, padding, 1);
+
+    unsigned char buffer[64] = {0};
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(buffer + 4 * i, s[i]);
+    }
+    buffer[32] = 0x80;
+    buffer[62] = 1;
+    sha256::Initialize(s);
+    tr(s, buffer, 1);
+    for (int i = 0; i < 8; ++i) {
+        WriteBE32(out + 4 * i, s[i]);
+    }
+}
 
 bool SelfTest(TransformType tr) {
     static const unsigned char in1[65] = {0, 0x80};
@@ -252,12 +294,80 @@ bool SelfTest(TransformType tr) {
     return true;
 }
 
+#if defined(HAVE_SHA256_X86_KERNELS)
+/** Check a multi-lane double SHA-256 kernel against the plain transform. */
+bool SelfTestD64(TransformD64Type tr, size_t lanes) {
+    unsigned char in[64 * 8];
+    unsigned char out[32 * 8];
+    unsigned char expected[32];
+    for (size_t i = 0; i < sizeof(in); ++i) {
+        in[i] = static_cast<unsigned char>(i * 7 + 1);
+    }
+    tr(out, in);
+    for (size_t i = 0; i < lanes; ++i) {
+        TransformD64(sha256::Transform, expected, in + 64 * i);
+        if (memcmp(out + 32 * i, expected, sizeof(expected))) return false;
+    }
+    return true;
+}
+
+/** Is saving the AVX register state enabled by the OS? */
+bool AVXEnabled() {
+    uint32_t a, d;
+    __asm__("xgetbv" : "=a"(a), "=d"(d) : "c"(0));
+    return (a & 6) == 6;
+}
+#endif
+
 TransformType Transform = sha256::Transform;
+TransformD64Type TransformD64_4way = nullptr;
+TransformD64Type TransformD64_8way = nullptr;
 
 } // namespace
 
 std::string SHA256AutoDetect() {
-#if defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__))
+#if defined(HAVE_SHA256_X86_KERNELS)
+    uint32_t eax, ebx, ecx, edx;
+    bool haveSSE4 = false;
+    bool haveAVX = false;
+    bool haveAVX2 = false;
+    bool haveSHANI = false;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx)) {
+        haveSSE4 = (ecx >> 19) & 1;
+        // OSXSAVE and AVX
+        haveAVX = ((ecx >> 27) & 1) && ((ecx >> 28) & 1) && AVXEnabled();
+    }
+    if (__get_cpuid_max(0, nullptr) >= 7) {
+        __cpuid_count(7, 0, eax, ebx, ecx, edx);
+        haveAVX2 = haveAVX && ((ebx >> 5) & 1);
+        haveSHANI = haveSSE4 && ((ebx >> 29) & 1);
+    }
+
+    // With the SHA extensions a single hash is fast enough that the
+    // multi-lane kernels don't pay off
+    if (haveSHANI) {
+        Transform = sha256_shani::Transform;
+        assert(SelfTest(Transform));
+        return "shani";
+    }
+
+    std::string ret = "standard";
+    if (haveSSE4) {
+        Transform = sha256_sse4::Transform;
+        assert(SelfTest(Transform));
+        TransformD64_4way = sha256d64_sse41::Transform_4way;
+        assert(SelfTestD64(TransformD64_4way, 4));
+        ret = "sse4(1way),sse41(4way)";
+    }
+    if (haveAVX2) {
+        TransformD64_8way = sha256d64_avx2::Transform_8way;
+        assert(SelfTestD64(TransformD64_8way, 8));
+        ret += ",avx2(8way)";
+    }
+    if (haveSSE4) {
+        return ret;
+    }
+#elif defined(USE_ASM) && (defined(__x86_64__) || defined(__amd64__))
     uint32_t eax, ebx, ecx, edx;
     if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) && (ecx >> 19) & 1) {
         Transform = sha256_sse4::Transform;
@@ -326,3 +436,29 @@ CSHA256 &CSHA256::Reset() {
     sha256::Initialize(s);
     return *this;
 }
+
+void SHA256D64(unsigned char *output, const unsigned char *input,
+               size_t blocks) {
+    if (TransformD64_8way) {
+        while (blocks >= 8) {
+            TransformD64_8way(output, input);
+            output += 256;
+            input += 512;
+            blocks -= 8;
+        }
+    }
+    if (TransformD64_4way) {
+        while (blocks >= 4) {
+            TransformD64_4way(output, input);
+            output += 128;
+            input += 256;
+            blocks -= 4;
+        }
+    }
+    while (blocks) {
+        TransformD64(Transform, output, input);
+        output += 32;
+        input += 64;
+        --blocks;
+    }
+}
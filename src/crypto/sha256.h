@@ -31,4 +31,16 @@ public:
  */
 std::string SHA256AutoDetect();
 
+/**
+ * Compute multiple double-SHA256's of 64-byte blobs.
+ * output: pointer to a blocks*32 byte output buffer
+ * input:  pointer to a blocks*64 byte input buffer
+ * blocks: the number of hashes to compute
+ *
+ * output may be the same as input (as used for computing the next level of a
+ * merkle tree in place), but the buffers must not otherwise overlap.
+ */
+void SHA256D64(unsigned char *output, const unsigned char *input,
+               size_t blocks);
+
 #endif // MVC_CRYPTO_SHA256_H
@@ -0,0 +1,78 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// Double SHA-256 of eight 64-byte inputs at once, one per 32-bit AVX2 lane.
+// The code is compiled for AVX2 regardless of the build flags and must only
+// be called after checking that the CPU supports it (see SHA256AutoDetect()).
+
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__amd64__)
+#if defined(__clang__) || defined(__GNUC__)
+
+#include "crypto/common.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("avx2"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "crypto/sha256_lanes.h"
+
+namespace sha256d64_avx2 {
+namespace {
+
+struct Vector {
+    typedef __m256i Type;
+    static const int LANES = 8;
+
+    static inline Type Set(uint32_t x) { return _mm256_set1_epi32(x); }
+    static inline Type Add(Type x, Type y) { return _mm256_add_epi32(x, y); }
+    static inline Type Xor(Type x, Type y) { return _mm256_xor_si256(x, y); }
+    static inline Type Or(Type x, Type y) { return _mm256_or_si256(x, y); }
+    static inline Type And(Type x, Type y) { return _mm256_and_si256(x, y); }
+    template <int n> static inline Type ShR(Type x) {
+        return _mm256_srli_epi32(x, n);
+    }
+    template <int n> static inline Type ShL(Type x) {
+        return _mm256_slli_epi32(x, n);
+    }
+
+    static inline Type Load(const unsigned char *in, int word) {
+        return _mm256_set_epi32(
+            ReadBE32(in + 448 + 4 * word), ReadBE32(in + 384 + 4 * word),
+            ReadBE32(in + 320 + 4 * word), ReadBE32(in + 256 + 4 * word),
+            ReadBE32(in + 192 + 4 * word), ReadBE32(in + 128 + 4 * word),
+            ReadBE32(in + 64 + 4 * word), ReadBE32(in + 4 * word));
+    }
+    static inline void Store(unsigned char *out, int word, Type x) {
+        alignas(32) uint32_t lanes[LANES];
+        _mm256_store_si256(reinterpret_cast<Type *>(lanes), x);
+        for (int i = 0; i < LANES; ++i) {
+            WriteBE32(out + 32 * i + 4 * word, lanes[i]);
+        }
+    }
+};
+
+} // namespace
+
+void Transform_8way(unsigned char *out, const unsigned char *in) {
+    sha256_lanes::TransformD64<Vector>(out, in);
+}
+
+} // namespace sha256d64_avx2
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif
+#endif
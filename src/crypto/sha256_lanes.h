@@ -0,0 +1,164 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_CRYPTO_SHA256_LANES_H
+#define MVC_CRYPTO_SHA256_LANES_H
+
+#include <cstdint>
+
+/**
+ * Double SHA-256 of several independent 64-byte inputs at once, one input per
+ * 32-bit lane of a SIMD register.
+ *
+ * The kernels (sha256_sse41.cpp, sha256_avx2.cpp) instantiate TransformD64()
+ * with a vector type V providing:
+ *   Type, LANES                  - register type and number of 32-bit lanes
+ *   Set, Add, Xor, Or, And       - lane-wise operations
+ *   ShR<n>, ShL<n>               - lane-wise shifts
+ *   Load(in, word)               - big endian word `word` of every input
+ *                                  (input of lane i starts at in + 64 * i)
+ *   Store(out, word, x)          - write word `word` of every lane big endian
+ *                                  (output of lane i starts at out + 32 * i)
+ *
+ * The header must be included in the region where the instruction set of the
+ * kernel is enabled, so that the instantiations are compiled for it.
+ */
+namespace sha256_lanes {
+
+template <typename V> inline typename V::Type Add(typename V::Type a, typename V::Type b, typename V::Type c) {
+    return V::Add(V::Add(a, b), c);
+}
+template <typename V> inline typename V::Type Add(typename V::Type a, typename V::Type b, typename V::Type c, typename V::Type d) {
+    return V::Add(V::Add(a, b), V::Add(c, d));
+}
+template <typename V> inline typename V::Type Xor(typename V::Type a, typename V::Type b, typename V::Type c) {
+    return V::Xor(V::Xor(a, b), c);
+}
+template <typename V, int n> inline typename V::Type Rotr(typename V::Type x) {
+    return V::Or(V::template ShR<n>(x), V::template ShL<32 - n>(x));
+}
+
+template <typename V> inline typename V::Type Ch(typename V::Type x, typename V::Type y, typename V::Type z) {
+    return V::Xor(z, V::And(x, V::Xor(y, z)));
+}
+template <typename V> inline typename V::Type Maj(typename V::Type x, typename V::Type y, typename V::Type z) {
+    return V::Or(V::And(x, y), V::And(z, V::Or(x, y)));
+}
+template <typename V> inline typename V::Type Sigma0(typename V::Type x) {
+    return Xor<V>(Rotr<V, 2>(x), Rotr<V, 13>(x), Rotr<V, 22>(x));
+}
+template <typename V> inline typename V::Type Sigma1(typename V::Type x) {
+    return Xor<V>(Rotr<V, 6>(x), Rotr<V, 11>(x), Rotr<V, 25>(x));
+}
+template <typename V> inline typename V::Type sigma0(typename V::Type x) {
+    return Xor<V>(Rotr<V, 7>(x), Rotr<V, 18>(x), V::template ShR<3>(x));
+}
+template <typename V> inline typename V::Type sigma1(typename V::Type x) {
+    return Xor<V>(Rotr<V, 17>(x), Rotr<V, 19>(x), V::template ShR<10>(x));
+}
+
+static const uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1,
+    0x923f82a4, 0xab1c5ed5, 0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174, 0xe49b69c1, 0xefbe4786,
+    0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147,
+    0x06ca6351, 0x14292967, 0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85, 0xa2bfe8a1, 0xa81a664b,
+    0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a,
+    0x5b9cca4f, 0x682e6ff3, 0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+static const uint32_t INIT[8] = {0x6a09e667ul, 0xbb67ae85ul, 0x3c6ef372ul,
+                                 0xa54ff53aul, 0x510e527ful, 0x9b05688cul,
+                                 0x1f83d9abul, 0x5be0cd19ul};
+
+/** One round; kw is the round constant already added to the message word. */
+template <typename V>
+inline void Round(typename V::Type a, typename V::Type b, typename V::Type c,
+                  typename V::Type &d, typename V::Type e, typename V::Type f,
+                  typename V::Type g, typename V::Type &h, typename V::Type kw) {
+    typename V::Type t1 = Add<V>(h, Sigma1<V>(e), Ch<V>(e, f, g), kw);
+    typename V::Type t2 = V::Add(Sigma0<V>(a), Maj<V>(a, b, c));
+    d = V::Add(d, t1);
+    h = V::Add(t1, t2);
+}
+
+/** 64 rounds over state s with message schedule w (extended in place). */
+template <typename V>
+inline void Compress(typename V::Type *s, typename V::Type *w) {
+    typename V::Type a = s[0], b = s[1], c = s[2], d = s[3], e = s[4],
+                     f = s[5], g = s[6], h = s[7];
+    for (int i = 0; i < 64; i += 8) {
+        for (int j = i; j < i + 8; ++j) {
+            if (j >= 16) {
+                w[j & 15] = Add<V>(w[j & 15], sigma1<V>(w[(j - 2) & 15]),
+                                   w[(j - 7) & 15], sigma0<V>(w[(j - 15) & 15]));
+            }
+        }
+        Round<V>(a, b, c, d, e, f, g, h, V::Add(V::Set(K[i + 0]), w[(i + 0) & 15]));
+        Round<V>(h, a, b, c, d, e, f, g, V::Add(V::Set(K[i + 1]), w[(i + 1) & 15]));
+        Round<V>(g, h, a, b, c, d, e, f, V::Add(V::Set(K[i + 2]), w[(i + 2) & 15]));
+        Round<V>(f, g, h, a, b, c, d, e, V::Add(V::Set(K[i + 3]), w[(i + 3) & 15]));
+        Round<V>(e, f, g, h, a, b, c, d, V::Add(V::Set(K[i + 4]), w[(i + 4) & 15]));
+        Round<V>(d, e, f, g, h, a, b, c, V::Add(V::Set(K[i + 5]), w[(i + 5) & 15]));
+        Round<V>(c, d, e, f, g, h, a, b, V::Add(V::Set(K[i + 6]), w[(i + 6) & 15]));
+        Round<V>(b, c, d, e, f, g, h, a, V::Add(V::Set(K[i + 7]), w[(i + 7) & 15]));
+    }
+    s[0] = V::Add(s[0], a);
+    s[1] = V::Add(s[1], b);
+    s[2] = V::Add(s[2], c);
+    s[3] = V::Add(s[3], d);
+    s[4] = V::Add(s[4], e);
+    s[5] = V::Add(s[5], f);
+    s[6] = V::Add(s[6], g);
+    s[7] = V::Add(s[7], h);
+}
+
+/**
+ * Compute SHA256(SHA256(in_i)) for the V::LANES 64-byte inputs at in into the
+ * 32-byte outputs at out. All input is read before anything is written, so
+ * out may alias in.
+ */
+template <typename V>
+inline void TransformD64(unsigned char *out, const unsigned char *in) {
+    typename V::Type s[8];
+    typename V::Type w[16];
+
+    // First hash: the 64 byte input followed by a block of padding
+    for (int i = 0; i < 8; ++i) {
+        s[i] = V::Set(INIT[i]);
+    }
+    for (int i = 0; i < 16; ++i) {
+        w[i] = V::Load(in, i);
+    }
+    Compress<V>(s, w);
+    w[0] = V::Set(0x80000000ul);
+    for (int i = 1; i < 15; ++i) {
+        w[i] = V::Set(0);
+    }
+    w[15] = V::Set(0x200);
+    Compress<V>(s, w);
+
+    // Second hash: the 32 byte digest with its padding fits one block
+    for (int i = 0; i < 8; ++i) {
+        w[i] = s[i];
+        s[i] = V::Set(INIT[i]);
+    }
+    w[8] = V::Set(0x80000000ul);
+    for (int i = 9; i < 15; ++i) {
+        w[i] = V::Set(0);
+    }
+    w[15] = V::Set(0x100);
+    Compress<V>(s, w);
+
+    for (int i = 0; i < 8; ++i) {
+        V::Store(out, i, s[i]);
+    }
+}
+
+} // namespace sha256_lanes
+
+#endif // MVC_CRYPTO_SHA256_LANES_H
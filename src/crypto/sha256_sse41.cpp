@@ -0,0 +1,75 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+//
+// Double SHA-256 of four 64-byte inputs at once, one per 32-bit SSE lane.
+// The code is compiled for SSE4.1 regardless of the build flags and must only
+// be called after checking that the CPU supports it (see SHA256AutoDetect()).
+
+#include <cstdint>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__amd64__)
+#if defined(__clang__) || defined(__GNUC__)
+
+#include "crypto/common.h"
+
+#include <immintrin.h>
+
+#if defined(__clang__)
+#pragma clang attribute push(__attribute__((target("sse4.1"))), apply_to = function)
+#else
+#pragma GCC push_options
+#pragma GCC target("sse4.1")
+#endif
+
+#include "crypto/sha256_lanes.h"
+
+namespace sha256d64_sse41 {
+namespace {
+
+struct Vector {
+    typedef __m128i Type;
+    static const int LANES = 4;
+
+    static inline Type Set(uint32_t x) { return _mm_set1_epi32(x); }
+    static inline Type Add(Type x, Type y) { return _mm_add_epi32(x, y); }
+    static inline Type Xor(Type x, Type y) { return _mm_xor_si128(x, y); }
+    static inline Type Or(Type x, Type y) { return _mm_or_si128(x, y); }
+    static inline Type And(Type x, Type y) { return _mm_and_si128(x, y); }
+    template <int n> static inline Type ShR(Type x) {
+        return _mm_srli_epi32(x, n);
+    }
+    template <int n> static inline Type ShL(Type x) {
+        return _mm_slli_epi32(x, n);
+    }
+
+    static inline Type Load(const unsigned char *in, int word) {
+        return _mm_set_epi32(
+            ReadBE32(in + 192 + 4 * word), ReadBE32(in + 128 + 4 * word),
+            ReadBE32(in + 64 + 4 * word), ReadBE32(in + 4 * word));
+    }
+    static inline void Store(unsigned char *out, int word, Type x) {
+        WriteBE32(out + 4 * word, _mm_extract_epi32(x, 0));
+        WriteBE32(out + 32 + 4 * word, _mm_extract_epi32(x, 1));
+        WriteBE32(out + 64 + 4 * word, _mm_extract_epi32(x, 2));
+        WriteBE32(out + 96 + 4 * word, _mm_extract_epi32(x, 3));
+    }
+};
+
+} // namespace
+
+void Transform_4way(unsigned char *out, const unsigned char *in) {
+    sha256_lanes::TransformD64<Vector>(out, in);
+}
+
+} // namespace sha256d64_sse41
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#else
+#pragma GCC pop_options
+#endif
+
+#endif
+#endif
@@ -417,6 +417,22 @@ public:
         }
     }
 
+    /**
+     * for_each_live calls fn with every element that hasn't been marked for
+     * erasure, elements of the older epoch first, so that inserting them into
+     * another cache in the same order keeps their relative age.
+     *
+     * Must not be called concurrently with insert.
+     *
+     * @param fn callable taking a const Element&
+     */
+    template <typename Fn> void for_each_live(Fn fn) const {
+        for (bool recent : {false, true})
+            for (uint32_t i = 0; i < size; ++i)
+                if (epoch_flags[i] == recent && !collection_flags.bit_is_set(i))
+                    fn(table[i]);
+    }
+
     /**
      * contains iterates through the hash locations for a given element  and
      * checks to see if it is present.
@@ -207,6 +207,21 @@ void CDBIterator::Next() {
     piter->Next();
 }
 
+CDBSnapshot::CDBSnapshot(const CDBWrapper &_parent)
+    : parent(_parent), snapshot(_parent.pdb->GetSnapshot()),
+      readoptions(_parent.readoptions), iteroptions(_parent.iteroptions) {
+    readoptions.snapshot = snapshot;
+    iteroptions.snapshot = snapshot;
+}
+
+CDBSnapshot::~CDBSnapshot() {
+    parent.pdb->ReleaseSnapshot(snapshot);
+}
+
+CDBIterator *CDBSnapshot::NewIterator() const {
+    return new CDBIterator(parent, parent.pdb->NewIterator(iteroptions));
+}
+
 namespace dbwrapper_private {
 
 void HandleError(const leveldb::Status &status) {
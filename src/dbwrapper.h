@@ -326,6 +326,7 @@ public:
 class CDBWrapper {
     friend const std::vector<uint8_t> &
     dbwrapper_private::GetObfuscateKey(const CDBWrapper &w);
+    friend class CDBSnapshot;
 
 private:
     //! custom environment this database is using (may be nullptr in case of
@@ -512,4 +513,56 @@ public:
     }
 };
 
+/**
+ * Consistent read-only view of database content at the time of snapshot
+ * creation - later writes are not visible through it.
+ *
+ * Iterators created from the same snapshot see the same data so a snapshot can
+ * be shared between threads that iterate over disjoint key ranges in parallel.
+ * Snapshot must outlive the iterators created from it.
+ */
+class CDBSnapshot {
+public:
+    explicit CDBSnapshot(const CDBWrapper &_parent);
+    ~CDBSnapshot();
+
+    CDBSnapshot(const CDBSnapshot&) = delete;
+    CDBSnapshot& operator=(const CDBSnapshot&) = delete;
+    CDBSnapshot(CDBSnapshot&&) = delete;
+    CDBSnapshot& operator=(CDBSnapshot&&) = delete;
+
+    template <typename K, typename V>
+    bool Read(const K &key, V &value) const {
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        ssKey.reserve(DBWRAPPER_PREALLOC_KEY_SIZE);
+        ssKey << key;
+        leveldb::Slice slKey(ssKey.data(), ssKey.size());
+
+        std::string strValue;
+        leveldb::Status status = parent.pdb->Get(readoptions, slKey, &strValue);
+        if (!status.ok()) {
+            if (status.IsNotFound()) return false;
+            LogPrintf("LevelDB read failure: %s\n", status.ToString());
+            dbwrapper_private::HandleError(status);
+        }
+        try {
+            dbwrapper_private::CDataStreamInput ssValue(strValue, parent.obfuscate_key);
+            ssValue >> value;
+        } catch (const std::exception &) {
+            return false;
+        }
+        return true;
+    }
+
+    CDBIterator *NewIterator() const;
+
+private:
+    const CDBWrapper &parent;
+    const leveldb::Snapshot *snapshot;
+
+    //! options of the parent database bound to the snapshot
+    leveldb::ReadOptions readoptions;
+    leveldb::ReadOptions iteroptions;
+};
+
 #endif // MVC_DBWRAPPER_H
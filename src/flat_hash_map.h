@@ -0,0 +1,409 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_FLAT_HASH_MAP_H
+#define MVC_FLAT_HASH_MAP_H
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+/**
+ * Open addressing hash map intended as a lower overhead replacement for
+ * std::unordered_map in large caches (CCoinsMap).
+ *
+ * Lookup table:
+ * Linear probing over two flat arrays - one control byte per slot (empty,
+ * deleted or 7 bits of the key hash) and one value pointer per slot. Probing
+ * compares control bytes first so keys are only dereferenced on a likely
+ * match. Capacity is a power of two and the table is rehashed once used plus
+ * deleted slots exceed 7/8 of it.
+ *
+ * Value storage:
+ * Values are constructed in place inside slabs of SLAB_SIZE elements that are
+ * never moved, so unlike with a plain open addressing table references and
+ * pointers to values remain valid until the value is erased (same guarantee as
+ * std::unordered_map). This is required by CoinsStore as non-owning coins
+ * point to the CTxOut data of coins stored in the parent cache. Freed value
+ * slots are reused through a free list.
+ *
+ * Erase only marks the slot as deleted so iterators to other elements stay
+ * valid - this allows the "erase while iterating" pattern:
+ *     auto itOld = it++;
+ *     map.erase(itOld);
+ * Insertion may rehash the lookup table and invalidates iterators (but not
+ * references to values).
+ */
+template <typename Key, typename T, typename Hash>
+class FlatHashMap
+{
+public:
+    using key_type = Key;
+    using mapped_type = T;
+    using value_type = std::pair<const Key, T>;
+    using size_type = size_t;
+    using hasher = Hash;
+
+    //! Number of values allocated at once
+    static constexpr size_t SLAB_SIZE = 1024;
+
+private:
+    static constexpr uint8_t EMPTY = 0x80;
+    static constexpr uint8_t DELETED = 0xFE;
+    static constexpr size_t MIN_CAPACITY = 16;
+
+    union Storage
+    {
+        Storage() {}
+        ~Storage() {}
+
+        value_type value;
+        Storage* nextFree;
+    };
+
+    template <typename Map, typename Value>
+    class IteratorImpl
+    {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = typename FlatHashMap::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = Value*;
+        using reference = Value&;
+
+        IteratorImpl() = default;
+
+        // Allow conversion from iterator to const_iterator
+        template <typename OtherMap, typename OtherValue>
+        IteratorImpl(const IteratorImpl<OtherMap, OtherValue>& other)
+            : mMap{other.mMap}
+            , mIndex{other.mIndex}
+        {}
+
+        reference operator*() const { return *mMap->mSlots[mIndex]; }
+        pointer operator->() const { return mMap->mSlots[mIndex]; }
+
+        IteratorImpl& operator++()
+        {
+            mIndex = mMap->NextFull(mIndex + 1);
+            return *this;
+        }
+
+        IteratorImpl operator++(int)
+        {
+            IteratorImpl old{*this};
+            ++*this;
+            return old;
+        }
+
+        friend bool operator==(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return a.mIndex == b.mIndex;
+        }
+        friend bool operator!=(const IteratorImpl& a, const IteratorImpl& b)
+        {
+            return a.mIndex != b.mIndex;
+        }
+
+    private:
+        IteratorImpl(Map* map, size_t index) : mMap{map}, mIndex{index} {}
+
+        Map* mMap{nullptr};
+        size_t mIndex{0};
+
+        friend class FlatHashMap;
+    };
+
+public:
+    using iterator = IteratorImpl<FlatHashMap, value_type>;
+    using const_iterator = IteratorImpl<const FlatHashMap, const value_type>;
+
+    FlatHashMap() = default;
+    ~FlatHashMap() { clear(); }
+
+    FlatHashMap(const FlatHashMap&) = delete;
+    FlatHashMap& operator=(const FlatHashMap&) = delete;
+
+    FlatHashMap(FlatHashMap&& other) noexcept { swap(other); }
+    FlatHashMap& operator=(FlatHashMap&& other) noexcept
+    {
+        if (this != &other)
+        {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
+    void swap(FlatHashMap& other) noexcept
+    {
+        std::swap(mCtrl, other.mCtrl);
+        std::swap(mSlots, other.mSlots);
+        std::swap(mSize, other.mSize);
+        std::swap(mDeleted, other.mDeleted);
+        std::swap(mSlabs, other.mSlabs);
+        std::swap(mUsedInLastSlab, other.mUsedInLastSlab);
+        std::swap(mFreeList, other.mFreeList);
+        std::swap(mHasher, other.mHasher);
+    }
+
+    bool empty() const { return mSize == 0; }
+    size_type size() const { return mSize; }
+    //! Number of slots in lookup table
+    size_type bucket_count() const { return mCtrl.size(); }
+    //! Number of allocated value slabs
+    size_type slab_count() const { return mSlabs.size(); }
+
+    iterator begin() { return {this, NextFull(0)}; }
+    iterator end() { return {this, mCtrl.size()}; }
+    const_iterator begin() const { return {this, NextFull(0)}; }
+    const_iterator end() const { return {this, mCtrl.size()}; }
+
+    iterator find(const Key& key) { return {this, Find(key)}; }
+    const_iterator find(const Key& key) const { return {this, Find(key)}; }
+    size_type count(const Key& key) const { return Find(key) != mCtrl.size(); }
+
+    template <typename KeyTuple, typename ArgsTuple>
+    std::pair<iterator, bool> emplace(
+        std::piecewise_construct_t,
+        KeyTuple&& keyArgs,
+        ArgsTuple&& valueArgs)
+    {
+        const Key& key = std::get<0>(keyArgs);
+        if (auto index = Find(key); index != mCtrl.size())
+        {
+            return {{this, index}, false};
+        }
+        PrepareInsert();
+
+        Storage* storage = AllocateStorage();
+        try
+        {
+            new (&storage->value) value_type(
+                std::piecewise_construct,
+                std::forward_as_tuple(key),
+                std::forward<ArgsTuple>(valueArgs));
+        }
+        catch (...)
+        {
+            ReleaseStorage(storage);
+            throw;
+        }
+
+        return {{this, Insert(key, &storage->value)}, true};
+    }
+
+    T& operator[](const Key& key)
+    {
+        return emplace(std::piecewise_construct, std::forward_as_tuple(key), std::tuple<>()).first->second;
+    }
+
+    iterator erase(const_iterator it)
+    {
+        assert(it.mMap == this && it.mIndex < mCtrl.size() && IsFull(mCtrl[it.mIndex]));
+
+        value_type* value = mSlots[it.mIndex];
+        value->~value_type();
+        ReleaseStorage(reinterpret_cast<Storage*>(value));
+
+        mCtrl[it.mIndex] = DELETED;
+        mSlots[it.mIndex] = nullptr;
+        --mSize;
+        ++mDeleted;
+
+        return {this, NextFull(it.mIndex + 1)};
+    }
+
+    size_type erase(const Key& key)
+    {
+        if (auto index = Find(key); index != mCtrl.size())
+        {
+            erase(const_iterator{this, index});
+            return 1;
+        }
+        return 0;
+    }
+
+    //! Destroy all values and release all memory
+    void clear()
+    {
+        for (size_t i = 0; i < mCtrl.size(); ++i)
+        {
+            if (IsFull(mCtrl[i]))
+            {
+                mSlots[i]->~value_type();
+            }
+        }
+
+        mCtrl = decltype(mCtrl){};
+        mSlots = decltype(mSlots){};
+        mSlabs = decltype(mSlabs){};
+        mSize = 0;
+        mDeleted = 0;
+        mUsedInLastSlab = SLAB_SIZE;
+        mFreeList = nullptr;
+    }
+
+    //! Make room for at least count elements without rehashing
+    void reserve(size_type count)
+    {
+        size_t capacity = MIN_CAPACITY;
+        while (MaxLoad(capacity) < count)
+        {
+            capacity <<= 1;
+        }
+
+        if (capacity > mCtrl.size())
+        {
+            Rehash(capacity);
+        }
+    }
+
+private:
+    static bool IsFull(uint8_t ctrl) { return !(ctrl & EMPTY); }
+    static size_t MaxLoad(size_t capacity) { return capacity - capacity / 8; }
+    static uint8_t H2(size_t hash) { return hash & 0x7F; }
+    static size_t H1(size_t hash) { return hash >> 7; }
+
+    size_t NextFull(size_t index) const
+    {
+        while (index < mCtrl.size() && !IsFull(mCtrl[index]))
+        {
+            ++index;
+        }
+        return index;
+    }
+
+    //! Return index of the key or mCtrl.size() if key is not present
+    size_t Find(const Key& key) const
+    {
+        if (mCtrl.empty())
+        {
+            return 0;
+        }
+
+        const size_t hash = mHasher(key);
+        const size_t mask = mCtrl.size() - 1;
+        const uint8_t h2 = H2(hash);
+        for (size_t index = H1(hash) & mask;; index = (index + 1) & mask)
+        {
+            const uint8_t ctrl = mCtrl[index];
+            if (ctrl == EMPTY)
+            {
+                return mCtrl.size();
+            }
+            if (ctrl == h2 && mSlots[index]->first == key)
+            {
+                return index;
+            }
+        }
+    }
+
+    //! Make sure that there is room for one more element
+    void PrepareInsert()
+    {
+        if (mSize + mDeleted + 1 > MaxLoad(mCtrl.size()))
+        {
+            // Grow if the table is getting full of live elements otherwise
+            // only purge the deleted slots.
+            size_t capacity = std::max(mCtrl.size(), MIN_CAPACITY);
+            if ((mSize + 1) * 2 > MaxLoad(capacity))
+            {
+                capacity <<= 1;
+            }
+            Rehash(capacity);
+        }
+    }
+
+    //! Store value for a key that is not present in the table
+    size_t Insert(const Key& key, value_type* value)
+    {
+        const size_t hash = mHasher(key);
+        const size_t index = FindInsertSlot(hash);
+        if (mCtrl[index] == DELETED)
+        {
+            --mDeleted;
+        }
+        mCtrl[index] = H2(hash);
+        mSlots[index] = value;
+        ++mSize;
+
+        return index;
+    }
+
+    size_t FindInsertSlot(size_t hash) const
+    {
+        const size_t mask = mCtrl.size() - 1;
+        size_t index = H1(hash) & mask;
+        while (IsFull(mCtrl[index]))
+        {
+            index = (index + 1) & mask;
+        }
+        return index;
+    }
+
+    void Rehash(size_t capacity)
+    {
+        std::vector<uint8_t> ctrl(capacity, EMPTY);
+        std::vector<value_type*> slots(capacity, nullptr);
+        std::swap(ctrl, mCtrl);
+        std::swap(slots, mSlots);
+
+        for (size_t i = 0; i < ctrl.size(); ++i)
+        {
+            if (IsFull(ctrl[i]))
+            {
+                const size_t hash = mHasher(slots[i]->first);
+                const size_t index = FindInsertSlot(hash);
+                mCtrl[index] = H2(hash);
+                mSlots[index] = slots[i];
+            }
+        }
+
+        mDeleted = 0;
+    }
+
+    Storage* AllocateStorage()
+    {
+        if (mFreeList)
+        {
+            Storage* storage = mFreeList;
+            mFreeList = storage->nextFree;
+            return storage;
+        }
+
+        if (mUsedInLastSlab == SLAB_SIZE)
+        {
+            mSlabs.emplace_back(new Storage[SLAB_SIZE]);
+            mUsedInLastSlab = 0;
+        }
+
+        return &mSlabs.back()[mUsedInLastSlab++];
+    }
+
+    void ReleaseStorage(Storage* storage)
+    {
+        storage->nextFree = mFreeList;
+        mFreeList = storage;
+    }
+
+    std::vector<uint8_t> mCtrl;
+    std::vector<value_type*> mSlots;
+    size_t mSize{0};
+    size_t mDeleted{0};
+
+    std::vector<std::unique_ptr<Storage[]>> mSlabs;
+    size_t mUsedInLastSlab{SLAB_SIZE};
+    Storage* mFreeList{nullptr};
+
+    Hash mHasher;
+};
+
+#endif // MVC_FLAT_HASH_MAP_H
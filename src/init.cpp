@@ -11,6 +11,7 @@
 #include "init.h"
 #include "addrman.h"
 #include "amount.h"
+#include "block_file_access.h"
 #include "block_index_store.h"
 #include "block_index_store_loader.h"
 #include "chain.h"
@@ -24,7 +25,9 @@
 #include "httprpc.h"
 #include "httpserver.h"
 #include "invalid_txn_publisher.h"
+#include "io_uring_ring.h"
 #include "key.h"
+#include "mempooltxdb.h"
 #include "mining/journaling_block_assembler.h"
 #include "net/net.h"
 #include "net/net_processing.h"
@@ -201,6 +204,11 @@ void Shutdown() {
         gArgs.GetArg("-persistmempool", DEFAULT_PERSIST_MEMPOOL)) {
         mempool.DumpMempool();
     }
+    if (fDumpMempoolLater &&
+        gArgs.GetBoolArg("-persistsigcache", DEFAULT_PERSIST_SIG_CACHE)) {
+        DumpSignatureCache();
+        DumpScriptExecutionCache();
+    }
 
     {
         LOCK(cs_main);
@@ -314,12 +322,19 @@ std::string HelpMessage(HelpMessageMode mode, const Config& config) {
     strUsage += HelpMessageOpt("-blocknotify=<cmd>",
                                _("Execute command when the best block changes "
                                  "(%s in cmd is replaced by block hash)"));
-    if (showDebug)
+    if (showDebug) {
+        strUsage += HelpMessageOpt(
+            "-blockfilemmap",
+            strprintf("Serve blocks to peers and REST/RPC clients directly "
+                      "from memory mapped block files instead of copying "
+                      "them through read buffers (default: %d)",
+                      DEFAULT_BLOCK_FILE_MMAP));
         strUsage += HelpMessageOpt(
             "-blocksonly",
             strprintf(
                 _("Whether to operate in a blocks only mode (default: %d)"),
                 DEFAULT_BLOCKSONLY));
+    }
     strUsage += HelpMessageOpt(
         "-assumevalid=<hex>",
         strprintf(
@@ -345,6 +360,12 @@ std::string HelpMessage(HelpMessageMode mode, const Config& config) {
             strprintf(
                 "Maximum database write batch size in bytes (default: %u). The value may be given in bytes or with unit (B, kB, MB, GB).",
                 nDefaultDbBatchSize));
+        strUsage += HelpMessageOpt(
+            "-dbincrementalflush=<n>",
+            strprintf(
+                "Write modified coins to database in the background once in-memory UTXO set exceeds <n> percent of its size limit, "
+                "so that the full flush has less to write (0 to 100, 0 = disabled, default: %d)",
+                nDefaultDbIncrementalFlush));
     }
     strUsage += HelpMessageOpt(
         "-dbcache=<n>",
@@ -365,6 +386,16 @@ std::string HelpMessage(HelpMessageMode mode, const Config& config) {
                   "(default: %u).",
                   defaultChainParams->GetConsensus().genesisHeight));
 
+#ifdef USE_IO_URING
+    if (showDebug) {
+        strUsage += HelpMessageOpt(
+            "-iouring",
+            strprintf("Use io_uring for asynchronous block file reads "
+                      "(default: %d)",
+                      DEFAULT_IO_URING));
+    }
+#endif
+
     strUsage += HelpMessageOpt(
         "-loadblock=<file>",
         _("Imports blocks from external blk000??.dat file on startup"));
@@ -381,9 +412,13 @@ std::string HelpMessage(HelpMessageMode mode, const Config& config) {
         strUsage += HelpMessageOpt("-maxmempoolsizedisk=<n>",
                                    strprintf(_("Experimental: Additional amount of mempool transactions to keep stored on disk "
                                                "below <n> megabytes (default: -maxmempool x %u). Actual disk usage will "
-                                               "be larger due to leveldb compaction strategy. "
+                                               "be larger as space of removed transactions is reclaimed a segment at a time. "
                                                "The value may be given in megabytes or with unit (B, kB, MB, GB)."),
                                              DEFAULT_MAX_MEMPOOL_SIZE_DISK_FACTOR));
+        strUsage += HelpMessageOpt("-mempooltxdbcompression=<none|lz4|zstd>",
+                                   strprintf(_("Compression of mempool transactions stored on disk; lz4 and zstd "
+                                               "are only available if enabled at build time (default: %s)"),
+                                             DEFAULT_MEMPOOL_TXDB_COMPRESSION));
     }
     strUsage += HelpMessageOpt("-mempoolmaxpercentcpfp=<n>",
                                strprintf(_("Percentage of total mempool size (ram+disk) to allow for "
@@ -425,6 +460,22 @@ std::string HelpMessage(HelpMessageMode mode, const Config& config) {
                        strprintf(_("Whether to save the mempool on shutdown "
                                    "and load on restart (default: %u)"),
                                  DEFAULT_PERSIST_MEMPOOL));
+    strUsage +=
+        HelpMessageOpt("-persistmempooltrusted",
+                       strprintf(_("Record which persisted mempool transactions "
+                                   "had their scripts verified and skip verifying "
+                                   "them again on restart if the chain tip and "
+                                   "script flags are unchanged. Only the integrity "
+                                   "of the mempool file is checked, so only enable "
+                                   "this if the data directory is trusted "
+                                   "(default: %u)"),
+                                 DEFAULT_PERSIST_MEMPOOL_TRUSTED));
+    strUsage +=
+        HelpMessageOpt("-persistsigcache",
+                       strprintf(_("Whether to save the signature and script "
+                                   "execution caches on shutdown and load them "
+                                   "on restart (default: %u)"),
+                                 DEFAULT_PERSIST_SIG_CACHE));
     strUsage += HelpMessageOpt(
         "-threadsperblock=<n>",
         strprintf(_("Set the number of script verification threads used when "
@@ -633,6 +684,12 @@ std::string HelpMessage(HelpMessageMode mode, const Config& config) {
             strprintf(_("(available policies: %s, default: %s)"),
         StreamPolicyFactory{}.GetAllPolicyNamesStr(), DEFAULT_STREAM_POLICY_LIST));
 
+    strUsage += HelpMessageOpt(
+        "-networkworkers=<n>",
+        strprintf(_("Number of threads servicing peer sockets when epoll is "
+                    "used for socket events (0 = one per 4 cores up to %d, "
+                    "maximum: %d, default: %d)"),
+                  MAX_AUTO_NETWORK_WORKERS, MAX_NETWORK_WORKERS, DEFAULT_NETWORK_WORKERS));
     strUsage += HelpMessageOpt(
         "-onlynet=<net>",
         _("Only connect to nodes in network <net> (ipv4 or ipv6)"));
@@ -670,6 +727,19 @@ std::string HelpMessage(HelpMessageMode mode, const Config& config) {
     strUsage += HelpMessageOpt(
         "-seednode=<ip>",
         _("Connect to a node to retrieve peer addresses, and disconnect"));
+    strUsage += HelpMessageOpt(
+        "-socketevents=<mode>",
+        strprintf(_("Mechanism used to wait for network socket events, <mode> "
+                    "can be epoll (Linux only, falls back to select if not "
+                    "available) or select (default: %s)"),
+                  DEFAULT_SOCKET_EVENTS));
+    strUsage += HelpMessageOpt(
+        "-streamblockparsing",
+        strprintf(_("Decode block messages while they are still being received "
+                    "so that transaction hashing, merkle root calculation and "
+                    "prefetching of spent coins overlap with the download. Uses "
+                    "extra memory for blocks being received (default: %d)"),
+                  DEFAULT_STREAM_BLOCK_PARSING));
     strUsage += HelpMessageOpt(
         "-timeout=<n>", strprintf(_("Specify connection timeout in "
                                     "milliseconds (minimum: 1, default: %d)"),
@@ -2117,6 +2187,13 @@ bool AppInitParameterInteraction(ConfigInit &config) {
     {
         return InitError(err);
     }
+    if (const auto compression = CMempoolTxStore::ParseCompression(
+            gArgs.GetArg("-mempooltxdbcompression", DEFAULT_MEMPOOL_TXDB_COMPRESSION));
+        !compression || !CMempoolTxStore::IsCompressionSupported(compression.value()))
+    {
+        return InitError(strprintf(_("Unsupported mempool transaction database compression: %s"),
+                                   gArgs.GetArg("-mempooltxdbcompression", DEFAULT_MEMPOOL_TXDB_COMPRESSION)));
+    }
     if (std::string err; !config.SetMempoolMaxPercentCPFP(
         gArgs.GetArg("-mempoolmaxpercentcpfp", DEFAULT_MEMPOOL_MAX_PERCENT_CPFP), &err))
     {
@@ -2963,6 +3040,18 @@ static size_t GetMaxNumberOfMerkleTreeThreads()
     return numberOfMerkleTreeCalculationThreads;
 }
 
+static size_t GetMaxNumberOfCoinsDBThreads()
+{
+    // Use 1/4 of all threads for bulk loading and writing of coins in coins
+    // database
+    size_t numberOfCoinsDBThreads = static_cast<size_t>(std::thread::hardware_concurrency() * 0.25);
+    if (!numberOfCoinsDBThreads)
+    {
+        numberOfCoinsDBThreads = 1;
+    }
+    return numberOfCoinsDBThreads;
+}
+
 bool AppInitMain(ConfigInit &config, boost::thread_group &threadGroup,
                  CScheduler &scheduler, const task::CCancellationToken& shutdownToken) {
     const CChainParams &chainparams = config.GetChainParams();
@@ -3011,6 +3100,10 @@ bool AppInitMain(ConfigInit &config, boost::thread_group &threadGroup,
 
     InitSignatureCache();
     InitScriptExecutionCache();
+    if (gArgs.GetBoolArg("-persistsigcache", DEFAULT_PERSIST_SIG_CACHE)) {
+        LoadSignatureCache();
+        LoadScriptExecutionCache();
+    }
 
     LogPrintf("Using %u threads for script verification\n",
               config.GetPerBlockScriptValidatorThreadsCount());
@@ -3247,6 +3340,11 @@ bool AppInitMain(ConfigInit &config, boost::thread_group &threadGroup,
     nTotalCache -= nMerkleTreeIndexDBCache;
     // the rest goes to in-memory cache
     nCoinCacheUsage = nTotalCache;
+    nCoinCacheIncrementalFlushPercent =
+        std::clamp<int>(
+            gArgs.GetArg("-dbincrementalflush", nDefaultDbIncrementalFlush),
+            0,
+            100);
     MempoolSizeLimits limits = MempoolSizeLimits::FromConfig();
     LogPrintf("Cache configuration:\n");
     LogPrintf("* Using %.1fMiB for block index database\n",
@@ -3283,6 +3381,7 @@ bool AppInitMain(ConfigInit &config, boost::thread_group &threadGroup,
                         config.GetMaxCoinsProviderCacheSize(),
                         nCoinDBCache,
                         CDBWrapper::MaxFiles{config.GetMaxCoinsDbOpenFiles()},
+                        GetMaxNumberOfCoinsDBThreads(),
                         false,
                         fReindex || fReindexChainState);
 
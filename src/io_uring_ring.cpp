@@ -0,0 +1,419 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifdef USE_IO_URING
+
+#include "io_uring_ring.h"
+
+#include "util.h"
+
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace
+{
+    int io_uring_setup(unsigned entries, io_uring_params& params)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    }
+
+    int io_uring_enter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags)
+    {
+        return
+            static_cast<int>(
+                syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    int io_uring_register(int fd, unsigned opcode, void* arg, unsigned nrArgs)
+    {
+        return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, nrArgs));
+    }
+
+    void* MapRing(int fd, size_t size, off_t offset)
+    {
+        void* ring =
+            mmap(
+                nullptr,
+                size,
+                PROT_READ | PROT_WRITE,
+                MAP_SHARED | MAP_POPULATE,
+                fd,
+                offset);
+
+        return ring == MAP_FAILED ? nullptr : ring;
+    }
+
+    template<typename T>
+    T* RingField(void* ring, uint32_t offset)
+    {
+        return reinterpret_cast<T*>(static_cast<uint8_t*>(ring) + offset);
+    }
+
+    bool IsOpSupported(int fd, uint8_t opcode)
+    {
+        // io_uring_probe ends with a flexible array of operations
+        constexpr size_t opsCount = 256;
+        std::vector<uint8_t> buffer(
+            sizeof(io_uring_probe) + opsCount * sizeof(io_uring_probe_op));
+        auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+
+        if (io_uring_register(fd, IORING_REGISTER_PROBE, probe, opsCount) != 0)
+        {
+            // Probing was added in the same kernel version as IORING_OP_READ
+            return false;
+        }
+
+        return
+            opcode <= probe->last_op &&
+            (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+    }
+}
+
+CIoUring* CIoUring::Get()
+{
+    static std::unique_ptr<CIoUring> ring =
+        []() -> std::unique_ptr<CIoUring>
+        {
+            if (!gArgs.GetBoolArg("-iouring", DEFAULT_IO_URING))
+            {
+                return nullptr;
+            }
+
+            std::unique_ptr<CIoUring> ring{ new CIoUring };
+            if (!ring->Init())
+            {
+                LogPrintf("io_uring is not available, using fallback file reads\n");
+                return nullptr;
+            }
+
+            return ring;
+        }();
+
+    return ring.get();
+}
+
+bool CIoUring::Init()
+{
+    io_uring_params params{};
+    mFd = io_uring_setup(QUEUE_DEPTH, params);
+    if (mFd < 0)
+    {
+        return false;
+    }
+
+    if (!IsOpSupported(mFd, IORING_OP_READ) ||
+        !IsOpSupported(mFd, IORING_OP_ASYNC_CANCEL))
+    {
+        return false;
+    }
+
+    mSqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    mCqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    mSqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    mSqRing = MapRing(mFd, mSqRingSize, IORING_OFF_SQ_RING);
+    mCqRing = MapRing(mFd, mCqRingSize, IORING_OFF_CQ_RING);
+    mSqes = static_cast<io_uring_sqe*>(MapRing(mFd, mSqesSize, IORING_OFF_SQES));
+    if (!mSqRing || !mCqRing || !mSqes)
+    {
+        return false;
+    }
+
+    mSqHead = RingField<std::atomic<uint32_t>>(mSqRing, params.sq_off.head);
+    mSqTail = RingField<std::atomic<uint32_t>>(mSqRing, params.sq_off.tail);
+    mSqMask = *RingField<uint32_t>(mSqRing, params.sq_off.ring_mask);
+    mSqEntries = *RingField<uint32_t>(mSqRing, params.sq_off.ring_entries);
+    mSqArray = RingField<uint32_t>(mSqRing, params.sq_off.array);
+    mCqHead = RingField<std::atomic<uint32_t>>(mCqRing, params.cq_off.head);
+    mCqTail = RingField<std::atomic<uint32_t>>(mCqRing, params.cq_off.tail);
+    mCqMask = *RingField<uint32_t>(mCqRing, params.cq_off.ring_mask);
+    mCqes = RingField<io_uring_cqe>(mCqRing, params.cq_off.cqes);
+
+    // Registered buffers are an optimization - if registration fails (e.g.
+    // because of RLIMIT_MEMLOCK) readers simply use their own buffers.
+    mFixedBuffersMemory.reset(new uint8_t[FIXED_BUFFERS_COUNT * FIXED_BUFFER_SIZE]);
+    std::vector<iovec> iovecs(FIXED_BUFFERS_COUNT);
+    for (size_t i = 0; i < FIXED_BUFFERS_COUNT; ++i)
+    {
+        iovecs[i].iov_base = mFixedBuffersMemory.get() + i * FIXED_BUFFER_SIZE;
+        iovecs[i].iov_len = FIXED_BUFFER_SIZE;
+    }
+
+    if (io_uring_register(mFd, IORING_REGISTER_BUFFERS, iovecs.data(), iovecs.size()) == 0)
+    {
+        for (size_t i = 0; i < FIXED_BUFFERS_COUNT; ++i)
+        {
+            mFreeFixedBuffers.push_back(static_cast<int>(i));
+        }
+    }
+    else
+    {
+        LogPrintf("io_uring buffer registration failed (%s), using unregistered buffers\n",
+            std::strerror(errno));
+        mFixedBuffersMemory.reset();
+    }
+
+    LogPrintf("Using io_uring for asynchronous file reads (queue depth %u, %u registered buffers)\n",
+        QUEUE_DEPTH, mFreeFixedBuffers.size());
+
+    return true;
+}
+
+CIoUring::~CIoUring()
+{
+    if (mSqes)
+    {
+        munmap(mSqes, mSqesSize);
+    }
+    if (mCqRing)
+    {
+        munmap(mCqRing, mCqRingSize);
+    }
+    if (mSqRing)
+    {
+        munmap(mSqRing, mSqRingSize);
+    }
+    if (mFd >= 0)
+    {
+        close(mFd);
+    }
+}
+
+io_uring_sqe* CIoUring::GetSqeNL()
+{
+    const uint32_t head = mSqHead->load(std::memory_order_acquire);
+    const uint32_t tail = mSqTail->load(std::memory_order_relaxed);
+    if (tail - head >= mSqEntries)
+    {
+        return nullptr;
+    }
+
+    io_uring_sqe* sqe = &mSqes[tail & mSqMask];
+    std::memset(sqe, 0, sizeof(io_uring_sqe));
+
+    return sqe;
+}
+
+bool CIoUring::SubmitNL(std::unique_lock<std::mutex>& lock, io_uring_sqe* sqe)
+{
+    const uint32_t tail = mSqTail->load(std::memory_order_relaxed);
+    assert(sqe == &mSqes[tail & mSqMask]);
+    mSqArray[tail & mSqMask] = tail & mSqMask;
+    mSqTail->store(tail + 1, std::memory_order_release);
+
+    while (true)
+    {
+        if (io_uring_enter(mFd, 1, 0, 0) >= 0)
+        {
+            return true;
+        }
+
+        switch (errno)
+        {
+        case EINTR:
+            break;
+        case EAGAIN:
+        case EBUSY:
+            // Entry was not consumed so we can't back out as it would be
+            // submitted by the next call - retry once completions are freed.
+            if (mReaping)
+            {
+                // Thread blocked in the kernel is woken up by the pending
+                // completions and reaps them - if we took them instead it
+                // could keep waiting for a completion that already happened.
+                mReaped.wait(lock);
+            }
+            else
+            {
+                ReapNL();
+                lock.unlock();
+                std::this_thread::yield();
+                lock.lock();
+            }
+            break;
+        default:
+            throw
+                std::runtime_error{
+                    std::string{"CIoUring: submission failed: "} + std::strerror(errno)};
+        }
+    }
+}
+
+void CIoUring::ReapNL()
+{
+    uint32_t head = mCqHead->load(std::memory_order_relaxed);
+    const uint32_t tail = mCqTail->load(std::memory_order_acquire);
+    if (head == tail)
+    {
+        return;
+    }
+
+    for (; head != tail; ++head)
+    {
+        const io_uring_cqe& cqe = mCqes[head & mCqMask];
+
+        // Cancellation requests carry no user data
+        if (cqe.user_data)
+        {
+            auto* request = reinterpret_cast<Request*>(cqe.user_data);
+            request->result = cqe.res;
+            request->done.store(true, std::memory_order_release);
+            --mInFlight;
+        }
+    }
+
+    mCqHead->store(tail, std::memory_order_release);
+    mReaped.notify_all();
+}
+
+bool CIoUring::SubmitRead(
+    Request& request,
+    int fd,
+    void* buffer,
+    size_t size,
+    uint64_t offset,
+    const FixedBuffer* fixedBuffer)
+{
+    std::unique_lock lock{mMutex};
+
+    if (mInFlight >= QUEUE_DEPTH)
+    {
+        return false;
+    }
+
+    io_uring_sqe* sqe = GetSqeNL();
+    if (!sqe)
+    {
+        return false;
+    }
+
+    request.done.store(false, std::memory_order_relaxed);
+    request.result = 0;
+
+    if (fixedBuffer)
+    {
+        assert(static_cast<uint8_t*>(buffer) >= fixedBuffer->data &&
+            static_cast<uint8_t*>(buffer) + size <= fixedBuffer->data + fixedBuffer->size);
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->buf_index = static_cast<uint16_t>(fixedBuffer->index);
+    }
+    else
+    {
+        sqe->opcode = IORING_OP_READ;
+    }
+    sqe->fd = fd;
+    sqe->off = offset;
+    sqe->addr = reinterpret_cast<uint64_t>(buffer);
+    sqe->len = static_cast<uint32_t>(size);
+    sqe->user_data = reinterpret_cast<uint64_t>(&request);
+
+    ++mInFlight;
+    SubmitNL(lock, sqe);
+
+    return true;
+}
+
+void CIoUring::Poll()
+{
+    std::lock_guard lock{mMutex};
+
+    // Thread blocked in the kernel reaps completions once it wakes up - if we
+    // took them it could keep waiting for a completion that already happened.
+    if (!mReaping)
+    {
+        ReapNL();
+    }
+}
+
+void CIoUring::Wait(Request& request)
+{
+    std::unique_lock lock{mMutex};
+
+    while (!request.done.load(std::memory_order_acquire))
+    {
+        if (mReaping)
+        {
+            mReaped.wait(lock);
+            continue;
+        }
+
+        ReapNL();
+        if (request.done.load(std::memory_order_acquire))
+        {
+            break;
+        }
+
+        mReaping = true;
+        lock.unlock();
+        io_uring_enter(mFd, 0, 1, IORING_ENTER_GETEVENTS);
+        lock.lock();
+        mReaping = false;
+
+        ReapNL();
+        // Wake up other waiters in case nothing was reaped so that one of them
+        // takes over waiting in the kernel
+        mReaped.notify_all();
+    }
+}
+
+void CIoUring::Cancel(Request& request)
+{
+    {
+        std::unique_lock lock{mMutex};
+
+        if (request.done.load(std::memory_order_acquire))
+        {
+            return;
+        }
+
+        // If cancellation can't be submitted we simply wait for the read
+        if (io_uring_sqe* sqe = GetSqeNL())
+        {
+            sqe->opcode = IORING_OP_ASYNC_CANCEL;
+            sqe->fd = -1;
+            sqe->addr = reinterpret_cast<uint64_t>(&request);
+            sqe->user_data = 0;
+            SubmitNL(lock, sqe);
+        }
+    }
+
+    Wait(request);
+}
+
+std::optional<CIoUring::FixedBuffer> CIoUring::AcquireFixedBuffer()
+{
+    std::lock_guard lock{mMutex};
+
+    if (mFreeFixedBuffers.empty())
+    {
+        return {};
+    }
+
+    const int index = mFreeFixedBuffers.back();
+    mFreeFixedBuffers.pop_back();
+
+    return
+        FixedBuffer{
+            mFixedBuffersMemory.get() + index * FIXED_BUFFER_SIZE,
+            FIXED_BUFFER_SIZE,
+            index};
+}
+
+void CIoUring::ReleaseFixedBuffer(const FixedBuffer& buffer)
+{
+    std::lock_guard lock{mMutex};
+
+    mFreeFixedBuffers.push_back(buffer.index);
+}
+
+#endif // USE_IO_URING
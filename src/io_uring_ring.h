@@ -0,0 +1,150 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_IO_URING_RING_H
+#define MVC_IO_URING_RING_H
+
+#ifdef USE_IO_URING
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/** Default for -iouring */
+static constexpr bool DEFAULT_IO_URING = true;
+
+/**
+ * Process wide io_uring instance used for asynchronous file reads.
+ *
+ * Any number of threads can submit reads to the same ring so reads of all
+ * concurrently served blocks are in flight at the same time without a thread
+ * per request (as glibc emulation of POSIX aio uses).
+ *
+ * The ring also owns a pool of buffers that are registered with the kernel
+ * (saves mapping the buffer pages on every request) which can be borrowed by
+ * readers that read into their own buffers (CReadAheadFileReader).
+ *
+ * Completions are reaped by whichever thread calls Poll() or Wait() and are
+ * signalled through the Request instance that was passed to SubmitRead().
+ */
+class CIoUring
+{
+public:
+    //! Completion state of a single read. Instance must not be moved or
+    //! destroyed while the read is in flight.
+    struct Request
+    {
+        std::atomic<bool> done{false};
+        //! Number of bytes read or negative errno value
+        int32_t result{0};
+    };
+
+    //! Registered buffer borrowed from the ring
+    struct FixedBuffer
+    {
+        uint8_t* data;
+        size_t size;
+        int index;
+    };
+
+    //! Maximum number of reads in flight
+    static constexpr unsigned QUEUE_DEPTH = 256;
+    static constexpr size_t FIXED_BUFFER_SIZE = 256 * 1024;
+    //! Kept small as registered buffers count towards RLIMIT_MEMLOCK
+    static constexpr size_t FIXED_BUFFERS_COUNT = 16;
+
+    /**
+     * Shared ring or nullptr if io_uring is not available (not supported or
+     * blocked by the kernel, or disabled with -iouring=0) - in that case
+     * callers should use their fallback path.
+     */
+    static CIoUring* Get();
+
+    ~CIoUring();
+
+    CIoUring(const CIoUring&) = delete;
+    CIoUring& operator=(const CIoUring&) = delete;
+    CIoUring(CIoUring&&) = delete;
+    CIoUring& operator=(CIoUring&&) = delete;
+
+    /**
+     * Submit read of size bytes at offset of fd into buffer. If fixedBuffer is
+     * provided buffer must lie within it.
+     *
+     * Returns false if the request couldn't be queued because too many
+     * requests are already in flight (or submission failed) - caller can
+     * retry later.
+     */
+    bool SubmitRead(
+        Request& request,
+        int fd,
+        void* buffer,
+        size_t size,
+        uint64_t offset,
+        const FixedBuffer* fixedBuffer = nullptr);
+
+    //! Process available completions without blocking
+    void Poll();
+
+    //! Block until the request has completed
+    void Wait(Request& request);
+
+    //! Try to cancel the request and wait for it to complete so that its
+    //! buffer can be released
+    void Cancel(Request& request);
+
+    //! Borrow a registered buffer - nullopt if none is available
+    std::optional<FixedBuffer> AcquireFixedBuffer();
+    void ReleaseFixedBuffer(const FixedBuffer& buffer);
+
+private:
+    CIoUring() = default;
+    bool Init();
+
+    io_uring_sqe* GetSqeNL();
+    //! Submit prepared entry - lock (holding mMutex) may be released
+    //! temporarily while waiting for the completion queue to drain
+    bool SubmitNL(std::unique_lock<std::mutex>& lock, io_uring_sqe* sqe);
+    void ReapNL();
+
+    int mFd{-1};
+
+    void* mSqRing{nullptr};
+    size_t mSqRingSize{0};
+    void* mCqRing{nullptr};
+    size_t mCqRingSize{0};
+    io_uring_sqe* mSqes{nullptr};
+    size_t mSqesSize{0};
+
+    std::atomic<uint32_t>* mSqHead{nullptr};
+    std::atomic<uint32_t>* mSqTail{nullptr};
+    uint32_t mSqMask{0};
+    uint32_t mSqEntries{0};
+    uint32_t* mSqArray{nullptr};
+    std::atomic<uint32_t>* mCqHead{nullptr};
+    std::atomic<uint32_t>* mCqTail{nullptr};
+    uint32_t mCqMask{0};
+    io_uring_cqe* mCqes{nullptr};
+
+    std::mutex mMutex;
+    std::condition_variable mReaped;
+    //! Whether a thread is waiting for completions inside the kernel
+    bool mReaping{false};
+    unsigned mInFlight{0};
+
+    std::unique_ptr<uint8_t[]> mFixedBuffersMemory;
+    std::vector<int> mFreeFixedBuffers;
+};
+
+#endif // USE_IO_URING
+
+#endif // MVC_IO_URING_RING_H
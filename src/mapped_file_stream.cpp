@@ -0,0 +1,134 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "mapped_file_stream.h"
+
+#include "compat.h"
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
+#ifndef WIN32
+#include <sys/stat.h>
+#endif
+
+std::unique_ptr<CMappedFileStream> CMappedFileStream::Make(FILE* file, size_t size)
+{
+#ifdef WIN32
+    return nullptr;
+#else
+    if (!file || size == 0)
+    {
+        return nullptr;
+    }
+
+    const int fd = fileno(file);
+    const long offset = ftell(file);
+    struct stat fileStat;
+    if (fd == -1 || offset < 0 || fstat(fd, &fileStat) != 0 ||
+        static_cast<uint64_t>(offset) + size > static_cast<uint64_t>(fileStat.st_size))
+    {
+        // Mapping beyond the end of file would result in SIGBUS on access
+        return nullptr;
+    }
+
+    // Mapping offset must be page aligned
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const size_t alignedOffset = static_cast<size_t>(offset) / pageSize * pageSize;
+    const size_t mappingSize = static_cast<size_t>(offset) - alignedOffset + size;
+
+    void* mapping = mmap(nullptr, mappingSize, PROT_READ, MAP_SHARED, fd, alignedOffset);
+    if (mapping == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    // Data is consumed once from start to end so start read-ahead right away
+    madvise(mapping, mappingSize, MADV_SEQUENTIAL);
+    madvise(mapping, mappingSize, MADV_WILLNEED);
+
+    return
+        std::unique_ptr<CMappedFileStream>{
+            new CMappedFileStream{
+                mapping,
+                mappingSize,
+                static_cast<const uint8_t*>(mapping) + (offset - alignedOffset),
+                size}};
+#endif
+}
+
+CMappedFileStream::CMappedFileStream(
+    void* mapping,
+    size_t mappingSize,
+    const uint8_t* data,
+    size_t size)
+    : mMapping{mapping}
+    , mMappingSize{mappingSize}
+    , mData{data}
+    , mSize{size}
+{/**/}
+
+CMappedFileStream::~CMappedFileStream()
+{
+#ifndef WIN32
+    munmap(mMapping, mMappingSize);
+#endif
+}
+
+CSpan CMappedFileStream::Read(size_t maxSize)
+{
+    // it's not feasible to try and read 0 bytes
+    assert(maxSize > 0);
+
+    const size_t size = std::min(mSize - mConsumed, maxSize);
+    CSpan span{mData + mConsumed, size};
+    mConsumed += size;
+
+    return span;
+}
+
+CSpan CMappedFileStream::ReadAsync(size_t maxSize)
+{
+    // it's not feasible to try and read 0 bytes
+    assert(maxSize > 0);
+
+    const size_t size = std::min(mSize - mConsumed, maxSize);
+    if (size > 0 && !IsResident(size))
+    {
+        // Let the caller do something else while data is being loaded instead
+        // of blocking on page faults.
+        return {};
+    }
+
+    return Read(size);
+}
+
+bool CMappedFileStream::IsResident(size_t size) const
+{
+#ifdef WIN32
+    return true;
+#else
+    const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    const uint8_t* mappingBegin = static_cast<const uint8_t*>(mMapping);
+    const size_t begin = (mData + mConsumed - mappingBegin) / pageSize * pageSize;
+    const size_t end = mData + mConsumed + size - mappingBegin;
+    const size_t length = end - begin;
+
+    std::vector<unsigned char> pages((length + pageSize - 1) / pageSize);
+    if (mincore(const_cast<uint8_t*>(mappingBegin) + begin, length, pages.data()) != 0)
+    {
+        // Can't tell - let the read block instead of never finishing
+        return true;
+    }
+
+    if (std::all_of(pages.begin(), pages.end(), [](unsigned char page){ return page & 1; }))
+    {
+        return true;
+    }
+
+    madvise(const_cast<uint8_t*>(mappingBegin) + begin, length, MADV_WILLNEED);
+    return false;
+#endif
+}
@@ -0,0 +1,67 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_MAPPED_FILE_STREAM_H
+#define MVC_MAPPED_FILE_STREAM_H
+
+#include <cstdio>
+#include <memory>
+
+#include "streams.h"
+
+/**
+ * Stream over a read-only memory mapping of a file region.
+ *
+ * Returned spans point directly into the mapping so data is not copied into
+ * an intermediate buffer before it is consumed (e.g. sent to a socket).
+ * Mapped region must not be modified while the stream exists - this holds for
+ * data that was already written to block files as it is never overwritten
+ * (deleted files remain mapped until the stream is destroyed).
+ *
+ * ReadAsync() doesn't block on page faults: if the next chunk is not yet in
+ * page cache it requests read-ahead and returns an empty span (same as
+ * CFixedSizeStream<CAsyncFileReader> while read is in progress). Read() may
+ * block.
+ */
+class CMappedFileStream
+    : public CForwardAsyncReadonlyStream
+    , public CForwardReadonlyStream
+{
+public:
+    /**
+     * Map size bytes of file starting at its current position. Returns nullptr
+     * if the region can't be mapped (e.g. it exceeds file size or memory
+     * mapping is not supported) - file position is unchanged in that case.
+     */
+    static std::unique_ptr<CMappedFileStream> Make(FILE* file, size_t size);
+
+    ~CMappedFileStream();
+
+    CMappedFileStream(const CMappedFileStream&) = delete;
+    CMappedFileStream& operator=(const CMappedFileStream&) = delete;
+    CMappedFileStream(CMappedFileStream&&) = delete;
+    CMappedFileStream& operator=(CMappedFileStream&&) = delete;
+
+    bool EndOfStream() const override { return mConsumed == mSize; }
+    CSpan Read(size_t maxSize) override;
+    CSpan ReadAsync(size_t maxSize) override;
+
+private:
+    CMappedFileStream(
+        void* mapping,
+        size_t mappingSize,
+        const uint8_t* data,
+        size_t size);
+
+    //! Whether all pages of the next size bytes are in page cache
+    bool IsResident(size_t size) const;
+
+    void* mMapping;
+    size_t mMappingSize;
+    const uint8_t* mData;
+    size_t mSize;
+    size_t mConsumed = 0u;
+};
+
+#endif // MVC_MAPPED_FILE_STREAM_H
@@ -12,14 +12,22 @@
 
 #include <future>
 #include <limits>
+#include <tuple>
 #include <variant>
 
-CMempoolTxDB::CMempoolTxDB(const fs::path& dbPath_, size_t nCacheSize_, bool fMemory_, bool fWipe)
+CMempoolTxDB::CMempoolTxDB(const fs::path& dbPath_, size_t nCacheSize_, bool fMemory_, bool fWipe,
+                           CMempoolTxStore::Compression compression)
     : dbPath{dbPath_},
       nCacheSize{nCacheSize_},
       fMemory{fMemory_},
-      wrapper{std::make_unique<CDBWrapper>(dbPath, nCacheSize, fMemory, fWipe)}
+      wrapper{std::make_unique<CDBWrapper>(dbPath, nCacheSize, fMemory, fWipe)},
+      store{std::make_unique<CMempoolTxStore>(dbPath / "segments", fMemory, compression)}
 {
+    if (fWipe)
+    {
+        store->Clear();
+    }
+
     uint64_t storedValue;
     if (wrapper->Read(DB_DISK_USAGE, storedValue))
     {
@@ -29,96 +37,137 @@ CMempoolTxDB::CMempoolTxDB(const fs::path& dbPath_, size_t nCacheSize_, bool fMe
     {
         txCount.store(storedValue);
     }
+
+    LoadIndex();
+    MigrateTransactions();
 }
 
-void CMempoolTxDB::ClearDatabase()
+void CMempoolTxDB::LoadIndex()
 {
-    diskUsage.store(0);
-    txCount.store(0);
-    dbWriteCount.store(0);
-    wrapper.reset();   // Release the old environment before creating a new one.
-    wrapper = std::make_unique<CDBWrapper>(dbPath, nCacheSize, fMemory, true);
+    static const auto initialKey = std::make_pair(DB_TX_LOCATION, uint256{});
+
+    std::unique_ptr<CDBIterator> iter {wrapper->NewIterator()};
+    iter->Seek(initialKey);
+
+    std::unique_lock lock {indexMutex};
+    index.clear();
+    for (; iter->Valid(); iter->Next())
+    {
+        auto key = decltype(initialKey){};
+        if (!iter->GetKey(key) || key.first != DB_TX_LOCATION)
+        {
+            break;
+        }
+        CMempoolTxStore::Location location;
+        if (iter->GetValue(location))
+        {
+            index.emplace(key.second, location);
+            store->AddLive(location);
+        }
+    }
+
+    // Anything else in the store was never committed to the index, or is
+    // left over from transactions that have since been removed.
+    store->RemoveUnused();
 }
 
-bool CMempoolTxDB::AddTransactions(const std::vector<CTransactionRef>& txs)
+void CMempoolTxDB::MigrateTransactions()
 {
-    const uint64_t txCountAdded = txs.size();
-    const uint64_t diskUsageAdded = [&txs]() {
-        auto accumulator = decltype(txs[0]->GetTotalSize()){0};
-        for (const auto& tx : txs)
+    static const auto initialKey = std::make_pair(DB_TRANSACTIONS, uint256{});
+
+    std::vector<std::pair<TxId, CMempoolTxStore::Location>> moved;
+    {
+        std::unique_ptr<CDBIterator> iter {wrapper->NewIterator()};
+        for (iter->Seek(initialKey); iter->Valid(); iter->Next())
         {
-            accumulator += tx->GetTotalSize();
+            auto key = decltype(initialKey){};
+            if (!iter->GetKey(key) || key.first != DB_TRANSACTIONS)
+            {
+                break;
+            }
+            CMutableTransaction txm;
+            if (iter->GetValue(txm))
+            {
+                moved.emplace_back(TxId{key.second}, store->Append(CTransaction{std::move(txm)}));
+            }
         }
-        return accumulator;
-    }();
+    }
+    if (moved.empty())
+    {
+        return;
+    }
 
+    if (!store->Flush())
+    {
+        throw std::runtime_error("Unable to move transactions to the mempool transaction store");
+    }
     auto batch = CDBBatch{*wrapper};
-    for (const auto& tx : txs)
+    for (const auto& [txid, location] : moved)
     {
-        batch.Write(std::make_pair(DB_TRANSACTIONS, tx->GetId()), tx);
+        batch.Write(std::make_pair(DB_TX_LOCATION, txid), location);
+        batch.Erase(std::make_pair(DB_TRANSACTIONS, txid));
     }
-    batch.Write(DB_DISK_USAGE, diskUsage.load() + diskUsageAdded);
-    batch.Write(DB_TX_COUNT, txCount.load() + txCountAdded);
-    batch.Erase(DB_MEMPOOL_XREF);
-
     ++dbWriteCount;
-    if (wrapper->WriteBatch(batch, true))
+    if (!wrapper->WriteBatch(batch, true))
     {
-        diskUsage.fetch_add(diskUsageAdded);
-        txCount.fetch_add(txCountAdded);
-        return true;
+        throw std::runtime_error("Unable to move transactions to the mempool transaction store");
     }
-    return false;
+
+    std::unique_lock lock {indexMutex};
+    for (const auto& [txid, location] : moved)
+    {
+        index[txid] = location;
+    }
+    LogPrint(BCLog::MEMPOOL, "Moved %zu transactions from leveldb to the mempool transaction store.\n",
+             moved.size());
 }
 
-bool CMempoolTxDB::GetTransaction(const uint256 &txid, CTransactionRef &tx)
+void CMempoolTxDB::ClearDatabase()
 {
-    const auto key = std::make_pair(DB_TRANSACTIONS, txid);
-    if (wrapper->Exists(key))
+    diskUsage.store(0);
+    txCount.store(0);
+    dbWriteCount.store(0);
     {
-        CMutableTransaction txm;
-        if (wrapper->Read(key, txm))
-        {
-            tx = MakeTransactionRef(std::move(txm));
-            return true;
-        }
+        std::unique_lock lock {indexMutex};
+        index.clear();
+        store->Clear();
     }
-    return false;
+    wrapper.reset();   // Release the old environment before creating a new one.
+    wrapper = std::make_unique<CDBWrapper>(dbPath, nCacheSize, fMemory, true);
 }
 
-bool CMempoolTxDB::TransactionExists(const uint256 &txid)
+bool CMempoolTxDB::AddTransactions(const std::vector<CTransactionRef>& txs)
 {
-    return wrapper->Exists(std::make_pair(DB_TRANSACTIONS, txid));
+    Batch batch;
+    for (const auto& tx : txs)
+    {
+        batch.Add(tx);
+    }
+    return Commit(batch);
 }
 
+bool CMempoolTxDB::GetTransaction(const uint256 &txid, CTransactionRef &tx)
+{
+    std::shared_lock lock {indexMutex};
+    const auto it = index.find(TxId{txid});
+    return it != index.end() && store->Read(it->second, tx);
+}
 
-bool CMempoolTxDB::RemoveTransactions(const std::vector<TxData>& txData)
+bool CMempoolTxDB::TransactionExists(const uint256 &txid)
 {
-    const uint64_t txCountRemoved = txData.size();
-    const uint64_t diskUsageRemoved = [&txData]() {
-        auto accumulator = decltype(txData[0].size){0};
-        for (const auto& td : txData) {
-            accumulator += td.size;
-        }
-        return accumulator;
-    }();
+    std::shared_lock lock {indexMutex};
+    return index.count(TxId{txid}) != 0;
+}
 
-    auto batch = CDBBatch{*wrapper};
-    for (const auto& td : txData) {
-        batch.Erase(std::make_pair(DB_TRANSACTIONS, td.txid));
-    }
-    batch.Write(DB_DISK_USAGE, diskUsage.load() - diskUsageRemoved);
-    batch.Write(DB_TX_COUNT, txCount.load() - txCountRemoved);
-    batch.Erase(DB_MEMPOOL_XREF);
 
-    ++dbWriteCount;
-    if (wrapper->WriteBatch(batch, true))
+bool CMempoolTxDB::RemoveTransactions(const std::vector<TxData>& txData)
+{
+    Batch batch;
+    for (const auto& td : txData)
     {
-        diskUsage.fetch_sub(diskUsageRemoved);
-        txCount.fetch_sub(txCountRemoved);
-        return true;
+        batch.Remove(td.txid, td.size);
     }
-    return false;
+    return Commit(batch);
 }
 
 uint64_t CMempoolTxDB::GetDiskUsage()
@@ -133,17 +182,12 @@ uint64_t CMempoolTxDB::GetTxCount()
 
 CMempoolTxDB::TxIdSet CMempoolTxDB::GetKeys()
 {
-    static const auto initialKey = std::make_pair(DB_TRANSACTIONS, uint256{});
-
-    std::unique_ptr<CDBIterator> iter {wrapper->NewIterator()};
-    iter->Seek(initialKey);
-
+    std::shared_lock lock {indexMutex};
     TxIdSet result;
-    for (; iter->Valid(); iter->Next())
+    result.reserve(index.size());
+    for (const auto& e : index)
     {
-        auto key = decltype(initialKey){};
-        iter->GetKey(key);
-        result.emplace(key.second);
+        result.emplace(e.first);
     }
     return result;
 }
@@ -226,17 +270,34 @@ bool CMempoolTxDB::Commit(const Batch& batch)
         return accumulator;
     }();
 
+    // Append all new transactions to the store and sync them once, before
+    // anything refers to them.
+    std::vector<std::pair<TxId, CMempoolTxStore::Location>> added;
+    added.reserve(batch.adds.size());
+    for (const auto& e : batch.adds)
+    {
+        added.emplace_back(e.first, store->Append(*e.second.tx));
+    }
+    if (!store->Flush())
+    {
+        for (const auto& e : added)
+        {
+            store->Release(e.second);
+        }
+        return false;
+    }
+
     const auto prevDiskUsage = diskUsage.fetch_add(diskUsageDiff);
     const auto prevTxCount = txCount.fetch_add(txCountDiff);
 
     auto coalesced = CDBBatch{*wrapper};
-    for (const auto& e : batch.adds)
+    for (const auto& [txid, location] : added)
     {
-        coalesced.Write(std::make_pair(DB_TRANSACTIONS, e.first), e.second.tx);
+        coalesced.Write(std::make_pair(DB_TX_LOCATION, txid), location);
     }
     for (const auto& e : batch.removes)
     {
-        coalesced.Erase(std::make_pair(DB_TRANSACTIONS, e.first));
+        coalesced.Erase(std::make_pair(DB_TX_LOCATION, e.first));
     }
     coalesced.Write(DB_DISK_USAGE, prevDiskUsage + diskUsageDiff);
     coalesced.Write(DB_TX_COUNT, prevTxCount + txCountDiff);
@@ -247,9 +308,35 @@ bool CMempoolTxDB::Commit(const Batch& batch)
     {
         diskUsage.fetch_sub(diskUsageDiff);
         txCount.fetch_sub(txCountDiff);
+        for (const auto& e : added)
+        {
+            store->Release(e.second);
+        }
         return false;
     }
 
+    {
+        std::unique_lock lock {indexMutex};
+        for (const auto& [txid, location] : added)
+        {
+            const auto [iter, inserted] = index.try_emplace(txid, location);
+            if (!inserted)
+            {
+                store->Release(iter->second);
+                iter->second = location;
+            }
+        }
+        for (const auto& e : batch.removes)
+        {
+            const auto iter = index.find(e.first);
+            if (iter != index.end())
+            {
+                store->Release(iter->second);
+                index.erase(iter);
+            }
+        }
+    }
+
     for (const auto& e : batch.adds)
     {
         if (e.second.update)
@@ -264,14 +351,87 @@ bool CMempoolTxDB::Commit(const Batch& batch)
             e.second.update(e.first);
         }
     }
+
+    Compact();
     return true;
 }
 
+void CMempoolTxDB::Compact()
+{
+    // Compacting scans the whole index, so wait until a fair part of the
+    // store is dead rather than doing it on every commit.
+    if (store->GetDeadBytes() * 100 < store->GetSize() * CMempoolTxStore::COMPACTION_DEAD_PERCENT)
+    {
+        return;
+    }
+
+    // Do at most one segment at a time to bound the extra work per commit.
+    const auto segment = store->GetCompactionCandidate();
+    if (!segment)
+    {
+        return;
+    }
+
+    // Only this thread changes the index so we needn't lock it for reading.
+    std::vector<std::tuple<TxId, CMempoolTxStore::Location, CMempoolTxStore::Location>> moved;
+    for (const auto& [txid, location] : index)
+    {
+        if (location.segment == segment.value())
+        {
+            if (const auto newLocation = store->Relocate(location))
+            {
+                moved.emplace_back(txid, location, newLocation.value());
+            }
+        }
+    }
+    if (!store->Flush())
+    {
+        for (const auto& [txid, oldLocation, newLocation] : moved)
+        {
+            store->Release(newLocation);
+        }
+        LogPrint(BCLog::MEMPOOL, "Mempool TxDB compaction of segment %u failed to flush.\n",
+                 segment.value());
+        return;
+    }
+
+    // Relocating transactions doesn't change the database contents, so the
+    // cross-reference key stays valid.
+    auto batch = CDBBatch{*wrapper};
+    for (const auto& [txid, oldLocation, newLocation] : moved)
+    {
+        batch.Write(std::make_pair(DB_TX_LOCATION, txid), newLocation);
+    }
+    ++dbWriteCount;
+    const bool written = wrapper->WriteBatch(batch, true);
+
+    std::unique_lock lock {indexMutex};
+    for (const auto& [txid, oldLocation, newLocation] : moved)
+    {
+        if (written)
+        {
+            index[txid] = newLocation;
+            store->Release(oldLocation);
+        }
+        else
+        {
+            store->Release(newLocation);
+        }
+    }
+    LogPrint(BCLog::MEMPOOL, "Mempool TxDB compacted segment %u, relocated %zu transactions%s.\n",
+             segment.value(), moved.size(), written ? "" : " (index update failed)");
+}
+
 uint64_t CMempoolTxDB::GetWriteCount()
 {
     return dbWriteCount.load();
 }
 
+uint64_t CMempoolTxDB::GetStoreSize()
+{
+    return store->GetSize();
+}
+
 
 // Task queue managment for CAsyncMempoolTxDB
 namespace {
@@ -374,9 +534,10 @@ public:
     }
 };
 
-CAsyncMempoolTxDB::CAsyncMempoolTxDB(const fs::path& dbPath, size_t cacheSize, bool inMemory)
+CAsyncMempoolTxDB::CAsyncMempoolTxDB(const fs::path& dbPath, size_t cacheSize, bool inMemory,
+                                     CMempoolTxStore::Compression compression)
     : queue{new TaskQueue{EstimateTaskQueueSize(GlobalConfig::GetConfig())}},
-      txdb{std::make_shared<CMempoolTxDB>(dbPath, cacheSize, inMemory)},
+      txdb{std::make_shared<CMempoolTxDB>(dbPath, cacheSize, inMemory, false, compression)},
       worker{[this](){ Work(); }}
 {
     const auto maxSize = queue->MaximalSize();
@@ -6,6 +6,7 @@
 #define MVC_MEMPOOLTXDB_H
 
 #include "dbwrapper.h"
+#include "mempooltxstore.h"
 #include "txhasher.h"
 #include "tx_mempool_info.h"
 
@@ -14,11 +15,16 @@
 #include <atomic>
 #include <cstdint>
 #include <memory>
+#include <shared_mutex>
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <thread>
 #include <vector>
 
+/** Default compression of transactions stored in the mempool transaction database */
+static const std::string DEFAULT_MEMPOOL_TXDB_COMPRESSION = "none";
+
 /**
  * Read-only access to transactions in the database.
  *
@@ -35,17 +41,26 @@ public:
 /**
  * Access to the mempool transaction database (mempoolTxDB).
  *
+ * Transaction bodies are kept in an append-only segment store (see
+ * CMempoolTxStore) and served from there; the leveldb database holds the
+ * location of each transaction in the store, together with the database
+ * metadata. The index of locations is also kept in memory so that reads
+ * don't need to go through leveldb.
+ *
  * Objects of this class should be used in a single-threaded context, otherwise
  * internal accounting will not be consistent. The exceptions to this rule are:
  * <ul>
  *  <li>Methods from the base @ref CMempoolTxDBReader that are implemented here;</li>
- *  <li>GetDiskUsage(), GetTxCount() and GetWriteCount().</li>
+ *  <li>GetDiskUsage(), GetTxCount(), GetWriteCount() and GetStoreSize().</li>
  * </ul>
  */
 class CMempoolTxDB : public CMempoolTxDBReader {
 private:
-    // Prefix to store map of Transaction values with txid as a key
+    // Prefix to store map of Transaction values with txid as a key. Only
+    // used by older versions, such entries are moved to the store on startup.
     static constexpr char DB_TRANSACTIONS = 'T';
+    // Prefix to store map of transaction locations in the store with txid as a key
+    static constexpr char DB_TX_LOCATION = 'L';
     // Prefix to store disk usage
     static constexpr char DB_DISK_USAGE = 'D';
     // Prefix to store transaaction count
@@ -59,20 +74,38 @@ private:
     const bool fMemory;
 
     std::unique_ptr<CDBWrapper> wrapper;
+    std::unique_ptr<CMempoolTxStore> store;
+
+    // Location of every transaction in the store
+    using TxIndex = std::unordered_map<TxId, CMempoolTxStore::Location, SaltedTxidHasher>;
+    TxIndex index;
+    mutable std::shared_mutex indexMutex;
 
     std::atomic_uint64_t diskUsage {0};
     std::atomic_uint64_t txCount {0};
     std::atomic_uint64_t dbWriteCount {0};
 
+    // Load the index of transaction locations and account for them in the store
+    void LoadIndex();
+
+    // Move transactions stored by older versions from leveldb to the store
+    void MigrateTransactions();
+
+    // Relocate live transactions out of a sparsely used segment, if there is one
+    void Compact();
+
 public:
     /**
      * Initializes mempool transaction database. nCacheSize is leveldb cache size
      * for this database. fMemory is false by default. If set to true, leveldb's
-     * memory environment will be used. fWipe is false by default. If set to
-     * true it will remove all existing data in this database.
+     * memory environment will be used and the store is kept in memory. fWipe
+     * is false by default. If set to true it will remove all existing data in
+     * this database. compression selects the compression of newly stored
+     * transactions.
      */
     CMempoolTxDB(const fs::path& dbPath, size_t nCacheSize,
-                 bool fMemory = false, bool fWipe = false);
+                 bool fMemory = false, bool fWipe = false,
+                 CMempoolTxStore::Compression compression = CMempoolTxStore::Compression::NONE);
 
     /*
      * Clear the contents of the database by recreating an empty one in place,
@@ -169,6 +202,9 @@ public:
 
     // Get the number of batch writes performed on the database.
     uint64_t GetWriteCount();
+
+    // Get the number of bytes taken by the store segments.
+    uint64_t GetStoreSize();
 };
 
 
@@ -176,7 +212,8 @@ public:
 class CAsyncMempoolTxDB
 {
 public:
-    CAsyncMempoolTxDB(const fs::path& dbPath, size_t cacheSize, bool inMemory);
+    CAsyncMempoolTxDB(const fs::path& dbPath, size_t cacheSize, bool inMemory,
+                      CMempoolTxStore::Compression compression = CMempoolTxStore::Compression::NONE);
     ~CAsyncMempoolTxDB();
 
     // Syncronize with the background thread after finishing pending tasks.
@@ -211,6 +248,12 @@ public:
         return txdb->GetWriteCount();
     }
 
+    // Get the number of bytes taken by the store segments.
+    uint64_t GetStoreSize()
+    {
+        return txdb->GetStoreSize();
+    }
+
     // Return a read-only database reference
     std::shared_ptr<CMempoolTxDBReader> GetDatabase();
 
@@ -0,0 +1,684 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "mempooltxstore.h"
+
+#include "clientversion.h"
+#include "compat.h"
+#include "crypto/common.h"
+#include "logging.h"
+#include "streams.h"
+#include "tinyformat.h"
+#include "util.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <limits>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#endif
+
+#ifdef USE_LZ4
+#include <lz4.h>
+#endif
+#ifdef USE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace
+{
+    // Don't bother compressing transactions smaller than this
+    constexpr size_t MIN_COMPRESS_SIZE { 256 };
+
+    // zstd compression level; low levels are fast and still do well on
+    // transaction data
+    [[maybe_unused]] constexpr int ZSTD_LEVEL { 3 };
+
+    // Compress data, return false if compression is unavailable or doesn't
+    // make the data any smaller.
+    bool Compress(CMempoolTxStore::Compression compression,
+                  const char* data,
+                  size_t size,
+                  std::vector<uint8_t>& compressed)
+    {
+        if(size < MIN_COMPRESS_SIZE)
+        {
+            return false;
+        }
+
+        size_t compressedSize {0};
+        switch(compression)
+        {
+#ifdef USE_LZ4
+            case CMempoolTxStore::Compression::LZ4:
+            {
+                if(size > static_cast<size_t>(LZ4_MAX_INPUT_SIZE))
+                {
+                    return false;
+                }
+                compressed.resize(static_cast<size_t>(LZ4_compressBound(static_cast<int>(size))));
+                int result { LZ4_compress_default(data,
+                                                  reinterpret_cast<char*>(compressed.data()),
+                                                  static_cast<int>(size),
+                                                  static_cast<int>(compressed.size())) };
+                if(result <= 0)
+                {
+                    return false;
+                }
+                compressedSize = static_cast<size_t>(result);
+                break;
+            }
+#endif
+#ifdef USE_ZSTD
+            case CMempoolTxStore::Compression::ZSTD:
+            {
+                compressed.resize(ZSTD_compressBound(size));
+                size_t result { ZSTD_compress(compressed.data(), compressed.size(), data, size, ZSTD_LEVEL) };
+                if(ZSTD_isError(result))
+                {
+                    return false;
+                }
+                compressedSize = result;
+                break;
+            }
+#endif
+            default:
+                return false;
+        }
+
+        if(compressedSize >= size)
+        {
+            return false;
+        }
+        compressed.resize(compressedSize);
+        return true;
+    }
+
+    // Decompress data, return false on failure
+    bool Decompress(CMempoolTxStore::Compression compression,
+                    const uint8_t* data,
+                    size_t size,
+                    CSerializeData& decompressed)
+    {
+        switch(compression)
+        {
+#ifdef USE_LZ4
+            case CMempoolTxStore::Compression::LZ4:
+            {
+                int result { LZ4_decompress_safe(reinterpret_cast<const char*>(data),
+                                                 decompressed.data(),
+                                                 static_cast<int>(size),
+                                                 static_cast<int>(decompressed.size())) };
+                return result >= 0 && static_cast<size_t>(result) == decompressed.size();
+            }
+#endif
+#ifdef USE_ZSTD
+            case CMempoolTxStore::Compression::ZSTD:
+            {
+                size_t result { ZSTD_decompress(decompressed.data(), decompressed.size(), data, size) };
+                return !ZSTD_isError(result) && result == decompressed.size();
+            }
+#endif
+            default:
+                return false;
+        }
+    }
+}
+
+/**
+ * A single segment file (or memory buffer when running in memory).
+ *
+ * Appends are only done by the writer. Data is read through a read-only
+ * mapping of the whole segment capacity which is created up front, so the
+ * mapping never has to be moved while readers might be using it.
+ */
+class CMempoolTxStore::Segment
+{
+public:
+    Segment(uint32_t id, FILE* file, uint64_t capacity, uint64_t size)
+    : mId{id}, mFile{file}, mCapacity{capacity}, mSize{size}, mReadableSize{size}
+    {
+#ifndef WIN32
+        if(mFile && mCapacity > 0)
+        {
+            void* mapping { mmap(nullptr, mCapacity, PROT_READ, MAP_SHARED, fileno(mFile), 0) };
+            if(mapping != MAP_FAILED)
+            {
+                mMapping = static_cast<const uint8_t*>(mapping);
+                // Records are looked up individually in no particular order
+                madvise(mapping, mCapacity, MADV_RANDOM);
+            }
+        }
+#endif
+    }
+
+    Segment(uint32_t id, uint64_t capacity)
+    : mId{id}, mCapacity{capacity}
+    {}
+
+    ~Segment()
+    {
+#ifndef WIN32
+        if(mMapping)
+        {
+            munmap(const_cast<uint8_t*>(mMapping), mCapacity);
+        }
+#endif
+        if(mFile)
+        {
+            fclose(mFile);
+        }
+    }
+
+    Segment(const Segment&) = delete;
+    Segment& operator=(const Segment&) = delete;
+
+    uint32_t GetId() const { return mId; }
+    uint64_t GetSize() const { return mSize; }
+    uint64_t GetCapacity() const { return mCapacity; }
+
+    // Append data, return false if the file write fails
+    bool Append(const uint8_t* data, size_t size)
+    {
+        if(!mFile)
+        {
+            mMemory.insert(mMemory.end(), data, data + size);
+            mSize += size;
+            mReadableSize = mSize.load();
+            return true;
+        }
+
+        std::lock_guard lock { mFileMutex };
+        if(fseek(mFile, static_cast<long>(mSize), SEEK_SET) != 0 ||
+           fwrite(data, 1, size, mFile) != size)
+        {
+            return false;
+        }
+        mSize += size;
+        return true;
+    }
+
+    // Push data written so far to the OS and then to disk. Data only
+    // becomes readable once it is known to be in the file, the mapping
+    // would fault on anything past its end.
+    bool Flush()
+    {
+        if(mFile)
+        {
+            std::lock_guard lock { mFileMutex };
+            if(!FileCommit(mFile))
+            {
+                return false;
+            }
+            mReadableSize = mSize.load();
+        }
+        return true;
+    }
+
+    // Get pointer to data at the given offset. It points either into the
+    // mapping or, if we have no mapping, into the passed buffer.
+    const uint8_t* Get(uint64_t offset, size_t size, std::vector<uint8_t>& buffer) const
+    {
+        // Data still buffered in the file stream isn't visible in the mapping
+        if(offset + size > mReadableSize)
+        {
+            return nullptr;
+        }
+
+        if(!mFile)
+        {
+            return mMemory.data() + offset;
+        }
+        if(mMapping)
+        {
+            return mMapping + offset;
+        }
+
+        std::lock_guard lock { mFileMutex };
+        buffer.resize(size);
+        if(fseek(mFile, static_cast<long>(offset), SEEK_SET) != 0 ||
+           fread(buffer.data(), 1, size, mFile) != size)
+        {
+            return nullptr;
+        }
+        return buffer.data();
+    }
+
+    // Accounting of records in use
+    uint64_t mLiveBytes {0};
+    uint64_t mLiveRecords {0};
+    bool mSealed {false};
+
+private:
+    const uint32_t mId {0};
+
+    FILE* mFile {nullptr};
+    mutable std::mutex mFileMutex {};
+    const uint8_t* mMapping {nullptr};
+    std::vector<uint8_t> mMemory {};
+
+    const uint64_t mCapacity {0};
+    std::atomic_uint64_t mSize {0};
+    std::atomic_uint64_t mReadableSize {0};
+};
+
+
+std::optional<CMempoolTxStore::Compression> CMempoolTxStore::ParseCompression(const std::string& name)
+{
+    if(name == "none")
+    {
+        return Compression::NONE;
+    }
+    if(name == "lz4")
+    {
+        return Compression::LZ4;
+    }
+    if(name == "zstd")
+    {
+        return Compression::ZSTD;
+    }
+    return std::nullopt;
+}
+
+bool CMempoolTxStore::IsCompressionSupported(Compression compression)
+{
+    switch(compression)
+    {
+        case Compression::NONE:
+            return true;
+        case Compression::LZ4:
+#ifdef USE_LZ4
+            return true;
+#else
+            return false;
+#endif
+        case Compression::ZSTD:
+#ifdef USE_ZSTD
+            return true;
+#else
+            return false;
+#endif
+    }
+    return false;
+}
+
+CMempoolTxStore::CMempoolTxStore(const fs::path& dir,
+                                 bool inMemory,
+                                 Compression compression,
+                                 uint32_t maxSegmentSize)
+: mDir{dir}
+, mInMemory{inMemory}
+, mCompression{IsCompressionSupported(compression) ? compression : Compression::NONE}
+, mMaxSegmentSize{maxSegmentSize}
+{
+    if(mInMemory)
+    {
+        return;
+    }
+
+    // Open existing segments; they are sealed and only ever read from now on
+    fs::create_directories(mDir);
+    for(const auto& entry : fs::directory_iterator(mDir))
+    {
+        uint32_t id {0};
+        const std::string name { entry.path().filename().string() };
+        if(!fs::is_regular_file(entry.status()) ||
+           sscanf(name.c_str(), "seg%08u.dat", &id) != 1 ||
+           name != GetSegmentPath(id).filename().string())
+        {
+            continue;
+        }
+
+        FILE* file { fsbridge::fopen(entry.path(), "rb") };
+        if(!file)
+        {
+            LogPrintf("Unable to open mempool transaction segment %s\n", entry.path().string());
+            continue;
+        }
+        const uint64_t size { fs::file_size(entry.path()) };
+        auto segment { std::make_unique<Segment>(id, file, size, size) };
+        segment->mSealed = true;
+        mSegments.emplace(id, std::move(segment));
+        mNextSegmentId = std::max(mNextSegmentId, id + 1);
+    }
+}
+
+CMempoolTxStore::~CMempoolTxStore()
+{
+    Flush();
+}
+
+void CMempoolTxStore::Clear()
+{
+    std::unique_lock lock { mMutex };
+    mActive = nullptr;
+    mUnflushed.clear();
+    for(auto& [id, segment] : mSegments)
+    {
+        segment.reset();
+        if(!mInMemory)
+        {
+            fs::remove(GetSegmentPath(id));
+        }
+    }
+    mSegments.clear();
+}
+
+CMempoolTxStore::Location CMempoolTxStore::Append(const CTransaction& tx)
+{
+    CDataStream stream { SER_DISK, CLIENT_VERSION };
+    stream.reserve(tx.GetTotalSize());
+    stream << tx;
+
+    std::vector<uint8_t> compressed {};
+    Compression compression { mCompression };
+    if(compression != Compression::NONE &&
+       !Compress(compression, stream.data(), stream.size(), compressed))
+    {
+        compression = Compression::NONE;
+    }
+
+    const size_t payloadSize { compression == Compression::NONE ? stream.size() : compressed.size() };
+    std::vector<uint8_t> record(RECORD_HEADER_SIZE + payloadSize);
+    record[0] = static_cast<uint8_t>(compression);
+    WriteLE32(record.data() + 1, static_cast<uint32_t>(stream.size()));
+    WriteLE32(record.data() + 5, static_cast<uint32_t>(payloadSize));
+    if(compression == Compression::NONE)
+    {
+        memcpy(record.data() + RECORD_HEADER_SIZE, stream.data(), payloadSize);
+    }
+    else
+    {
+        memcpy(record.data() + RECORD_HEADER_SIZE, compressed.data(), payloadSize);
+    }
+
+    return Write(record.data(), record.size());
+}
+
+std::optional<CMempoolTxStore::Location> CMempoolTxStore::Relocate(const Location& location)
+{
+    std::vector<uint8_t> record {};
+    {
+        std::shared_lock lock { mMutex };
+        auto it { mSegments.find(location.segment) };
+        if(it == mSegments.end())
+        {
+            return std::nullopt;
+        }
+        std::vector<uint8_t> buffer {};
+        const uint8_t* data { it->second->Get(location.offset, location.length, buffer) };
+        if(!data)
+        {
+            return std::nullopt;
+        }
+        record.assign(data, data + location.length);
+    }
+
+    return Write(record.data(), record.size());
+}
+
+CMempoolTxStore::Location CMempoolTxStore::Write(const uint8_t* record, size_t size)
+{
+    if(!mActive || mActive->GetSize() + size > mActive->GetCapacity())
+    {
+        StartSegment(size);
+    }
+
+    // Growing an in-memory segment may move its data
+    std::unique_lock lock { mMutex, std::defer_lock };
+    if(mInMemory)
+    {
+        lock.lock();
+    }
+
+    const uint64_t offset { mActive->GetSize() };
+    if(!mActive->Append(record, size))
+    {
+        throw std::runtime_error { strprintf("Unable to write mempool transaction segment %s",
+                                             GetSegmentPath(mActive->GetId()).string()) };
+    }
+    mUnflushed.insert(mActive->GetId());
+    ++mActive->mLiveRecords;
+    mActive->mLiveBytes += size;
+
+    return { mActive->GetId(), static_cast<uint32_t>(offset), static_cast<uint32_t>(size) };
+}
+
+void CMempoolTxStore::StartSegment(size_t minSize)
+{
+    if(mActive)
+    {
+        mActive->mSealed = true;
+        RemoveIfUnused(mActive->GetId());
+        mActive = nullptr;
+    }
+
+    const uint32_t id { mNextSegmentId++ };
+    const uint64_t capacity { std::max<uint64_t>(mMaxSegmentSize, minSize) };
+    std::unique_ptr<Segment> segment {};
+    if(mInMemory)
+    {
+        segment = std::make_unique<Segment>(id, capacity);
+    }
+    else
+    {
+        FILE* file { fsbridge::fopen(GetSegmentPath(id), "wb+") };
+        if(!file)
+        {
+            throw std::runtime_error { strprintf("Unable to create mempool transaction segment %s",
+                                                 GetSegmentPath(id).string()) };
+        }
+        segment = std::make_unique<Segment>(id, file, capacity, 0);
+    }
+
+    std::unique_lock lock { mMutex };
+    mActive = segment.get();
+    mSegments.emplace(id, std::move(segment));
+}
+
+bool CMempoolTxStore::Flush()
+{
+    // Segments are only removed by the writer so we needn't hold the lock
+    // while syncing
+    std::vector<Segment*> segments {};
+    {
+        std::shared_lock lock { mMutex };
+        for(uint32_t id : mUnflushed)
+        {
+            auto it { mSegments.find(id) };
+            if(it != mSegments.end())
+            {
+                segments.push_back(it->second.get());
+            }
+        }
+    }
+    mUnflushed.clear();
+
+    bool flushed {true};
+    for(Segment* segment : segments)
+    {
+        if(!segment->Flush())
+        {
+            LogPrintf("Unable to flush mempool transaction segment %s\n",
+                      GetSegmentPath(segment->GetId()).string());
+            flushed = false;
+
+            // We don't know what part of the buffered data made it to the
+            // file, so don't append to it any more
+            if(segment == mActive)
+            {
+                mActive->mSealed = true;
+                mActive = nullptr;
+                RemoveIfUnused(segment->GetId());
+            }
+        }
+    }
+    return flushed;
+}
+
+bool CMempoolTxStore::Read(const Location& location, CTransactionRef& tx) const
+{
+    std::shared_lock lock { mMutex };
+
+    auto it { mSegments.find(location.segment) };
+    if(it == mSegments.end() || location.length < RECORD_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> buffer {};
+    const uint8_t* record { it->second->Get(location.offset, location.length, buffer) };
+    if(!record)
+    {
+        return false;
+    }
+
+    const auto compression { static_cast<Compression>(record[0]) };
+    const uint32_t rawSize { ReadLE32(record + 1) };
+    const uint32_t payloadSize { ReadLE32(record + 5) };
+    if(payloadSize != location.length - RECORD_HEADER_SIZE)
+    {
+        return false;
+    }
+
+    const uint8_t* payload { record + RECORD_HEADER_SIZE };
+    CDataStream stream { SER_DISK, CLIENT_VERSION };
+    if(compression == Compression::NONE)
+    {
+        stream.write(reinterpret_cast<const char*>(payload), payloadSize);
+    }
+    else
+    {
+        CSerializeData decompressed(rawSize);
+        if(!Decompress(compression, payload, payloadSize, decompressed))
+        {
+            return false;
+        }
+        stream.SwapBuffer(decompressed);
+    }
+
+    try
+    {
+        CMutableTransaction mtx {};
+        stream >> mtx;
+        tx = MakeTransactionRef(std::move(mtx));
+    }
+    catch(const std::exception& e)
+    {
+        LogPrintf("Unable to deserialise mempool transaction from segment %u: %s\n",
+                  location.segment, e.what());
+        return false;
+    }
+    return true;
+}
+
+void CMempoolTxStore::AddLive(const Location& location)
+{
+    auto it { mSegments.find(location.segment) };
+    if(it != mSegments.end())
+    {
+        ++it->second->mLiveRecords;
+        it->second->mLiveBytes += location.length;
+    }
+}
+
+void CMempoolTxStore::RemoveUnused()
+{
+    std::vector<uint32_t> ids {};
+    for(const auto& [id, segment] : mSegments)
+    {
+        ids.push_back(id);
+    }
+    for(uint32_t id : ids)
+    {
+        RemoveIfUnused(id);
+    }
+}
+
+void CMempoolTxStore::Release(const Location& location)
+{
+    auto it { mSegments.find(location.segment) };
+    if(it == mSegments.end())
+    {
+        return;
+    }
+
+    Segment& segment { *it->second };
+    assert(segment.mLiveRecords > 0 && segment.mLiveBytes >= location.length);
+    --segment.mLiveRecords;
+    segment.mLiveBytes -= location.length;
+    RemoveIfUnused(location.segment);
+}
+
+void CMempoolTxStore::RemoveIfUnused(uint32_t id)
+{
+    auto it { mSegments.find(id) };
+    if(it == mSegments.end() || !it->second->mSealed || it->second->mLiveRecords > 0)
+    {
+        return;
+    }
+
+    {
+        std::unique_lock lock { mMutex };
+        mSegments.erase(it);
+        mUnflushed.erase(id);
+    }
+    if(!mInMemory)
+    {
+        fs::remove(GetSegmentPath(id));
+    }
+}
+
+std::optional<uint32_t> CMempoolTxStore::GetCompactionCandidate() const
+{
+    // Pick the emptiest segment so compaction copies as little as possible
+    std::optional<uint32_t> candidate {};
+    uint64_t candidateLive { std::numeric_limits<uint64_t>::max() };
+    for(const auto& [id, segment] : mSegments)
+    {
+        if(segment->mSealed &&
+           segment->mLiveBytes * 100 < segment->GetSize() * COMPACTION_LIVE_PERCENT &&
+           segment->mLiveBytes < candidateLive)
+        {
+            candidate = id;
+            candidateLive = segment->mLiveBytes;
+        }
+    }
+    return candidate;
+}
+
+uint64_t CMempoolTxStore::GetDeadBytes() const
+{
+    uint64_t dead {0};
+    for(const auto& [id, segment] : mSegments)
+    {
+        dead += segment->GetSize() - segment->mLiveBytes;
+    }
+    return dead;
+}
+
+uint64_t CMempoolTxStore::GetSize() const
+{
+    std::shared_lock lock { mMutex };
+    uint64_t size {0};
+    for(const auto& [id, segment] : mSegments)
+    {
+        size += segment->GetSize();
+    }
+    return size;
+}
+
+size_t CMempoolTxStore::GetSegmentCount() const
+{
+    std::shared_lock lock { mMutex };
+    return mSegments.size();
+}
+
+fs::path CMempoolTxStore::GetSegmentPath(uint32_t id) const
+{
+    return mDir / strprintf("seg%08u.dat", id);
+}
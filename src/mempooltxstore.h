@@ -0,0 +1,188 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_MEMPOOLTXSTORE_H
+#define MVC_MEMPOOLTXSTORE_H
+
+#include "fs.h"
+#include "primitives/transaction.h"
+#include "serialize.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Append-only storage for the bodies of mempool transactions that were moved
+ * to disk.
+ *
+ * Transactions are appended as records to the active segment file; once a
+ * segment fills up it is sealed and a new one is started, so a group of
+ * transactions written together costs one sequential write and one sync
+ * regardless of how many there are. Records are never modified in place.
+ * Records of transactions that left the mempool are only accounted as dead
+ * and segments are deleted once nothing in them is alive any more; sparsely
+ * used segments can be compacted by relocating their live records to the
+ * active segment.
+ *
+ * Segments are memory mapped and reads are served directly from the mapping
+ * (falling back to ordinary file reads where mapping isn't available).
+ *
+ * Records may optionally be compressed with LZ4 or zstd, if support for them
+ * was compiled in. The compression used is recorded per record so it can be
+ * changed between runs.
+ *
+ * The store doesn't keep track of which transaction is in which record, the
+ * owner (CMempoolTxDB) keeps that index. There must be a single writer:
+ * methods that append, flush or release records must not be called
+ * concurrently with each other. Read() and the size accessors can be called
+ * from any thread at any time.
+ */
+class CMempoolTxStore
+{
+public:
+    enum class Compression : uint8_t
+    {
+        NONE = 0,
+        LZ4 = 1,
+        ZSTD = 2
+    };
+
+    // Parse compression name as given on the command line
+    static std::optional<Compression> ParseCompression(const std::string& name);
+    // Is support for the given compression compiled in?
+    static bool IsCompressionSupported(Compression compression);
+
+    // Position of a record
+    struct Location
+    {
+        uint32_t segment {0};
+        uint32_t offset {0};
+        uint32_t length {0};
+
+        bool operator==(const Location& other) const
+        {
+            return segment == other.segment && offset == other.offset && length == other.length;
+        }
+        bool operator!=(const Location& other) const { return !(*this == other); }
+
+        ADD_SERIALIZE_METHODS;
+
+        template <typename Stream, typename Operation>
+        inline void SerializationOp(Stream& s, Operation ser_action)
+        {
+            READWRITE(segment);
+            READWRITE(offset);
+            READWRITE(length);
+        }
+    };
+
+    // Default maximal segment size
+    static constexpr uint32_t DEFAULT_SEGMENT_SIZE { 64 * 1024 * 1024 };
+
+    // Sealed segments with less than this percentage of their data still
+    // alive are candidates for compaction
+    static constexpr uint64_t COMPACTION_LIVE_PERCENT { 50 };
+
+    // Compaction is only attempted once at least this percentage of the
+    // whole store is dead
+    static constexpr uint64_t COMPACTION_DEAD_PERCENT { 25 };
+
+    /**
+     * Open store in the given directory. Existing segments are kept and must
+     * then be accounted for with AddLive(); segments that are not referenced
+     * by anything are removed by RemoveUnused(). If inMemory is set segments
+     * are kept in memory instead of files.
+     */
+    CMempoolTxStore(const fs::path& dir,
+                    bool inMemory,
+                    Compression compression,
+                    uint32_t maxSegmentSize = DEFAULT_SEGMENT_SIZE);
+    ~CMempoolTxStore();
+
+    CMempoolTxStore(const CMempoolTxStore&) = delete;
+    CMempoolTxStore& operator=(const CMempoolTxStore&) = delete;
+
+    // Remove all segments
+    void Clear();
+
+    // Append a transaction to the active segment. Records in segment files
+    // can only be read (and are only guaranteed durable) after a successful
+    // Flush(); in-memory records are readable right away.
+    Location Append(const CTransaction& tx);
+
+    // Copy a record to the active segment (used for compaction)
+    std::optional<Location> Relocate(const Location& location);
+
+    // Flush appended records to disk. Returns false if any segment could not
+    // be flushed; records appended to it since the last successful flush
+    // are then unreadable and should be released by the caller.
+    bool Flush();
+
+    // Read transaction from a record
+    bool Read(const Location& location, CTransactionRef& tx) const;
+
+    // Account for a record that is referenced by a loaded index
+    void AddLive(const Location& location);
+
+    // Delete segments that no loaded record is referencing
+    void RemoveUnused();
+
+    // Account for a record that is no longer referenced. Segments that
+    // have nothing alive are deleted.
+    void Release(const Location& location);
+
+    // Return a sealed segment that should be compacted, if there is one
+    std::optional<uint32_t> GetCompactionCandidate() const;
+
+    // Number of bytes in segments that no record is referencing (writer only)
+    uint64_t GetDeadBytes() const;
+
+    // Number of bytes taken by segments
+    uint64_t GetSize() const;
+
+    // Number of segments
+    size_t GetSegmentCount() const;
+
+private:
+    class Segment;
+
+    // Bytes in front of each record
+    static constexpr uint32_t RECORD_HEADER_SIZE { 9 };
+
+    // Write a record to the active segment, starting a new one if necessary
+    Location Write(const uint8_t* record, size_t size);
+
+    // Start a new active segment able to take at least minSize bytes
+    void StartSegment(size_t minSize);
+
+    // Delete segment if nothing in it is alive
+    void RemoveIfUnused(uint32_t id);
+
+    fs::path GetSegmentPath(uint32_t id) const;
+
+    // Guards the set of segments against concurrent readers; segments are
+    // only ever added and removed by the writer
+    mutable std::shared_mutex mMutex {};
+
+    const fs::path mDir;
+    const bool mInMemory;
+    const Compression mCompression;
+    const uint32_t mMaxSegmentSize;
+
+    std::map<uint32_t, std::unique_ptr<Segment>> mSegments;
+    Segment* mActive {nullptr};
+    uint32_t mNextSegmentId {0};
+
+    // Segments written to since the last Flush()
+    std::set<uint32_t> mUnflushed {};
+};
+
+#endif // MVC_MEMPOOLTXSTORE_H
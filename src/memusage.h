@@ -5,6 +5,8 @@
 #ifndef MVC_MEMUSAGE_H
 #define MVC_MEMUSAGE_H
 
+#include "compact_set.h"
+#include "flat_hash_map.h"
 #include "indirectmap.h"
 #include "prevector.h"
 
@@ -147,6 +149,19 @@ static inline size_t IncrementalDynamicUsage(const indirectmap<X, Y> &m) {
     return MallocUsage(sizeof(stl_tree_node<std::pair<const X *, Y>>));
 }
 
+// FlatHashMap has a control byte and a value pointer per lookup table slot and
+// allocates values in fixed size slabs
+
+template <typename X, typename Y, typename Z>
+static inline size_t DynamicUsage(const FlatHashMap<X, Y, Z> &m) {
+    using Map = FlatHashMap<X, Y, Z>;
+    return MallocUsage(m.bucket_count()) +
+           MallocUsage(m.bucket_count() * sizeof(typename Map::value_type *)) +
+           MallocUsage(m.slab_count() * sizeof(void *)) +
+           m.slab_count() *
+               MallocUsage(Map::SLAB_SIZE * sizeof(typename Map::value_type));
+}
+
 template <typename X>
 static inline size_t DynamicUsage(const std::unique_ptr<X> &p) {
     return p ? MallocUsage(sizeof(X)) : 0;
@@ -180,6 +195,17 @@ static inline size_t DynamicUsage(const std::unordered_map<X, Y, Z> &m) {
                m.size() +
            MallocUsage(sizeof(void *) * m.bucket_count());
 }
+
+// CompactSet has a flat vector of elements, plus a hash index once it grows
+// beyond linear search size
+
+template <typename X, typename Y>
+static inline size_t DynamicUsage(const CompactSet<X, Y> &s) {
+    using Index = typename CompactSet<X, Y>::index_type;
+    const Index *index = s.GetIndex();
+    return MallocUsage(s.capacity() * sizeof(X)) +
+           (index ? MallocUsage(sizeof(Index)) + DynamicUsage(*index) : 0);
+}
 } // namespace memusage
 
 #endif // MVC_MEMUSAGE_H
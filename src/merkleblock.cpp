@@ -8,6 +8,7 @@
 #include "blockstreams.h"
 #include "clientversion.h"
 #include "hash.h"
+#include "read_ahead_file_reader.h"
 #include "utilstrencodings.h"
 #include "streams.h"
 
@@ -37,7 +38,7 @@ CMerkleBlock::CMerkleBlock(const CBlock &block, CBloomFilter &filter) {
 }
 
 CMerkleBlock::CMerkleBlock(
-    CBlockStreamReader<CFileReader>& stream,
+    CBlockStreamReader<CReadAheadFileReader>& stream,
     CBloomFilter& filter)
     : header{stream.GetBlockHeader()}
 {
@@ -64,7 +65,7 @@ CMerkleBlock::CMerkleBlock(
 }
 
 CMerkleBlock::CMerkleBlock(
-    CBlockStreamReader<CFileReader>& stream,
+    CBlockStreamReader<CReadAheadFileReader>& stream,
     const std::set<TxId>& txids)
     : header{stream.GetBlockHeader()}
 {
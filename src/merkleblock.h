@@ -14,7 +14,7 @@
 #include <vector>
 #include <exception>
 
-class CFileReader;
+class CReadAheadFileReader;
 template<typename Reader>
 class CBlockStreamReader;
 
@@ -168,7 +168,7 @@ public:
      * transaction, thus the filter will likely be modified.
      */
     CMerkleBlock(const CBlock &block, CBloomFilter &filter);
-    CMerkleBlock(CBlockStreamReader<CFileReader>& stream, CBloomFilter &filter);
+    CMerkleBlock(CBlockStreamReader<CReadAheadFileReader>& stream, CBloomFilter &filter);
 
     /**
      * Create from a CBlock, matching the txids in the set.
@@ -178,7 +178,7 @@ public:
      *         is thrown.
      */
     CMerkleBlock(
-        CBlockStreamReader<CFileReader>& stream,
+        CBlockStreamReader<CReadAheadFileReader>& stream,
         const std::set<TxId> &txids);
 
     CMerkleBlock() {}
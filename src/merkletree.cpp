@@ -5,6 +5,24 @@
 #include "merkletree.h"
 #include "task_helpers.h"
 #include "blockstreams.h"
+#include "read_ahead_file_reader.h"
+#include "crypto/sha256.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace
+{
+    uint256 GetTransactionId(const CTransactionRef& transactionRef)
+    {
+        return transactionRef->GetId();
+    }
+
+    const uint256& GetTransactionId(const uint256& transactionId)
+    {
+        return transactionId;
+    }
+}
 
 CMerkleTree::CMerkleTree(const std::vector<CTransactionRef>& transactions, const uint256& blockHashIn, int32_t blockHeightIn, CThreadPool<CQueueAdaptor>* pThreadPool)
     : numberOfLeaves(transactions.size()), blockHash(blockHashIn), blockHeight(blockHeightIn)
@@ -17,7 +35,7 @@ CMerkleTree::CMerkleTree(const std::vector<CTransactionRef>& transactions, const
     CalculateMerkleTree<CTransactionRef>(transactions, pThreadPool);
 }
 
-CMerkleTree::CMerkleTree(CBlockStreamReader<CFileReader>& stream, const uint256& blockHashIn, int32_t blockHeightIn, CThreadPool<CQueueAdaptor>* pThreadPool)
+CMerkleTree::CMerkleTree(CBlockStreamReader<CReadAheadFileReader>& stream, const uint256& blockHashIn, int32_t blockHeightIn, CThreadPool<CQueueAdaptor>* pThreadPool)
     : blockHash(blockHashIn), blockHeight(blockHeightIn)
 {
     size_t numberOfRemainingTransactions = stream.GetRemainingTransactionsCount();
@@ -47,10 +65,7 @@ std::future<CMerkleTree> CMerkleTree::CreateBatchTask(typename std::vector<eleme
     auto calculateSubTree = [batchBeginIter, batchEndIter]()
     {
         CMerkleTree subTree(batchEndIter - batchBeginIter);
-        for (auto it = batchBeginIter; it != batchEndIter; ++it)
-        {
-            subTree.AddTransactionId(*it);
-        }
+        subTree.BuildFromTransactionIds<elementType>(batchBeginIter, batchEndIter);
         return subTree;
     };
     return (make_task(threadPool, calculateSubTree));
@@ -107,10 +122,7 @@ void CMerkleTree::CalculateMerkleTree(const std::vector<elementType>& vTransacti
     batchBeginIter = vTransactions.cbegin();
     batchEndIter = batchBeginIter;
     std::advance(batchEndIter, intBatchSize);
-    for (auto it = batchBeginIter; it != batchEndIter; ++it)
-    {
-        AddTransactionId(*it);
-    }
+    BuildFromTransactionIds<elementType>(batchBeginIter, batchEndIter);
 
     // Tasks must be ordered to make sure Merkle Tree is merged properly with other subtrees
     for (auto &f : futures)
@@ -122,6 +134,40 @@ void CMerkleTree::CalculateMerkleTree(const std::vector<elementType>& vTransacti
     }
 }
 
+template <typename elementType>
+void CMerkleTree::BuildFromTransactionIds(typename std::vector<elementType>::const_iterator beginIter,
+    typename std::vector<elementType>::const_iterator endIter)
+{
+    assert(merkleTreeLevelsWithNodeHashes.empty());
+    if (beginIter == endIter)
+    {
+        return;
+    }
+
+    // Reserve for allocation if number of leaves is known, same as AddNodeAtLevel does
+    auto newLevel = [this](size_t numberOfNodes)
+    {
+        std::vector<uint256> level;
+        level.reserve(std::max(numberOfNodes, numberOfLeaves >> merkleTreeLevelsWithNodeHashes.size()));
+        level.resize(numberOfNodes);
+        return level;
+    };
+
+    std::vector<uint256> leaves = newLevel(static_cast<size_t>(std::distance(beginIter, endIter)));
+    std::transform(beginIter, endIter, leaves.begin(), [](const elementType& element) { return GetTransactionId(element); });
+    merkleTreeLevelsWithNodeHashes.push_back(std::move(leaves));
+
+    /* Each level holds parents of all complete pairs of nodes on the level below;
+       the last node of a level with odd number of nodes waits for its sibling.
+     */
+    while (merkleTreeLevelsWithNodeHashes.back().size() > 1)
+    {
+        std::vector<uint256> parents = newLevel(merkleTreeLevelsWithNodeHashes.back().size() / 2);
+        SHA256D64(parents[0].begin(), merkleTreeLevelsWithNodeHashes.back()[0].begin(), parents.size());
+        merkleTreeLevelsWithNodeHashes.push_back(std::move(parents));
+    }
+}
+
 void CMerkleTree::AddTransactionId(const CTransactionRef& transactionRef)
 {
     AddNodeAtLevel(transactionRef->GetId(), 0);
@@ -268,6 +314,22 @@ uint256 CMerkleTree::GetMerkleRoot() const
     return merkleTreeLevelsWithNodeHashes.back().back();
 }
 
+bool CMerkleTree::HasDuplicateSiblings() const
+{
+    // Every complete pair of siblings is stored, only duplicated nodes on the right edge are not
+    for (const auto& currentLevel : merkleTreeLevelsWithNodeHashes)
+    {
+        for (size_t position = 0; position + 1 < currentLevel.size(); position += 2)
+        {
+            if (currentLevel[position] == currentLevel[position + 1])
+            {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
 uint64_t CMerkleTree::GetSizeInBytes() const
 {
     uint64_t numberOfNodes = 0;
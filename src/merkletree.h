@@ -44,7 +44,7 @@
 class CQueueAdaptor;
 template<typename QueueAdapter>
 class CThreadPool;
-class CFileReader;
+class CReadAheadFileReader;
 template<typename Reader>
 class CBlockStreamReader;
 
@@ -114,6 +114,16 @@ private:
     void AddTransactionId(const CTransactionRef& transactionRef);
     void AddTransactionId(const uint256& transactionId);
 
+    /**
+     * Builds an empty Merkle Tree from transactions in range [beginIter, endIter)
+     * at once. Gives the same tree as adding them one by one with AddTransactionId,
+     * but all parents on a level are calculated together with SHA256D64, which
+     * hashes several nodes at the same time where the CPU supports it.
+     */
+    template <typename elementType>
+    void BuildFromTransactionIds(typename std::vector<elementType>::const_iterator beginIter,
+        typename std::vector<elementType>::const_iterator endIter);
+
     /**
      * Adds node at specific level into the Merkle Tree.
      * Used by AddNode and MergeSubTree functions.
@@ -189,13 +199,20 @@ public:
      * This is needed when rebuilding the index from data files.
      * Optionally use thread pool pThreadPool for parallel calculation.
      */
-    CMerkleTree(CBlockStreamReader<CFileReader>& stream, const uint256& blockHashIn, int32_t blockHeightIn, CThreadPool<CQueueAdaptor>* pThreadPool = nullptr);
+    CMerkleTree(CBlockStreamReader<CReadAheadFileReader>& stream, const uint256& blockHashIn, int32_t blockHeightIn, CThreadPool<CQueueAdaptor>* pThreadPool = nullptr);
 
     /**
      * Returns Merkle root of this tree. If tree has no nodes it returns an empty hash.
      */
     uint256 GetMerkleRoot() const;
 
+    /**
+     * Returns true if two sibling nodes anywhere in the tree are identical. Such a
+     * tree has the same Merkle root as a tree with repeated transactions (CVE-2012-2459),
+     * this is the same check as the mutated flag of ComputeMerkleRoot.
+     */
+    bool HasDuplicateSiblings() const;
+
     /*
      * Returns size of Merkle Tree in bytes by calculating number of all hashes stored
      * multiplied by 32 bytes (uint256).
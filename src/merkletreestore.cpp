@@ -563,6 +563,17 @@ CMerkleTreeRef CMerkleTreeFactory::GetMerkleTree(const Config& config, CBlockInd
     return merkleTreeRef;
 }
 
+std::unique_ptr<CMerkleTree> CMerkleTreeFactory::CalculateMerkleTree(const CBlock& block, const int32_t blockHeight)
+{
+    return std::make_unique<CMerkleTree>(block.vtx, block.GetHash(), blockHeight, merkleTreeThreadPool.get());
+}
+
+void CMerkleTreeFactory::StoreMerkleTree(const Config& config, CMerkleTreeRef merkleTree, const int32_t currentChainHeight)
+{
+    merkleTreeStore.StoreMerkleTree(config, *merkleTree, currentChainHeight);
+    Insert(merkleTree->GetBlockHash(), merkleTree, config);
+}
+
 void CMerkleTreeFactory::Insert(const uint256& blockHash, CMerkleTreeRef merkleTree, const Config& config)
 {
     LOCK(cs_merkleTreeFactory);
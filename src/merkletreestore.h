@@ -209,6 +209,21 @@ public:
      * Returns null if block could not be read from disk to create a Merkle Tree.
      */
     CMerkleTreeRef GetMerkleTree(const Config& config, CBlockIndex& blockIndex, const int32_t currentChainHeight);
+
+    /**
+     * Calculates Merkle Tree of the given block's transactions using the factory's thread
+     * pool. Used when validating a block so that the Merkle root is not calculated serially.
+     * blockHeight must be set to height of the block.
+     */
+    std::unique_ptr<CMerkleTree> CalculateMerkleTree(const CBlock& block, const int32_t blockHeight);
+
+    /**
+     * Stores already calculated Merkle Tree of a block to disk and to the memory cache, so
+     * it doesn't have to be calculated again when it is requested with GetMerkleTree.
+     * Does nothing if it was already stored. currentChainHeight has the same meaning as in
+     * GetMerkleTree.
+     */
+    void StoreMerkleTree(const Config& config, CMerkleTreeRef merkleTree, const int32_t currentChainHeight);
 private:
     /**
      * Inserts merkleTree into a cached map with key blockHash.
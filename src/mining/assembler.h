@@ -6,6 +6,9 @@
 
 #include "primitives/block.h"
 
+#include <optional>
+#include <vector>
+
 class Config;
 class CBlockIndex;
 
@@ -25,6 +28,10 @@ public:
     CBlockRef GetBlockRef() const { return mBlock; }
 
     std::vector<Amount> vTxFees;
+
+    // Merkle branch of the coinbase, if the assembler maintained it while
+    // adding transactions
+    std::optional<std::vector<uint256>> coinbaseMerkleProof;
 };
 
 
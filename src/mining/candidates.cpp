@@ -3,6 +3,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include "candidates.h"
+#include "consensus/merkle.h"
 #include "utiltime.h"
 #include "validation.h"
 
@@ -14,7 +15,7 @@ namespace
 /**
  * CMiningCandidate constructor.
  */
-CMiningCandidate::CMiningCandidate(MiningCandidateId id, const CBlockRef& block)
+CMiningCandidate::CMiningCandidate(MiningCandidateId id, const CBlockRef& block, std::optional<std::vector<uint256>> coinbaseMerkleProof)
     : mId{id}, mBlock{block}
 {
     if(!block || block->vtx.empty())
@@ -27,6 +28,15 @@ CMiningCandidate::CMiningCandidate(MiningCandidateId id, const CBlockRef& block)
     mBlockBits = block->nBits;
     mBlockVersion = block->nVersion;
     mBlockCoinbase = block->vtx[0];
+
+    if(coinbaseMerkleProof)
+    {
+        mCoinbaseMerkleProof = std::move(*coinbaseMerkleProof);
+    }
+    else
+    {
+        mCoinbaseMerkleProof = BlockMerkleBranch(*block, 0);
+    }
 }
 
 
@@ -36,12 +46,12 @@ CMiningCandidate::CMiningCandidate(MiningCandidateId id, const CBlockRef& block)
  *
  * @return a reference to the MiningCandidate.
  */
-CMiningCandidateRef CMiningCandidateManager::Create(const CBlockRef& block)
+CMiningCandidateRef CMiningCandidateManager::Create(const CBlockRef& block, std::optional<std::vector<uint256>> coinbaseMerkleProof)
 {
     // Create UUID for next candidate
     MiningCandidateId nextId { mIdGenerator() };
 
-    auto candidate = std::make_shared<CMiningCandidate>(CMiningCandidate(nextId, block));
+    auto candidate = std::make_shared<CMiningCandidate>(CMiningCandidate(nextId, block, std::move(coinbaseMerkleProof)));
     std::lock_guard<std::mutex> lock {mMutex};
     mCandidates[nextId] = candidate;
     return candidate;
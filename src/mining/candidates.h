@@ -6,9 +6,12 @@
 #define MVC_CANDIDATES_H
 
 #include "primitives/block.h"
+#include "uint256.h"
 
 #include <atomic>
 #include <mutex>
+#include <optional>
+#include <vector>
 
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
@@ -36,9 +39,11 @@ public:
     uint32_t GetBlockBits() const { return mBlockBits; }
     int32_t GetBlockVersion() const { return mBlockVersion; }
     CTransactionRef GetBlockCoinbase() const { return mBlockCoinbase; }
+    // Merkle branch of the coinbase; doesn't depend on the coinbase itself
+    const std::vector<uint256>& GetCoinbaseMerkleProof() const { return mCoinbaseMerkleProof; }
 
 private:
-    CMiningCandidate(MiningCandidateId id, const CBlockRef& block);
+    CMiningCandidate(MiningCandidateId id, const CBlockRef& block, std::optional<std::vector<uint256>> coinbaseMerkleProof);
 
     // This candidate ID
     MiningCandidateId mId {};
@@ -51,6 +56,7 @@ private:
     uint32_t mBlockBits {};
     int32_t mBlockVersion {};
     CTransactionRef mBlockCoinbase {};
+    std::vector<uint256> mCoinbaseMerkleProof {};
 };
 using CMiningCandidateRef = std::shared_ptr<CMiningCandidate>;
 
@@ -60,7 +66,8 @@ using CMiningCandidateRef = std::shared_ptr<CMiningCandidate>;
  */
 class CMiningCandidateManager {
 public:
-    CMiningCandidateRef Create(const CBlockRef& block);
+    // Coinbase Merkle branch is calculated from the block if not given
+    CMiningCandidateRef Create(const CBlockRef& block, std::optional<std::vector<uint256>> coinbaseMerkleProof = std::nullopt);
     CMiningCandidateRef Get(const MiningCandidateId& candidateId) const;
 
     void Remove(MiningCandidateId candidateId) {
@@ -0,0 +1,146 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace mining
+{
+
+/**
+* An append-only list of values stored in fixed size chunks.
+*
+* Once a chunk is full it is sealed and never modified again, so snapshots of
+* the list can share sealed chunks instead of copying them. Taking a snapshot
+* costs one pointer copy per sealed chunk plus a copy of the partially filled
+* last chunk, regardless of how many values the list holds.
+*
+* The list may be truncated (to roll back appended values); a sealed chunk
+* that is cut in two is copied rather than modified, so existing snapshots
+* are not affected.
+*
+* Not thread safe; a snapshot can be used independently of the list once it
+* has been taken.
+*/
+template<typename T>
+class CChunkedVector
+{
+  public:
+
+    using Chunk = std::vector<T>;
+    using ChunkRef = std::shared_ptr<const Chunk>;
+
+    static constexpr size_t DEFAULT_CHUNK_SIZE {4096};
+
+    // Immutable copy of the list at the time it was taken
+    class Snapshot
+    {
+      public:
+        size_t size() const { return mSize; }
+
+        // Copy values into a flat vector
+        std::vector<T> ToVector() const
+        {
+            std::vector<T> result {};
+            result.reserve(mSize);
+            for(const ChunkRef& chunk : mChunks)
+            {
+                result.insert(result.end(), chunk->begin(), chunk->end());
+            }
+            result.insert(result.end(), mTail.begin(), mTail.end());
+            return result;
+        }
+
+      private:
+        friend class CChunkedVector;
+
+        std::vector<ChunkRef> mChunks {};
+        Chunk mTail {};
+        size_t mSize {0};
+    };
+
+    explicit CChunkedVector(size_t chunkSize = DEFAULT_CHUNK_SIZE)
+    : mChunkSize{chunkSize}
+    {
+        mTail.reserve(mChunkSize);
+    }
+
+    size_t size() const { return mSealedSize + mTail.size(); }
+    bool empty() const { return size() == 0; }
+
+    template<typename... Args>
+    void emplace_back(Args&&... args)
+    {
+        mTail.emplace_back(std::forward<Args>(args)...);
+        if(mTail.size() >= mChunkSize)
+        {
+            mSealedSize += mTail.size();
+            mChunks.push_back(std::make_shared<const Chunk>(std::move(mTail)));
+            mTail = Chunk{};
+            mTail.reserve(mChunkSize);
+        }
+    }
+
+    void clear()
+    {
+        mChunks.clear();
+        mTail.clear();
+        mSealedSize = 0;
+    }
+
+    // Drop values from the end so that newSize values remain
+    void truncate(size_t newSize)
+    {
+        if(newSize >= size())
+        {
+            return;
+        }
+
+        if(newSize >= mSealedSize)
+        {
+            mTail.erase(mTail.begin() + static_cast<std::ptrdiff_t>(newSize - mSealedSize), mTail.end());
+            return;
+        }
+
+        mTail.clear();
+        while(mSealedSize > newSize)
+        {
+            const ChunkRef lastChunk { std::move(mChunks.back()) };
+            mChunks.pop_back();
+            mSealedSize -= lastChunk->size();
+            if(mSealedSize < newSize)
+            {
+                // Copy the part we keep; the chunk may be shared by snapshots
+                mTail.assign(lastChunk->begin(), lastChunk->begin() + static_cast<std::ptrdiff_t>(newSize - mSealedSize));
+            }
+        }
+        mTail.reserve(mChunkSize);
+    }
+
+    Snapshot GetSnapshot() const
+    {
+        Snapshot snapshot {};
+        snapshot.mChunks = mChunks;
+        snapshot.mTail = mTail;
+        snapshot.mSize = size();
+        return snapshot;
+    }
+
+  private:
+
+    size_t mChunkSize {DEFAULT_CHUNK_SIZE};
+
+    // Sealed chunks and the number of values in them
+    std::vector<ChunkRef> mChunks {};
+    size_t mSealedSize {0};
+
+    // Chunk being filled
+    Chunk mTail {};
+};
+
+}
@@ -67,6 +67,11 @@ void JournalingBlockAssembler::ReadConfigParameters()
 std::unique_ptr<CBlockTemplate> JournalingBlockAssembler::CreateNewBlock(const CScript& scriptPubKeyIn, CBlockIndex*& pindexPrev)
 {
     CBlockRef block { std::make_shared<CBlock>() };
+    CChunkedVector<CTransactionRef>::Snapshot blockTxns {};
+    CChunkedVector<Amount>::Snapshot txFees {};
+    std::vector<uint256> coinbaseMerkleProof {};
+    Amount blockFees {0};
+    uint64_t blockSigOps {0};
 
     // Get tip we're builing on
     LOCK(cs_main);
@@ -77,12 +82,19 @@ std::unique_ptr<CBlockTemplate> JournalingBlockAssembler::CreateNewBlock(const C
 
         // Get our best block even if the background thread hasn't run for a while
         updateBlock(pindexPrevNew, mNewBlockFill? std::numeric_limits<uint64_t>::max() : mMaxSlotTransactions.load());
-        // Copy our current transactions into the block
-        block->vtx = mBlockTxns;
+        // Take a snapshot of our current transactions, the copy into the
+        // block is made after we release the mutex. The background thread
+        // may change mState as soon as we do, so copy everything we need.
+        blockTxns = mBlockTxns.GetSnapshot();
+        txFees = mTxFees.GetSnapshot();
+        coinbaseMerkleProof = mState.mCoinbaseMerkleBranch.GetBranch();
+        blockFees = mState.mBlockFees;
+        blockSigOps = mState.mBlockSigOps;
     }
+    block->vtx = blockTxns.ToVector();
 
     // Fill in the block header fields
-    FillBlockHeader(block, pindexPrevNew, scriptPubKeyIn, mState.mBlockFees);
+    FillBlockHeader(block, pindexPrevNew, scriptPubKeyIn, blockFees);
 
     // If required, check block validity
     if(mConfig.GetTestBlockCandidateValidity())
@@ -105,14 +117,15 @@ std::unique_ptr<CBlockTemplate> JournalingBlockAssembler::CreateNewBlock(const C
         GetSerializeSize(*block, SER_NETWORK, PROTOCOL_VERSION) };
 
     LogPrintf("JournalingBlockAssembler::CreateNewBlock(): total size: %u txs: %u fees: %ld sigops %d\n",
-        blockStats.blockSize, blockStats.txCount, mState.mBlockFees, mState.mBlockSigOps);
+        blockStats.blockSize, blockStats.txCount, blockFees, blockSigOps);
 
     mLastBlockStats = blockStats;
 
     // Build template
     std::unique_ptr<CBlockTemplate> blockTemplate { std::make_unique<CBlockTemplate>(block) };
-    blockTemplate->vTxFees = mTxFees;
-    blockTemplate->vTxFees[0] = -1 * mState.mBlockFees;
+    blockTemplate->vTxFees = txFees.ToVector();
+    blockTemplate->vTxFees[0] = -1 * blockFees;
+    blockTemplate->coinbaseMerkleProof = std::move(coinbaseMerkleProof);
 
     // Can now update callers pindexPrev
     pindexPrev = pindexPrevNew;
@@ -261,6 +274,7 @@ void JournalingBlockAssembler::newBlock()
     mState.mBlockFees = Amount{0};
     mState.mBlockSigOps = COINBASE_SIG_OPS;
     mState.mBlockSize = COINBASE_SIZE;
+    mState.mCoinbaseMerkleBranch = {};
 
     // Add dummy coinbase as first transaction
     mBlockTxns.emplace_back();
@@ -348,6 +362,7 @@ size_t JournalingBlockAssembler::addTransaction(const CBlockIndex* pindex, uint6
     // Append next txn to the block template
     mBlockTxns.emplace_back(txn);
     mTxFees.emplace_back(entry.getFee());
+    mState.mCoinbaseMerkleBranch.Add(txn->GetId());
 
     // Update block accounting details
     mState.mBlockSize = blockSizeWithTx;
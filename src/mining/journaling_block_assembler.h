@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include <consensus/merkle.h>
 #include <mining/assembler.h>
+#include <mining/chunked_vector.h>
 #include <mining/journal.h>
 
 #include <future>
@@ -100,9 +102,14 @@ class JournalingBlockAssembler : public BlockAssembler
         Amount mBlockFees {0};
         // Position where we're reading from the index
         CJournal::Index mJournalPos {};
+        // Merkle branch of the coinbase over the transactions added so far,
+        // so that candidates don't have to rebuild the tree (~2KiB)
+        CIncrementalCoinbaseMerkleBranch mCoinbaseMerkleBranch {};
     };
-    std::vector<CTransactionRef> mBlockTxns {};
-    std::vector<Amount> mTxFees {};
+    // Kept in chunks so that CreateNewBlock() can take a snapshot of them
+    // without copying the whole block while holding our mutex
+    CChunkedVector<CTransactionRef> mBlockTxns {};
+    CChunkedVector<Amount> mTxFees {};
 
     BlockAssemblyState mState {};
     // When adding transaction group we optimize for the happy case
@@ -122,16 +129,16 @@ class JournalingBlockAssembler : public BlockAssembler
 
         template<class T> class VectorCheckpoint {
         private:
-            std::vector<T> &mVector;
+            CChunkedVector<T> &mVector;
             size_t mVectorSize {0};
         public:
-            VectorCheckpoint(std::vector<T> &vector)
+            VectorCheckpoint(CChunkedVector<T> &vector)
             : mVector(vector)
             , mVectorSize(vector.size())
             {
             }
             void trimToSize() {
-                mVector.erase(std::next(mVector.begin(), mVectorSize), mVector.end());
+                mVector.truncate(mVectorSize);
             }
         };
         // for vectors, just remember the size as the iterators are very unstable
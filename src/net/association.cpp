@@ -65,6 +65,9 @@ void Association::ClearAssociationID()
 Association::~Association()
 {
     Shutdown();
+
+    // A network worker may still hold on to our streams for a while
+    ForEachStream([](StreamPtr& stream){ stream->SetOwningNode(nullptr); });
 }
 
 CService Association::GetPeerAddrLocal() const
@@ -154,6 +157,9 @@ void Association::MoveStream(StreamType newType, Association& to)
     streamToMove->SetStreamType(newType);
     streamToMove->SetOwningNode(to.mNode);
     to.mStreams[newType] = streamToMove;
+
+    // Events a network worker picked up for the old owner must not get lost
+    streamToMove->ActivateSocketEvents(true);
 }
 
 void Association::ReplaceStreamPolicy(const StreamPolicyPtr& newPolicy)
@@ -400,6 +406,44 @@ void Association::ServiceSockets(fd_set& setRecv, fd_set& setSend, fd_set& setEr
     }
 }
 
+bool Association::RegisterSocketEvents(SocketEventLoop& eventLoop)
+{
+    LOCK(cs_mStreams);
+    for(const auto& stream : mStreams)
+    {
+        if(!stream.second->RegisterSocketEvents(eventLoop))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void Association::ServiceSocketEvents(CConnman& connman, const Config& config, bool& gotNewMsgs,
+                                      uint64_t& bytesRecv, uint64_t& bytesSent)
+{
+    bytesRecv = bytesSent = 0;
+
+    // Service each stream socket
+    try
+    {
+        LOCK(cs_mStreams);
+        mStreamPolicy->ServiceSocketEvents(mStreams, config, gotNewMsgs, bytesRecv, bytesSent);
+    }
+    catch(const BanPeer& e)
+    {
+        LogPrint(BCLog::NETCONN, "Fatal error servicing streams: %s, banning peer=%d\n", e.what(), mNode->GetId());
+        mNode->CloseSocketDisconnect();
+        connman.Ban(GetPeerAddr(), BanReasonNodeMisbehaving);
+    }
+    catch(const std::exception& e)
+    {
+        LogPrint(BCLog::NETCONN, "Error servicing streams: %s, peer=%d\n", e.what(), mNode->GetId());
+        mNode->CloseSocketDisconnect();
+    }
+}
+
 void Association::AvgBandwithCalc()
 {
     // Let each stream do its own calculations
@@ -20,6 +20,7 @@ class CConnman;
 class CNode;
 class Config;
 class CSerializedNetMsg;
+class SocketEventLoop;
 
 /**
  * An association is a connection between 2 peers which may carry
@@ -81,6 +82,13 @@ class Association
     void ServiceSockets(fd_set& setRecv, fd_set& setSend, fd_set& setError, CConnman& connman,
                         const Config& config, bool& gotNewMsgs, uint64_t& bytesRecv, uint64_t& bytesSent);
 
+    // Register our sockets with the event loop
+    bool RegisterSocketEvents(SocketEventLoop& eventLoop);
+
+    // Service all sockets the event loop reported as ready
+    void ServiceSocketEvents(CConnman& connman, const Config& config, bool& gotNewMsgs,
+                             uint64_t& bytesRecv, uint64_t& bytesSent);
+
     // Get current total send queue size
     uint64_t GetTotalSendQueueSize() const;
 
@@ -0,0 +1,180 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <net/block_stream_parser.h>
+#include <coins.h>
+#include <config.h>
+#include <logging.h>
+#include <pow.h>
+#include <txdb.h>
+#include <validation.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace
+{
+    // Thrown when we run out of received data part way through an item
+    class NeedMoreData : public std::exception
+    {
+      public:
+        const char* what() const noexcept override { return "need more data"; }
+    };
+
+    // Minimal read only stream over a range of already received bytes
+    class PayloadReader
+    {
+      public:
+        PayloadReader(int type, int version, const char* begin, const char* end)
+        : mType{type}, mVersion{version}, mBegin{begin}, mCurr{begin}, mEnd{end}
+        {}
+
+        template <typename T>
+        PayloadReader& operator>>(T& obj)
+        {
+            ::Unserialize(*this, obj);
+            return *this;
+        }
+
+        void read(char* pch, size_t nSize)
+        {
+            if(nSize > static_cast<size_t>(mEnd - mCurr))
+            {
+                throw NeedMoreData {};
+            }
+            memcpy(pch, mCurr, nSize);
+            mCurr += nSize;
+        }
+
+        int GetType() const { return mType; }
+        int GetVersion() const { return mVersion; }
+
+        size_t GetBytesRead() const { return static_cast<size_t>(mCurr - mBegin); }
+
+      private:
+        const int mType {0};
+        const int mVersion {0};
+        const char* mBegin {nullptr};
+        const char* mCurr {nullptr};
+        const char* mEnd {nullptr};
+    };
+}
+
+BlockStreamParser::BlockStreamParser(int type, int version, uint64_t payloadLength)
+: mType{type}, mVersion{version}, mPayloadLength{payloadLength}
+{
+}
+
+void BlockStreamParser::Parse(const Config& config, const CDataStream& payload, bool force)
+{
+    if(mState == State::COMPLETE || mState == State::FAILED)
+    {
+        return;
+    }
+
+    const size_t available { payload.size() };
+    if(!force && available < mNextAttemptSize)
+    {
+        return;
+    }
+
+    try
+    {
+        while(mState != State::COMPLETE)
+        {
+            PayloadReader reader { mType, mVersion, payload.data() + mParsePos, payload.data() + available };
+
+            switch(mState)
+            {
+                case State::HEADER:
+                {
+                    reader >> *static_cast<CBlockHeader*>(mBlock.get());
+                    mPrefetch = CheckProofOfWork(mBlock->GetHash(), mBlock->nBits, config);
+                    mState = State::TX_COUNT;
+                    break;
+                }
+                case State::TX_COUNT:
+                {
+                    mNumTxns = ReadCompactSize(reader);
+                    uint64_t maxNumTxns { mPayloadLength / MIN_TRANSACTION_SIZE };
+                    if(mNumTxns > maxNumTxns)
+                    {
+                        throw std::ios_base::failure { "block transaction count exceeds payload size" };
+                    }
+                    // Both the count and the payload length come from the peer, so
+                    // only reserve for transactions that could fit in the bytes we
+                    // have actually received; vtx grows as more data arrives.
+                    uint64_t received { available - mParsePos - reader.GetBytesRead() };
+                    mBlock->vtx.reserve(std::min<uint64_t>(mNumTxns, received / MIN_TRANSACTION_SIZE));
+                    mState = (mNumTxns > 0)? State::TRANSACTIONS : State::COMPLETE;
+                    break;
+                }
+                case State::TRANSACTIONS:
+                {
+                    CTransactionRef txn {};
+                    reader >> txn;
+                    mMerkleRoot.Add(txn->GetId());
+                    mBlock->vtx.push_back(std::move(txn));
+                    if(mBlock->vtx.size() == mNumTxns)
+                    {
+                        bool mutated {false};
+                        uint256 merkleRoot { mMerkleRoot.GetRoot(&mutated) };
+                        mBlock->precomputedMerkleRoot = std::make_pair(merkleRoot, mutated);
+                        mState = State::COMPLETE;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+
+            mParsePos += reader.GetBytesRead();
+        }
+    }
+    catch(const NeedMoreData&)
+    {
+        // Wait until we have at least twice as much of the partial item
+        mNextAttemptSize = mParsePos + 2 * (available - mParsePos);
+    }
+    catch(const std::exception& e)
+    {
+        LogPrint(BCLog::NETMSG, "Streaming block parse stopped: %s\n", e.what());
+        mState = State::FAILED;
+        mBlock.reset();
+        return;
+    }
+
+    PrefetchInputs(force || mState == State::COMPLETE);
+}
+
+std::shared_ptr<CBlock> BlockStreamParser::TakeBlock()
+{
+    if(mState != State::COMPLETE)
+    {
+        return nullptr;
+    }
+
+    mState = State::FAILED;
+    return std::move(mBlock);
+}
+
+void BlockStreamParser::PrefetchInputs(bool force)
+{
+    if(!mPrefetch || !pcoinsTip)
+    {
+        return;
+    }
+
+    size_t numDecoded { mBlock->vtx.size() };
+    if(numDecoded == mNumPrefetched || (!force && numDecoded - mNumPrefetched < PREFETCH_BATCH_SIZE))
+    {
+        return;
+    }
+
+    // Inputs spending outputs from earlier batches of this block will just
+    // miss in the database
+    std::vector<CTransactionRef> batch { mBlock->vtx.begin() + mNumPrefetched, mBlock->vtx.end() };
+    pcoinsTip->PrefetchCoinsAsync(GetExternalInputs(batch));
+    mNumPrefetched = numDecoded;
+}
@@ -0,0 +1,75 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <consensus/merkle.h>
+#include <primitives/block.h>
+#include <streams.h>
+
+#include <cstdint>
+#include <memory>
+
+class Config;
+
+/**
+ * Decodes the payload of a block message while it is still arriving.
+ *
+ * Each time more payload data is received we decode as many further
+ * transactions as are now complete. Decoding a transaction computes its
+ * txid, which is then added to an incrementally calculated merkle root, and
+ * once the block header has been seen to carry valid proof of work the
+ * inputs of decoded transactions are handed to the coins database for
+ * prefetching. By the time the last byte arrives the block is ready to be
+ * passed straight to validation without deserialising it again, so network
+ * transfer and that CPU and IO work overlap.
+ *
+ * Decoding errors are never reported from here; we just stop and leave the
+ * complete message to be deserialised and rejected in the normal way.
+ */
+class BlockStreamParser
+{
+  public:
+    BlockStreamParser(int type, int version, uint64_t payloadLength);
+
+    // Decode whatever more we can from the payload received so far. Unless
+    // forced, attempts to finish a partially received transaction are backed
+    // off so that a large transaction doesn't get repeatedly re-parsed.
+    void Parse(const Config& config, const CDataStream& payload, bool force);
+
+    // Have we decoded the whole block?
+    bool Complete() const { return mState == State::COMPLETE; }
+
+    // Take the decoded block if we managed to decode all of it
+    std::shared_ptr<CBlock> TakeBlock();
+
+  private:
+
+    // Number of decoded transactions to batch up for each prefetch request
+    static constexpr size_t PREFETCH_BATCH_SIZE { 1000 };
+
+    enum class State { HEADER, TX_COUNT, TRANSACTIONS, COMPLETE, FAILED };
+
+    // Send inputs of recently decoded transactions for prefetching
+    void PrefetchInputs(bool force);
+
+    const int mType {0};
+    const int mVersion {0};
+    const uint64_t mPayloadLength {0};
+
+    State mState { State::HEADER };
+
+    // Offset of the next item to decode within the payload, and payload size
+    // to wait for before trying again after running out of data
+    size_t mParsePos {0};
+    size_t mNextAttemptSize {0};
+
+    std::shared_ptr<CBlock> mBlock { std::make_shared<CBlock>() };
+    uint64_t mNumTxns {0};
+    CIncrementalMerkleRoot mMerkleRoot {};
+
+    // Whether to prefetch inputs, and how many transactions we've done so far
+    bool mPrefetch {false};
+    size_t mNumPrefetched {0};
+};
@@ -42,8 +42,10 @@
 #include <miniupnpc/upnperrors.h>
 #endif
 
+#include <algorithm>
 #include <cmath>
 #include <optional>
+#include <set>
 #include <utility>
 
 #include <boost/algorithm/string.hpp>
@@ -1017,6 +1019,23 @@ void CNode::ServiceSockets(fd_set& setRecv, fd_set& setSend, fd_set& setError, C
         connman.WakeMessageHandler();
     }
 
+    CheckInactivity(config);
+}
+
+void CNode::ServiceSocketEvents(CConnman& connman, const Config& config, uint64_t& bytesRecv,
+                                uint64_t& bytesSent)
+{
+    // Let association service its sockets
+    bool newMsgs {false};
+    mAssociation.ServiceSocketEvents(connman, config, newMsgs, bytesRecv, bytesSent);
+    if(newMsgs)
+    {
+        connman.WakeMessageHandler();
+    }
+}
+
+void CNode::CheckInactivity(const Config& config)
+{
     //
     // Inactivity checking
     //
@@ -1348,10 +1367,30 @@ void CConnman::AcceptConnection(const ListenSocket &hListenSocket) {
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
     }
+    RegisterSocketEvents(pnode);
+}
+
+void CConnman::RegisterSocketEvents(const CNodePtr& pnode) {
+    if (mNetworkWorkers.empty()) {
+        return;
+    }
+
+    // Give the peer to the worker with the fewest streams
+    auto worker = std::min_element(mNetworkWorkers.begin(), mNetworkWorkers.end(),
+        [](const auto& w1, const auto& w2) {
+            return w1->GetEventLoop().GetNumStreams() < w2->GetEventLoop().GetNumStreams();
+        }
+    );
+    if (!pnode->GetAssociation().RegisterSocketEvents((*worker)->GetEventLoop())) {
+        // We would never hear from this peer again
+        LogPrint(BCLog::NETCONN, "failed to watch socket events for peer=%d, disconnecting\n", pnode->GetId());
+        pnode->fDisconnect = true;
+    }
 }
 
 void CConnman::ThreadSocketHandler() {
     unsigned int nPrevNodeCount = 0;
+    int64_t nLastInactivityCheck = 0;
     while (!interruptNet) {
         //
         // Disconnect nodes
@@ -1419,6 +1458,13 @@ void CConnman::ThreadSocketHandler() {
             }
         }
 
+        if (!mNetworkWorkers.empty()) {
+            // We are also the first network worker
+            ServiceSocketEvents(*mNetworkWorkers.front());
+            CheckInactivity(nLastInactivityCheck);
+            continue;
+        }
+
         //
         // Find which sockets have data to receive
         //
@@ -1509,6 +1555,115 @@ void CConnman::ThreadSocketHandler() {
     }
 }
 
+void CConnman::ThreadNetworkWorker(NetworkWorker& worker) {
+    while (!interruptNet) {
+        ServiceSocketEvents(worker);
+    }
+}
+
+void CConnman::ServiceSocketEvents(NetworkWorker& worker) {
+    // Wait for socket events, timing out periodically so that disconnected
+    // nodes are still cleaned up when nothing happens on the network
+    std::vector<SOCKET> readyListenSockets {};
+    std::vector<StreamPtr> readyStreams {
+        worker.GetEventLoop().Wait(std::chrono::milliseconds(50), readyListenSockets) };
+    if (interruptNet) {
+        return;
+    }
+    int64_t nStartTime { GetTimeMicros() };
+    uint64_t workerBytesRecv {0};
+    uint64_t workerBytesSent {0};
+
+    //
+    // Accept new connections
+    //
+    for (const ListenSocket &hListenSocket : vhListenSocket) {
+        if (hListenSocket.socket != INVALID_SOCKET &&
+            std::find(readyListenSockets.begin(), readyListenSockets.end(),
+                      hListenSocket.socket) != readyListenSockets.end()) {
+            AcceptConnection(hListenSocket);
+        }
+    }
+
+    //
+    // Service nodes with ready streams (a node can have several)
+    //
+    std::set<CNodePtr> readyNodes {};
+    for (const StreamPtr& stream : readyStreams) {
+        CNodePtr pnode { stream->GetOwningNode() };
+        if (pnode) {
+            readyNodes.insert(std::move(pnode));
+        }
+    }
+    for (const CNodePtr& pnode : readyNodes) {
+        if (interruptNet) {
+            return;
+        }
+
+        uint64_t bytesRecv {0};
+        uint64_t bytesSent {0};
+        pnode->ServiceSocketEvents(*this, *config, bytesRecv, bytesSent);
+
+        if(bytesRecv > 0) {
+            RecordBytesRecv(bytesRecv);
+        }
+        if(bytesSent > 0) {
+            RecordBytesSent(bytesSent);
+        }
+        workerBytesRecv += bytesRecv;
+        workerBytesSent += bytesSent;
+    }
+
+    worker.RecordWakeup(GetTimeMicros() - nStartTime, workerBytesRecv, workerBytesSent);
+}
+
+bool CConnman::CreateNetworkWorkers() {
+    int numWorkers { static_cast<int>(gArgs.GetArg("-networkworkers", DEFAULT_NETWORK_WORKERS)) };
+    if (numWorkers <= 0) {
+        numWorkers = std::clamp(static_cast<int>(std::thread::hardware_concurrency()) / 4,
+                                1, MAX_AUTO_NETWORK_WORKERS);
+    }
+    numWorkers = std::min(numWorkers, MAX_NETWORK_WORKERS);
+
+    for (int i = 0; i < numWorkers; ++i) {
+        std::unique_ptr<SocketEventLoop> eventLoop { SocketEventLoop::Make() };
+        if (!eventLoop) {
+            mNetworkWorkers.clear();
+            return false;
+        }
+        mNetworkWorkers.push_back(std::make_unique<NetworkWorker>(i, std::move(eventLoop)));
+    }
+
+    // Incoming connections are accepted by the first worker which runs on
+    // the socket handler thread
+    for (const ListenSocket &hListenSocket : vhListenSocket) {
+        if (!mNetworkWorkers.front()->GetEventLoop().AddListenSocket(hListenSocket.socket)) {
+            mNetworkWorkers.clear();
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void CConnman::CheckInactivity(int64_t& nLastInactivityCheck) {
+    // Inactivity checking doesn't depend on socket events and has a
+    // resolution of seconds so there is no need to do it on every wakeup
+    int64_t nTime { GetSystemTimeInSeconds() };
+    if (nTime != nLastInactivityCheck) {
+        nLastInactivityCheck = nTime;
+
+        std::vector<CNodePtr> vNodesCopy;
+        {
+            LOCK(cs_vNodes);
+            vNodesCopy = vNodes;
+        }
+        for (const CNodePtr& pnode : vNodesCopy) {
+            pnode->CheckInactivity(*config);
+        }
+    }
+}
+
 void CConnman::WakeMessageHandler() {
     {
         std::lock_guard<std::mutex> lock(mutexMsgProc);
@@ -2121,6 +2276,7 @@ bool CConnman::OpenNetworkConnection(NodeConnectInfo& connectInfo,
         LOCK(cs_vNodes);
         vNodes.push_back(pnode);
     }
+    RegisterSocketEvents(pnode);
 
     return true;
 }
@@ -2523,6 +2679,26 @@ bool CConnman::Start(CScheduler &scheduler, std::string &strNodeError,
         semAddnode = std::make_shared<CSemaphore>(nMaxAddnode);
     }
 
+    fStreamBlockParsing = gArgs.GetBoolArg("-streamblockparsing", DEFAULT_STREAM_BLOCK_PARSING);
+
+    // Choose how we wait for socket events
+    std::string socketEvents { gArgs.GetArg("-socketevents", DEFAULT_SOCKET_EVENTS) };
+    if (socketEvents == "epoll") {
+        if (!CreateNetworkWorkers()) {
+            LogPrintf("epoll socket events unavailable, falling back to select\n");
+        }
+    }
+    else if (socketEvents != "select") {
+        strNodeError = strprintf(_("Unknown socket events mode: '%s'"), socketEvents);
+        return false;
+    }
+    if (mNetworkWorkers.empty()) {
+        LogPrintf("Using select for socket events\n");
+    }
+    else {
+        LogPrintf("Using epoll for socket events with %d network workers\n", mNetworkWorkers.size());
+    }
+
     //
     // Start threads
     //
@@ -2540,6 +2716,14 @@ bool CConnman::Start(CScheduler &scheduler, std::string &strNodeError,
         &TraceThread<std::function<void()>>, "net",
         std::function<void()>(std::bind(&CConnman::ThreadSocketHandler, this)));
 
+    // Additional network workers
+    for (size_t i = 1; i < mNetworkWorkers.size(); ++i) {
+        NetworkWorker& worker { *mNetworkWorkers[i] };
+        threadNetworkWorkers.emplace_back(
+            &TraceThread<std::function<void()>>, worker.GetName().c_str(),
+            std::function<void()>(std::bind(&CConnman::ThreadNetworkWorker, this, std::ref(worker))));
+    }
+
     if (!gArgs.GetBoolArg("-dnsseed", true)) {
         LogPrintf("DNS seeding disabled\n");
     } else {
@@ -2612,6 +2796,9 @@ void CConnman::Interrupt() {
     condMsgProc.notify_all();
 
     interruptNet();
+    for (const auto& worker : mNetworkWorkers) {
+        worker->GetEventLoop().Interrupt();
+    }
     InterruptSocks5(true);
 
     if (semOutbound) {
@@ -2646,6 +2833,12 @@ void CConnman::Stop() {
     if (threadSocketHandler.joinable()) {
         threadSocketHandler.join();
     }
+    for (std::thread& thread : threadNetworkWorkers) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    threadNetworkWorkers.clear();
 
     if (fAddressesInitialized) {
         DumpData();
@@ -2682,6 +2875,7 @@ void CConnman::Stop() {
     vNodes.clear();
     vNodesDisconnected.clear();
     vhListenSocket.clear();
+    mNetworkWorkers.clear();
     semOutbound = nullptr;
     semAddnode = nullptr;
 }
@@ -2778,6 +2972,15 @@ void CConnman::GetNodeStats(std::vector<NodeStats> &vstats) {
     }
 }
 
+void CConnman::GetNetworkWorkerStats(std::vector<NetworkWorkerStats> &vstats) const {
+    vstats.clear();
+    vstats.reserve(mNetworkWorkers.size());
+    for (const auto& worker : mNetworkWorkers) {
+        vstats.emplace_back();
+        worker->CopyStats(vstats.back());
+    }
+}
+
 bool CConnman::DisconnectNode(const std::string &strNode) {
     LOCK(cs_vNodes);
     if (const CNodePtr& pnode = FindNode(strNode)) {
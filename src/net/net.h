@@ -19,6 +19,7 @@
 #include "net/association.h"
 #include "net/net_message.h"
 #include "net/net_types.h"
+#include "net/network_worker.h"
 #include "net/node_stats.h"
 #include "net/stream_policy_factory.h"
 #include "netaddress.h"
@@ -152,6 +153,20 @@ static const size_t DEFAULT_MAX_BLOCK_PARALLEL_FETCH = 3;
  */
 constexpr size_t DEFAULT_NODE_ASYNC_TASKS_LIMIT = 3;
 
+// Default mechanism the socket handler thread uses to wait for socket events
+#ifdef __linux__
+static const std::string DEFAULT_SOCKET_EVENTS = "epoll";
+#else
+static const std::string DEFAULT_SOCKET_EVENTS = "select";
+#endif
+// Default number of network worker threads (0 = one per 4 cores, up to MAX_AUTO_NETWORK_WORKERS)
+static const int DEFAULT_NETWORK_WORKERS = 0;
+static const int MAX_AUTO_NETWORK_WORKERS = 8;
+// Maximum number of network worker threads
+static const int MAX_NETWORK_WORKERS = 64;
+// Default for whether to decode block messages while they are still arriving
+static const bool DEFAULT_STREAM_BLOCK_PARSING = false;
+
 struct AddedNodeInfo {
     std::string strAddedNode;
     CService resolvedAddress;
@@ -503,10 +518,12 @@ public:
 
     size_t GetNodeCount(NumConnections num);
     void GetNodeStats(std::vector<NodeStats> &vstats);
+    void GetNetworkWorkerStats(std::vector<NetworkWorkerStats> &vstats) const;
     bool DisconnectNode(const std::string &node);
     bool DisconnectNode(NodeId id);
 
     unsigned int GetSendBufferSize() const;
+    bool GetStreamBlockParsing() const { return fStreamBlockParsing; }
 
     void AddWhitelistedRange(const CSubNet &subnet);
 
@@ -618,6 +635,11 @@ private:
     void ThreadMessageHandler();
     void AcceptConnection(const ListenSocket &hListenSocket);
     void ThreadSocketHandler();
+    void ThreadNetworkWorker(NetworkWorker& worker);
+    void ServiceSocketEvents(NetworkWorker& worker);
+    void CheckInactivity(int64_t& nLastInactivityCheck);
+    bool CreateNetworkWorkers();
+    void RegisterSocketEvents(const CNodePtr& pnode);
     void ThreadDNSAddressSeed();
 
     uint64_t CalculateKeyedNetGroup(const CAddress &ad) const;
@@ -676,8 +698,12 @@ private:
 
     unsigned int nSendBufferMaxSize;
     unsigned int nReceiveFloodSize;
+    std::atomic_bool fStreamBlockParsing {DEFAULT_STREAM_BLOCK_PARSING};
 
     std::vector<ListenSocket> vhListenSocket;
+    // Workers servicing sockets with their own event loops instead of
+    // select(); the first one runs on the socket handler thread
+    std::vector<std::unique_ptr<NetworkWorker>> mNetworkWorkers {};
     std::atomic<bool> fNetworkActive;
     banmap_t setBanned;
     CCriticalSection cs_setBanned;
@@ -748,6 +774,7 @@ private:
     std::thread threadOpenConnections;
     std::thread threadOpenNewStreamConnections;
     std::thread threadMessageHandler;
+    std::vector<std::thread> threadNetworkWorkers;
 
     std::chrono::milliseconds mDebugP2PTheadStallsThreshold;
 
@@ -1060,6 +1087,8 @@ public:
     bool SetSocketsForSelect(fd_set& setRecv, fd_set& setSend, fd_set& setError, SOCKET& socketMax) const;
     void ServiceSockets(fd_set& setRecv, fd_set& setSend, fd_set& setError, CConnman& connman,
                         const Config& config, uint64_t& bytesRecv, uint64_t& bytesSent);
+    void ServiceSocketEvents(CConnman& connman, const Config& config, uint64_t& bytesRecv, uint64_t& bytesSent);
+    void CheckInactivity(const Config& config);
 
     bool GetDisconnect() const { return fDisconnect; }
     bool GetPausedForSending(bool checkPauseRecv = false);
@@ -3,8 +3,73 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <net/net_message.h>
+#include <net/block_stream_parser.h>
 #include <logging.h>
 
+CSerializeData CNetMessageBufferPool::Get()
+{
+    std::lock_guard<std::mutex> lock { mMtx };
+    if(mBuffers.empty())
+    {
+        return {};
+    }
+
+    CSerializeData buffer { std::move(mBuffers.back()) };
+    mBuffers.pop_back();
+    ++mNumReused;
+    return buffer;
+}
+
+void CNetMessageBufferPool::Return(CSerializeData&& buffer)
+{
+    // Don't keep hold of buffers that aren't worth reusing, or that would
+    // pin a lot of memory after some large message
+    if(buffer.capacity() == 0 || buffer.capacity() > MAX_POOLED_BUFFER_SIZE)
+    {
+        return;
+    }
+
+    buffer.clear();
+    std::lock_guard<std::mutex> lock { mMtx };
+    if(mBuffers.size() < MAX_POOLED_BUFFERS)
+    {
+        mBuffers.push_back(std::move(buffer));
+    }
+}
+
+CNetMessage::CNetMessage(const CMessageHeader::MessageMagic& pchMessageStartIn, int nTypeIn,
+                         int nVersionIn, const CNetMessageBufferPoolPtr& pool)
+: dataBuff { nTypeIn, nVersionIn },
+  hdr { pchMessageStartIn },
+  bufferPool { pool }
+{
+    if(bufferPool)
+    {
+        CSerializeData buffer { bufferPool->Get() };
+        dataBuff.SwapBuffer(buffer);
+    }
+}
+
+CNetMessage::~CNetMessage()
+{
+    if(bufferPool)
+    {
+        CSerializeData buffer {};
+        dataBuff.SwapBuffer(buffer);
+        bufferPool->Return(std::move(buffer));
+    }
+}
+
+void CNetMessage::ReservePayload(uint64_t nBytes)
+{
+    if(nBytes > dataBuff.capacity())
+    {
+        // Growing the buffer means moving whatever we already have
+        nBytesCopied += dataBuff.size();
+        dataBuff.reserve(nBytes);
+    }
+}
+
 uint64_t CNetMessage::Read(const Config& config, const char* pch, uint64_t nBytes)
 {
     // Still reading header?
@@ -20,6 +85,15 @@ uint64_t CNetMessage::Read(const Config& config, const char* pch, uint64_t nByte
                 {
                     throw BanPeer { "Oversized header detected" };
                 }
+
+                // Size our buffer for the payload up front
+                ReservePayload(std::min(hdr.GetPayloadLength(), MAX_INITIAL_PAYLOAD_RESERVE));
+
+                if(fStreamBlockParsing && hdr.GetCommand() == NetMsgType::BLOCK)
+                {
+                    blockParser = std::make_unique<BlockStreamParser>(dataBuff.GetType(),
+                        dataBuff.GetVersion(), hdr.GetPayloadLength());
+                }
             }
 
             return numRead;
@@ -33,6 +107,12 @@ uint64_t CNetMessage::Read(const Config& config, const char* pch, uint64_t nByte
     // Read payload data
     uint64_t nRemaining { hdr.GetPayloadLength() - dataBuff.size() };
     uint64_t nCopy { std::min(nRemaining, nBytes) };
+    if(dataBuff.size() + nCopy > dataBuff.capacity())
+    {
+        // Grow geometrically, but never beyond the advertised payload length
+        uint64_t nRequired { dataBuff.size() + nCopy };
+        ReservePayload(std::min(hdr.GetPayloadLength(), std::max(nRequired, 2 * dataBuff.capacity())));
+    }
     dataBuff.write(pch, nCopy);
 
     // No need to calculate message hash for extended format msgs
@@ -41,6 +121,12 @@ uint64_t CNetMessage::Read(const Config& config, const char* pch, uint64_t nByte
         hasher.Write(reinterpret_cast<const uint8_t*>(pch), nCopy);
     }
 
+    // Decode as much more of a block as we can
+    if(blockParser)
+    {
+        blockParser->Parse(config, dataBuff, Complete());
+    }
+
     return nCopy;
 }
 
@@ -53,6 +139,15 @@ const uint256& CNetMessage::GetMessageHash() const
     return data_hash;
 }
 
+std::shared_ptr<CBlock> CNetMessage::TakeStreamedBlock()
+{
+    if(blockParser)
+    {
+        return blockParser->TakeBlock();
+    }
+    return nullptr;
+}
+
 // Header length + payload length
 uint64_t CNetMessage::GetTotalLength() const
 {
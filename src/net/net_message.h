@@ -8,7 +8,48 @@
 #include <protocol.h>
 #include <streams.h>
 
+#include <atomic>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <vector>
+
+/**
+ * A small pool of previously used receive buffers.
+ *
+ * Each stream owns a pool which the messages it creates draw their payload
+ * buffers from and hand them back to once they have been processed, so that
+ * steady tx/inv traffic reuses the same allocations rather than going back
+ * to the heap for every message. Messages keep a reference to the pool and
+ * so may safely outlive the stream that created them.
+ */
+class CNetMessageBufferPool
+{
+  public:
+    // Largest buffer capacity we will hold on to for reuse
+    static constexpr size_t MAX_POOLED_BUFFER_SIZE { 256 * 1024 };
+    // Maximum number of buffers held in the pool
+    static constexpr size_t MAX_POOLED_BUFFERS { 4 };
+
+    // Get an empty buffer, reusing a previously returned one if we can
+    CSerializeData Get();
+
+    // Give a buffer back to the pool
+    void Return(CSerializeData&& buffer);
+
+    // Number of buffer requests satisfied from the pool
+    uint64_t GetNumReused() const { return mNumReused; }
+
+  private:
+    std::vector<CSerializeData> mBuffers {};
+    std::mutex mMtx {};
+
+    std::atomic<uint64_t> mNumReused {0};
+};
+using CNetMessageBufferPoolPtr = std::shared_ptr<CNetMessageBufferPool>;
+
+class BlockStreamParser;
+class CBlock;
 
 class CNetMessage {
 private:
@@ -24,12 +65,33 @@ private:
     // Time (in microseconds) of message receipt.
     int64_t nTime {0};
 
+    // Pool our buffer came from and will be returned to (if any)
+    CNetMessageBufferPoolPtr bufferPool {nullptr};
+
+    // Number of already received payload bytes we have had to move while
+    // growing our buffer
+    uint64_t nBytesCopied {0};
+
+    // Whether to decode block messages as they arrive, and the parser doing
+    // it for this message if so
+    bool fStreamBlockParsing {false};
+    std::unique_ptr<BlockStreamParser> blockParser {nullptr};
+
+    // Reserve buffer space for the payload once we know how big it is
+    void ReservePayload(uint64_t nBytes);
+
 public:
-    CNetMessage(const CMessageHeader::MessageMagic& pchMessageStartIn, int nTypeIn, int nVersionIn)
-    : dataBuff { nTypeIn, nVersionIn },
-      hdr { pchMessageStartIn }
-    {
-    }
+    // Amount of payload space reserved up front when the header arrives.
+    // Larger payloads grow geometrically from here as their data arrives, so
+    // a peer can't make us allocate much more than it has actually sent.
+    static constexpr uint64_t MAX_INITIAL_PAYLOAD_RESERVE { 1024 * 1024 };
+
+    CNetMessage(const CMessageHeader::MessageMagic& pchMessageStartIn, int nTypeIn, int nVersionIn,
+                const CNetMessageBufferPoolPtr& pool = nullptr);
+    ~CNetMessage();
+
+    CNetMessage(const CNetMessage&) = delete;
+    CNetMessage& operator=(const CNetMessage&) = delete;
 
     bool Complete() const {
         if (!hdr.Complete()) {
@@ -45,6 +107,13 @@ public:
     void SetTime(int64_t time) { nTime = time; }
     CDataStream& GetData() { return dataBuff; }
     uint64_t GetTotalLength() const;
+    uint64_t GetBytesCopied() const { return nBytesCopied; }
+
+    // Enable decoding of a block message payload while it is still arriving
+    void SetStreamBlockParsing(bool enable) { fStreamBlockParsing = enable; }
+
+    // Get the block decoded while this message was arriving, if there was one
+    std::shared_ptr<CBlock> TakeStreamedBlock();
 
     void SetVersion(int nVersionIn) {
         dataBuff.SetVersion(nVersionIn);
@@ -556,7 +556,7 @@ private:
 // Forward declarion of ProcessMessage
 static bool ProcessMessage(const Config& config, const CNodePtr& pfrom, const std::string& strCommand,
     CDataStream& vRecv, int64_t nTimeReceived, const CChainParams& chainparams, CConnman& connman,
-    const std::atomic<bool>& interruptMsgProc);
+    const std::atomic<bool>& interruptMsgProc, const std::shared_ptr<CBlock>& streamedBlock);
 
 bool GetNodeStateStats(NodeId nodeid, CNodeStateStats &stats) {
     // Try to obtain an access to the node's state data.
@@ -3062,10 +3062,15 @@ static bool ProcessCompactBlockMessage(const Config& config, const CNodePtr& pfr
 * Process block message.
 */
 static void ProcessBlockMessage(const Config& config, const CNodePtr& pfrom, CDataStream& vRecv,
-    CConnman& connman)
+    CConnman& connman, const std::shared_ptr<CBlock>& streamedBlock)
 {
-    std::shared_ptr<CBlock> pblock = std::make_shared<CBlock>();
-    vRecv >> *pblock;
+    // Use the block already decoded while it was arriving if we have it
+    std::shared_ptr<CBlock> pblock { streamedBlock };
+    if(!pblock)
+    {
+        pblock = std::make_shared<CBlock>();
+        vRecv >> *pblock;
+    }
 
     LogPrint(BCLog::NETMSG, "received block %s peer=%d\n", pblock->GetHash().ToString(), pfrom->id);
 
@@ -3614,7 +3619,8 @@ static bool ProcessMessage(const Config& config, const CNodePtr& pfrom,
                            const std::string& strCommand, CDataStream& vRecv,
                            int64_t nTimeReceived,
                            const CChainParams& chainparams, CConnman& connman,
-                           const std::atomic<bool>& interruptMsgProc)
+                           const std::atomic<bool>& interruptMsgProc,
+                           const std::shared_ptr<CBlock>& streamedBlock)
 {
     LogPrint(BCLog::NETMSGVERB, "received: %s (%u bytes) peer=%d\n",
              SanitizeString(strCommand), vRecv.size(), pfrom->id);
@@ -3724,7 +3730,7 @@ static bool ProcessMessage(const Config& config, const CNodePtr& pfrom,
 
     // Ignore blocks received while importing
     else if (strCommand == NetMsgType::BLOCK && !fImporting && !fReindex) {
-        ProcessBlockMessage(config, pfrom, vRecv, connman);
+        ProcessBlockMessage(config, pfrom, vRecv, connman, streamedBlock);
     }
 
     // Ignore double-spend detected notifications while importing
@@ -3951,7 +3957,7 @@ bool ProcessMessages(const Config &config, const CNodePtr& pfrom, CConnman &conn
     bool fRet = false;
     try {
         fRet = ProcessMessage(config, pfrom, strCommand, msg.GetData(), msg.GetTime(),
-                              chainparams, connman, interruptMsgProc);
+                              chainparams, connman, interruptMsgProc, msg.TakeStreamedBlock());
         if (interruptMsgProc) {
             return false;
         }
@@ -0,0 +1,33 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <net/net.h>
+#include <net/network_worker.h>
+#include <tinyformat.h>
+
+#include <cassert>
+
+NetworkWorker::NetworkWorker(size_t id, std::unique_ptr<SocketEventLoop> eventLoop)
+: mId{id}, mName{strprintf("net%d", id)}, mEventLoop{std::move(eventLoop)}
+{
+    assert(mEventLoop);
+}
+
+void NetworkWorker::RecordWakeup(int64_t busyMicros, uint64_t bytesRecv, uint64_t bytesSent)
+{
+    ++mWakeups;
+    mBusyMicros += busyMicros;
+    mBytesRecv += bytesRecv;
+    mBytesSent += bytesSent;
+}
+
+void NetworkWorker::CopyStats(NetworkWorkerStats& stats) const
+{
+    stats.id = mId;
+    stats.nStreams = mEventLoop->GetNumStreams();
+    stats.nWakeups = mWakeups;
+    stats.nBusyMicros = mBusyMicros;
+    stats.nRecvBytes = mBytesRecv;
+    stats.nSendBytes = mBytesSent;
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <net/socket_event_loop.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+class NetworkWorkerStats;
+
+/**
+ * A network worker services the sockets of a shard of peer streams that are
+ * registered with its own event loop.
+ *
+ * Streams are spread over the workers as they are connected so that reading,
+ * message framing and writing for different peers can run in parallel on
+ * different cores.
+ */
+class NetworkWorker
+{
+  public:
+    NetworkWorker(size_t id, std::unique_ptr<SocketEventLoop> eventLoop);
+
+    NetworkWorker(const NetworkWorker&) = delete;
+    NetworkWorker& operator=(const NetworkWorker&) = delete;
+    NetworkWorker(NetworkWorker&&) = delete;
+    NetworkWorker& operator=(NetworkWorker&&) = delete;
+
+    // Get our ID and thread name
+    size_t GetId() const { return mId; }
+    const std::string& GetName() const { return mName; }
+
+    // Get our event loop
+    SocketEventLoop& GetEventLoop() { return *mEventLoop; }
+
+    // Record work done after a wakeup
+    void RecordWakeup(int64_t busyMicros, uint64_t bytesRecv, uint64_t bytesSent);
+
+    // Copy out our stats
+    void CopyStats(NetworkWorkerStats& stats) const;
+
+  private:
+    const size_t mId {0};
+    const std::string mName {};
+    const std::unique_ptr<SocketEventLoop> mEventLoop {nullptr};
+
+    // Load stats
+    std::atomic<uint64_t> mWakeups {0};
+    std::atomic<int64_t> mBusyMicros {0};
+    std::atomic<uint64_t> mBytesRecv {0};
+    std::atomic<uint64_t> mBytesSent {0};
+};
@@ -14,6 +14,8 @@ public:
     int64_t nLastRecv;
     uint64_t nSendBytes;
     uint64_t nRecvBytes;
+    uint64_t nRecvBytesCopied;
+    uint64_t nRecvBuffersReused;
     uint64_t nSendSize;
     uint64_t nRecvSize;
     uint64_t nSpotBytesPerSec;
@@ -68,3 +70,14 @@ public:
 
     AssociationStats associationStats;
 };
+
+class NetworkWorkerStats
+{
+public:
+    size_t id;
+    size_t nStreams;
+    uint64_t nWakeups;
+    int64_t nBusyMicros;
+    uint64_t nSendBytes;
+    uint64_t nRecvBytes;
+};
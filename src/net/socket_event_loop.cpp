@@ -0,0 +1,275 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <net/netbase.h>
+#include <net/socket_event_loop.h>
+#include <net/stream.h>
+#include <logging.h>
+
+#include <algorithm>
+
+#ifdef __linux__
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+namespace
+{
+    // Listening sockets are told apart from streams by the lowest bit of the
+    // event data (stream pointers are aligned), the wakeup descriptor uses 0.
+    constexpr uint64_t WAKEUP_EVENT_DATA {0};
+    constexpr uint64_t LISTEN_SOCKET_TAG {1};
+
+    uint64_t ListenSocketEventData(SOCKET socket)
+    {
+        return (static_cast<uint64_t>(socket) << 1) | LISTEN_SOCKET_TAG;
+    }
+}
+
+std::unique_ptr<SocketEventLoop> SocketEventLoop::Make()
+{
+    int epollFd { epoll_create1(EPOLL_CLOEXEC) };
+    if(epollFd == -1)
+    {
+        LogPrintf("epoll_create1 failed: %s\n", NetworkErrorString(errno));
+        return nullptr;
+    }
+
+    int wakeupFd { eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK) };
+    if(wakeupFd == -1)
+    {
+        LogPrintf("eventfd failed: %s\n", NetworkErrorString(errno));
+        close(epollFd);
+        return nullptr;
+    }
+
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = WAKEUP_EVENT_DATA;
+    if(epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeupFd, &event) == -1)
+    {
+        LogPrintf("Failed to watch event loop wakeup descriptor: %s\n", NetworkErrorString(errno));
+        close(wakeupFd);
+        close(epollFd);
+        return nullptr;
+    }
+
+    return std::unique_ptr<SocketEventLoop>{ new SocketEventLoop{epollFd, wakeupFd} };
+}
+
+SocketEventLoop::SocketEventLoop(int epollFd, int wakeupFd)
+: mEpollFd{epollFd}, mWakeupFd{wakeupFd}
+{}
+
+SocketEventLoop::~SocketEventLoop()
+{
+    close(mWakeupFd);
+    close(mEpollFd);
+}
+
+bool SocketEventLoop::AddListenSocket(SOCKET socket)
+{
+    // Level triggered as we accept a single connection per wakeup
+    epoll_event event {};
+    event.events = EPOLLIN;
+    event.data.u64 = ListenSocketEventData(socket);
+    if(epoll_ctl(mEpollFd, EPOLL_CTL_ADD, socket, &event) == -1)
+    {
+        LogPrintf("Failed to watch listening socket: %s\n", NetworkErrorString(errno));
+        return false;
+    }
+
+    return true;
+}
+
+bool SocketEventLoop::Register(SOCKET socket, const std::shared_ptr<Stream>& stream)
+{
+    std::lock_guard lock { mMtx };
+
+    // Registering a socket that is already readable or writable reports that
+    // straight away so nothing received before registration is missed
+    epoll_event event {};
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = stream.get();
+    if(epoll_ctl(mEpollFd, EPOLL_CTL_ADD, socket, &event) == -1)
+    {
+        LogPrintf("Failed to watch stream socket: %s\n", NetworkErrorString(errno));
+        return false;
+    }
+
+    mStreams[stream.get()] = stream;
+    return true;
+}
+
+void SocketEventLoop::Deregister(SOCKET socket, Stream* stream)
+{
+    std::lock_guard lock { mMtx };
+
+    // Explicit removal is required even if the socket is about to be closed as
+    // the registration lives until all duplicates of the descriptor (e.g.
+    // inherited by child processes) are closed
+    epoll_ctl(mEpollFd, EPOLL_CTL_DEL, socket, nullptr);
+
+    mStreams.erase(stream);
+    mActive.erase(stream);
+    mDeferred.erase(stream);
+}
+
+void SocketEventLoop::Activate(Stream* stream, bool immediate)
+{
+    std::lock_guard lock { mMtx };
+
+    if(mStreams.count(stream) == 0)
+    {
+        // Already deregistered
+        return;
+    }
+
+    if(immediate)
+    {
+        if(mActive.insert(stream).second && mWaiting)
+        {
+            WakeUp();
+        }
+    }
+    else if(mActive.count(stream) == 0)
+    {
+        mDeferred.insert(stream);
+    }
+}
+
+std::vector<std::shared_ptr<Stream>> SocketEventLoop::Wait(std::chrono::milliseconds timeout,
+                                                            std::vector<SOCKET>& readyListenSockets)
+{
+    {
+        std::lock_guard lock { mMtx };
+        if(!mActive.empty())
+        {
+            timeout = std::chrono::milliseconds::zero();
+        }
+        else if(!mDeferred.empty())
+        {
+            timeout = std::min(timeout, DEFERRED_POLL_INTERVAL);
+        }
+        mWaiting = true;
+    }
+
+    epoll_event events[MAX_EVENTS];
+    int numEvents { epoll_wait(mEpollFd, events, MAX_EVENTS, static_cast<int>(timeout.count())) };
+    if(numEvents == -1)
+    {
+        if(errno != EINTR)
+        {
+            LogPrint(BCLog::NETCONN, "epoll_wait error %s\n", NetworkErrorString(errno));
+        }
+        numEvents = 0;
+    }
+
+    std::unordered_set<Stream*> ready {};
+    std::vector<std::pair<std::shared_ptr<Stream>, uint32_t>> streamEvents {};
+    std::vector<std::shared_ptr<Stream>> readyStreams {};
+    {
+        std::lock_guard lock { mMtx };
+        mWaiting = false;
+
+        ready.swap(mActive);
+        ready.merge(mDeferred);
+        mDeferred.clear();
+
+        for(int i = 0; i < numEvents; ++i)
+        {
+            const epoll_event& event { events[i] };
+            if(event.data.u64 == WAKEUP_EVENT_DATA)
+            {
+                uint64_t value {0};
+                [[maybe_unused]] ssize_t res { read(mWakeupFd, &value, sizeof(value)) };
+            }
+            else if(event.data.u64 & LISTEN_SOCKET_TAG)
+            {
+                readyListenSockets.push_back(static_cast<SOCKET>(event.data.u64 >> 1));
+            }
+            else
+            {
+                // Events may still be pending for a stream deregistered in the meantime
+                const auto it { mStreams.find(static_cast<Stream*>(event.data.ptr)) };
+                if(it != mStreams.end())
+                {
+                    std::shared_ptr<Stream> stream { it->second.lock() };
+                    if(stream)
+                    {
+                        streamEvents.emplace_back(std::move(stream), event.events);
+                    }
+                    ready.erase(it->first);
+                }
+            }
+        }
+
+        for(Stream* stream : ready)
+        {
+            const auto it { mStreams.find(stream) };
+            if(it != mStreams.end())
+            {
+                std::shared_ptr<Stream> streamPtr { it->second.lock() };
+                if(streamPtr)
+                {
+                    readyStreams.push_back(std::move(streamPtr));
+                }
+            }
+        }
+    }
+
+    // Readiness is updated without holding our lock as streams call us with
+    // their own locks held
+    for(auto& [stream, events] : streamEvents)
+    {
+        stream->SetSocketReady(
+            events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR),
+            events & (EPOLLOUT | EPOLLHUP | EPOLLERR));
+        readyStreams.push_back(std::move(stream));
+    }
+
+    return readyStreams;
+}
+
+size_t SocketEventLoop::GetNumStreams() const
+{
+    std::lock_guard lock { mMtx };
+    return mStreams.size();
+}
+
+void SocketEventLoop::Interrupt()
+{
+    std::lock_guard lock { mMtx };
+    WakeUp();
+}
+
+void SocketEventLoop::WakeUp()
+{
+    uint64_t value {1};
+    [[maybe_unused]] ssize_t res { write(mWakeupFd, &value, sizeof(value)) };
+}
+
+#else
+
+std::unique_ptr<SocketEventLoop> SocketEventLoop::Make()
+{
+    return nullptr;
+}
+
+SocketEventLoop::SocketEventLoop(int epollFd, int wakeupFd)
+: mEpollFd{epollFd}, mWakeupFd{wakeupFd}
+{}
+
+SocketEventLoop::~SocketEventLoop() = default;
+
+bool SocketEventLoop::AddListenSocket(SOCKET) { return false; }
+bool SocketEventLoop::Register(SOCKET, const std::shared_ptr<Stream>&) { return false; }
+void SocketEventLoop::Deregister(SOCKET, Stream*) {}
+void SocketEventLoop::Activate(Stream*, bool) {}
+std::vector<std::shared_ptr<Stream>> SocketEventLoop::Wait(std::chrono::milliseconds, std::vector<SOCKET>&) { return {}; }
+size_t SocketEventLoop::GetNumStreams() const { return 0; }
+void SocketEventLoop::Interrupt() {}
+void SocketEventLoop::WakeUp() {}
+
+#endif
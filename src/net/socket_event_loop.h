@@ -0,0 +1,94 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#pragma once
+
+#include <compat.h>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class Stream;
+
+/**
+ * Edge triggered (epoll) socket event loop used by the socket handler thread
+ * instead of rebuilding fd_sets and calling select() over all streams on each
+ * wakeup.
+ *
+ * Each stream socket is registered once for both read and write readiness.
+ * As notifications are edge triggered the stream remembers readiness until
+ * recv()/send() would block and asks to be serviced (Activate()) when it gets
+ * work that doesn't come with a socket event - e.g. when data is queued for
+ * sending or receiving is unpaused - so the cost of a wakeup depends on the
+ * number of streams with something to do and not on the number of
+ * connections.
+ *
+ * Registered streams are only weakly referenced so the ones returned by
+ * Wait() are those that are still alive, even if their peer is disconnected
+ * and deleted by another thread in the meantime.
+ */
+class SocketEventLoop
+{
+  public:
+    // Create a new event loop, returns nullptr if not supported on this platform
+    static std::unique_ptr<SocketEventLoop> Make();
+
+    ~SocketEventLoop();
+
+    SocketEventLoop(const SocketEventLoop&) = delete;
+    SocketEventLoop& operator=(const SocketEventLoop&) = delete;
+    SocketEventLoop(SocketEventLoop&&) = delete;
+    SocketEventLoop& operator=(SocketEventLoop&&) = delete;
+
+    // Watch listening socket for incoming connections
+    bool AddListenSocket(SOCKET socket);
+
+    // Start/stop watching stream socket
+    bool Register(SOCKET socket, const std::shared_ptr<Stream>& stream);
+    void Deregister(SOCKET socket, Stream* stream);
+
+    // Request servicing of a stream that has work without a new socket event.
+    // Immediate requests wake up Wait(), others are serviced on the next wakeup
+    // (at most DEFERRED_POLL_INTERVAL later).
+    void Activate(Stream* stream, bool immediate);
+
+    // Wait up to timeout for socket events and return streams that need
+    // servicing. Listening sockets with pending connections are returned
+    // through readyListenSockets.
+    std::vector<std::shared_ptr<Stream>> Wait(std::chrono::milliseconds timeout,
+                                              std::vector<SOCKET>& readyListenSockets);
+
+    // Get number of registered streams
+    size_t GetNumStreams() const;
+
+    // Wake up Wait()
+    void Interrupt();
+
+  private:
+    SocketEventLoop(int epollFd, int wakeupFd);
+
+    void WakeUp();
+
+    // Maximum number of events fetched by a single wait
+    static constexpr int MAX_EVENTS {1024};
+    // Longest wait before servicing deferred streams again
+    static constexpr std::chrono::milliseconds DEFERRED_POLL_INTERVAL {5};
+
+    const int mEpollFd {-1};
+    const int mWakeupFd {-1};
+
+    // Registered streams
+    std::unordered_map<Stream*, std::weak_ptr<Stream>> mStreams {};
+    // Streams waiting for immediate servicing
+    std::unordered_set<Stream*> mActive {};
+    // Streams waiting for servicing on the next wakeup
+    std::unordered_set<Stream*> mDeferred {};
+    // Whether the socket handler thread is blocked waiting for events
+    bool mWaiting {false};
+    mutable std::mutex mMtx {};
+};
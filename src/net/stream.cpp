@@ -5,6 +5,7 @@
 #include <config.h>
 #include <net/net.h>
 #include <net/netbase.h>
+#include <net/socket_event_loop.h>
 #include <net/stream.h>
 #include "config.h"
 
@@ -76,6 +77,14 @@ void Stream::Shutdown()
     {
         LogPrint(BCLog::NETCONN, "closing %s stream to peer=%d\n", enum_cast<std::string>(mStreamType),
             mNode->GetId());
+
+        // Stop watching the socket before its descriptor can be reused
+        SocketEventLoop* eventLoop { mSocketEventLoop.exchange(nullptr) };
+        if(eventLoop)
+        {
+            eventLoop->Deregister(mSocket, this);
+        }
+
         CloseSocket(mSocket);
     }
 }
@@ -139,46 +148,7 @@ void Stream::ServiceSocket(fd_set& setRecv, fd_set& setSend, fd_set& setError, c
         }
         if (recvSet || errorSet)
         {   
-            // typical socket buffer is 8K-64K
-            char pchBuf[0x10000];
-            ssize_t nBytes = 0;
-
-            {   
-                LOCK(cs_mSocket);
-                if (mSocket == INVALID_SOCKET)
-                {   
-                    return;
-                }
-                nBytes = recv(mSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
-            }
-            if (nBytes > 0)
-            {
-                // Process received data
-                bytesRecv = static_cast<uint64_t>(nBytes);
-                ReceiveMsgBytes(config, pchBuf, bytesRecv, gotNewMsgs);
-            }
-            else if (nBytes == 0)
-            {   
-                // socket closed gracefully
-                if (!mNode->GetDisconnect())
-                {   
-                    LogPrint(BCLog::NETCONN, "stream socket closed\n");
-                }
-                mNode->CloseSocketDisconnect();
-            }
-            else if (nBytes < 0)
-            {
-                // error
-                int nErr = WSAGetLastError();
-                if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
-                {
-                    if (!mNode->GetDisconnect())
-                    {
-                        LogPrintf("stream socket recv error %s\n", NetworkErrorString(nErr));
-                    }
-                    mNode->CloseSocketDisconnect();
-                }
-            }
+            ReceiveSocketData(config, gotNewMsgs, bytesRecv);
         }
 
         //
@@ -197,6 +167,91 @@ void Stream::ServiceSocket(fd_set& setRecv, fd_set& setSend, fd_set& setError, c
     }
 }
 
+bool Stream::RegisterSocketEvents(SocketEventLoop& eventLoop)
+{
+    LOCK(cs_mSocket);
+    if(mSocket == INVALID_SOCKET || !eventLoop.Register(mSocket, shared_from_this()))
+    {
+        return false;
+    }
+
+    mSocketEventLoop = &eventLoop;
+    return true;
+}
+
+void Stream::SetSocketReady(bool recvReady, bool sendReady)
+{
+    LOCK(cs_mSocket);
+    if(recvReady)
+    {
+        mRecvReady = true;
+    }
+    if(sendReady)
+    {
+        mSendReady = true;
+    }
+}
+
+void Stream::ServiceSocketEvents(const Config& config, bool& gotNewMsgs, uint64_t& bytesRecv,
+                                 uint64_t& bytesSent)
+{
+    uint64_t streamBytesRecv {0};
+    uint64_t streamBytesSent {0};
+    bool moreWork {false};
+
+    {
+        LOCK(cs_mNode);
+
+        //
+        // Receive
+        //
+        // We are only told once that the socket became readable so keep reading
+        // until it would block, but only up to a limit so we don't hog the thread.
+        for(size_t i = 0; i < MAX_RECV_PER_SERVICE && mRecvReady && !mPauseRecv; ++i)
+        {
+            bool complete {false};
+            RecvResult res { ReceiveSocketData(config, complete, streamBytesRecv) };
+            if(complete)
+            {
+                // Pull out completed msgs now so we pause as soon as our queue is full
+                GetNewMsgs();
+                gotNewMsgs = true;
+            }
+
+            if(res != RecvResult::MORE)
+            {
+                break;
+            }
+        }
+
+        //
+        // Send
+        //
+        if(mSendReady)
+        {
+            streamBytesSent = SocketSendData();
+        }
+
+        // Is there anything left we could do without waiting for the socket?
+        moreWork = mRecvReady && !mPauseRecv;
+        if(mSendReady)
+        {
+            LOCK(cs_mSendMsgQueue);
+            moreWork |= !mSendMsgQueue.empty();
+        }
+    }
+
+    if(moreWork)
+    {
+        // If we are stuck (rate limited or waiting for payload to load) there
+        // is no point coming straight back
+        ActivateSocketEvents(streamBytesRecv > 0 || streamBytesSent > 0);
+    }
+
+    bytesRecv += streamBytesRecv;
+    bytesSent += streamBytesSent;
+}
+
 uint64_t Stream::PushMessage(std::vector<uint8_t>&& serialisedHeader, CSerializedNetMsg&& msg,
     uint64_t nPayloadLength, uint64_t nTotalSize)
 {   
@@ -244,6 +299,13 @@ uint64_t Stream::PushMessage(std::vector<uint8_t>&& serialisedHeader, CSerialize
         nBytesSent = SocketSendData();
     }
 
+    // Whatever is left is sent once the socket can take it. If it already can
+    // there won't be another socket event so we have to ask to be serviced.
+    if(mSendReady && !mSendMsgQueue.empty())
+    {
+        ActivateSocketEvents(true);
+    }
+
     return nBytesSent;
 }
 
@@ -261,7 +323,14 @@ std::pair<Stream::QueuedNetMessage, bool> Stream::GetNextMessage()
 
         // Update total queued msgs size
         mRecvMsgQueueSize -= msg->GetTotalLength();
+        bool wasPaused { mPauseRecv };
         mPauseRecv = mRecvMsgQueueSize > mMaxRecvBuffSize;
+
+        // Data that arrived while we were paused won't generate another socket event
+        if(wasPaused && !mPauseRecv && mRecvReady)
+        {
+            ActivateSocketEvents(true);
+        }
     }
 
     // Return whether we still have more msgs queued
@@ -284,6 +353,8 @@ void Stream::CopyStats(StreamStats& stats) const
     {
         LOCK(cs_mRecvMsgQueue);
         stats.nRecvBytes = mTotalBytesRecv;
+        stats.nRecvBytesCopied = mTotalBytesRecvCopied;
+        stats.nRecvBuffersReused = mRecvBufferPool->GetNumReused();
         stats.fPauseRecv = mPauseRecv;
         stats.nRecvSize = mRecvMsgQueueSize;
         stats.mapRecvBytesPerMsgCmd = mRecvBytesPerMsgCmd;
@@ -344,12 +415,81 @@ uint64_t Stream::GetSendQueueSize() const
     return mSendMsgQueueSize.getSendQueueBytes();
 }
 
+std::shared_ptr<CNode> Stream::GetOwningNode() const
+{
+    LOCK(cs_mNode);
+    if(mNode == nullptr)
+    {
+        return nullptr;
+    }
+
+    return mNode->weak_from_this().lock();
+}
+
 void Stream::SetOwningNode(CNode* newNode)
 {
     LOCK(cs_mNode);
     mNode = newNode;
 }
 
+Stream::RecvResult Stream::ReceiveSocketData(const Config& config, bool& complete, uint64_t& bytesRecv)
+{
+    AssertLockHeld(cs_mNode);
+
+    // typical socket buffer is 8K-64K
+    char pchBuf[0x10000];
+    ssize_t nBytes = 0;
+    int nErr = 0;
+
+    {
+        LOCK(cs_mSocket);
+        if (mSocket == INVALID_SOCKET)
+        {
+            return RecvResult::CLOSED;
+        }
+        nBytes = recv(mSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+        if (nBytes < 0)
+        {
+            nErr = WSAGetLastError();
+            if (nErr == WSAEWOULDBLOCK)
+            {
+                // Nothing more to read until the event loop says otherwise
+                mRecvReady = false;
+                return RecvResult::DRAINED;
+            }
+        }
+    }
+
+    if (nBytes > 0)
+    {
+        // Process received data
+        bytesRecv += static_cast<uint64_t>(nBytes);
+        ReceiveMsgBytes(config, pchBuf, static_cast<uint64_t>(nBytes), complete);
+    }
+    else if (nBytes == 0)
+    {
+        // socket closed gracefully
+        if (!mNode->GetDisconnect())
+        {
+            LogPrint(BCLog::NETCONN, "stream socket closed\n");
+        }
+        mNode->CloseSocketDisconnect();
+        return RecvResult::CLOSED;
+    }
+    else if (nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
+    {
+        // error
+        if (!mNode->GetDisconnect())
+        {
+            LogPrintf("stream socket recv error %s\n", NetworkErrorString(nErr));
+        }
+        mNode->CloseSocketDisconnect();
+        return RecvResult::CLOSED;
+    }
+
+    return RecvResult::MORE;
+}
+
 void Stream::ReceiveMsgBytes(const Config& config, const char* pch, uint64_t nBytes, bool& complete)
 {
     AssertLockHeld(cs_mNode);
@@ -367,13 +507,17 @@ void Stream::ReceiveMsgBytes(const Config& config, const char* pch, uint64_t nBy
         // Get current incomplete message, or create a new one.
         if (mRecvMsgQueue.empty() || mRecvMsgQueue.back()->Complete())
         {
-            mRecvMsgQueue.emplace_back(std::make_unique<CNetMessage>(Params().NetMagic(), SER_NETWORK, INIT_PROTO_VERSION));
+            mRecvMsgQueue.emplace_back(std::make_unique<CNetMessage>(Params().NetMagic(), SER_NETWORK,
+                INIT_PROTO_VERSION, mRecvBufferPool));
+            mRecvMsgQueue.back()->SetStreamBlockParsing(g_connman->GetStreamBlockParsing());
         }
 
         CNetMessage& msg { *(mRecvMsgQueue.back()) };
 
         // Absorb network data
+        uint64_t copiedBefore { msg.GetBytesCopied() };
         uint64_t handled { msg.Read(config, pch, nBytes) };
+        mTotalBytesRecvCopied += handled + (msg.GetBytesCopied() - copiedBefore);
 
         pch += handled;
         nBytes -= handled;
@@ -386,6 +530,15 @@ void Stream::ReceiveMsgBytes(const Config& config, const char* pch, uint64_t nBy
     }   
 }   
 
+void Stream::ActivateSocketEvents(bool immediate)
+{
+    SocketEventLoop* eventLoop { mSocketEventLoop.load() };
+    if(eventLoop)
+    {
+        eventLoop->Activate(this, immediate);
+    }
+}
+
 uint64_t Stream::SocketSendData()
 {   
     uint64_t nSentSize = 0;
@@ -481,6 +634,7 @@ Stream::CSendResult Stream::SendMessage(CForwardAsyncReadonlyStream& data, uint6
         }
 
         ssize_t nBytes = 0;
+        int nErr = 0;
         if (!mSendChunk)
         {   
             mSendChunk = data.ReadAsync(maxChunkSize);
@@ -505,6 +659,15 @@ Stream::CSendResult Stream::SendMessage(CForwardAsyncReadonlyStream& data, uint6
                           reinterpret_cast<const char *>(mSendChunk->Begin()),
                           mSendChunk->Size(),
                           MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (nBytes < 0)
+            {
+                nErr = WSAGetLastError();
+                if (nErr == WSAEWOULDBLOCK)
+                {
+                    // No room to send more until the event loop says otherwise
+                    mSendReady = false;
+                }
+            }
         }
 
         if (nBytes == 0)
@@ -515,7 +678,6 @@ Stream::CSendResult Stream::SendMessage(CForwardAsyncReadonlyStream& data, uint6
         if (nBytes < 0)
         {   
             // error
-            int nErr = WSAGetLastError();
             if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR && nErr != WSAEINPROGRESS)
             {
                 LogPrintf("socket send error %s\n", NetworkErrorString(nErr));
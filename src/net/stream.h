@@ -27,6 +27,7 @@ class CNetAddr;
 class CNode;
 class Config;
 class CSerializedNetMsg;
+class SocketEventLoop;
 class StreamStats;
 
 /**
@@ -56,7 +57,7 @@ const enumTableT<StreamType>& enumTable(StreamType);
  * A stream is a single channel of communication carried over an association
  * between 2 peers.
  */
-class Stream
+class Stream : public std::enable_shared_from_this<Stream>
 {
   public:
     // Default stream sending bandwidth rate limit to apply (no limit)
@@ -80,6 +81,17 @@ class Stream
     void ServiceSocket(fd_set& setRecv, fd_set& setSend, fd_set& setError, const Config& config,
                        bool& gotNewMsgs, uint64_t& bytesRecv, uint64_t& bytesSent);
 
+    // Register our socket with the event loop
+    bool RegisterSocketEvents(SocketEventLoop& eventLoop);
+
+    // Remember readiness reported by the event loop
+    void SetSocketReady(bool recvReady, bool sendReady);
+
+    // Service our socket for reading and writing as reported by the event loop
+    void ServiceSocketEvents(const Config& config, bool& gotNewMsgs, uint64_t& bytesRecv, uint64_t& bytesSent);
+
+    // Ask the event loop to service us again
+    void ActivateSocketEvents(bool immediate);
 
     // Add new message to our list for sending
     uint64_t PushMessage(std::vector<uint8_t>&& serialisedHeader, CSerializedNetMsg&& msg,
@@ -110,7 +122,8 @@ class Stream
     StreamType GetStreamType() const { return mStreamType; }
     void SetStreamType(StreamType streamType) { mStreamType = streamType; }
 
-    // Set our owning CNode
+    // Get/Set our owning CNode
+    std::shared_ptr<CNode> GetOwningNode() const;
     void SetOwningNode(CNode* newNode);
 
     // Get whether we're paused for receiving
@@ -123,6 +136,9 @@ class Stream
     static constexpr size_t MIN_MAX_SEGMENT_SIZE { 536 };
     // Maximum TCP maximum segment size
     static constexpr size_t MAX_MAX_SEGMENT_SIZE { 65535 };
+    // Maximum number of socket reads per event loop servicing so that a busy
+    // peer can't starve the others
+    static constexpr size_t MAX_RECV_PER_SERVICE { 4 };
 
     // Node we are for
     CNode* mNode {nullptr};
@@ -138,6 +154,13 @@ class Stream
     // TCP maximum segment size for our underlying socket
     size_t mMSS { MIN_MAX_SEGMENT_SIZE };
 
+    // Event loop we are registered with (if any) and socket readiness it
+    // reported that we haven't yet used up. Readiness is only updated with
+    // cs_mSocket held so that an edge reported while sending can't be lost.
+    std::atomic<SocketEventLoop*> mSocketEventLoop {nullptr};
+    std::atomic_bool mRecvReady {false};
+    std::atomic_bool mSendReady {false};
+
     // Send message queue
     std::deque<std::unique_ptr<CForwardAsyncReadonlyStream>> mSendMsgQueue {};
     uint64_t mTotalBytesSent {0};
@@ -148,6 +171,11 @@ class Stream
     // Receive message queue
     std::list<QueuedNetMessage> mRecvMsgQueue {};
     uint64_t mTotalBytesRecv {0};
+    // Bytes copied into message buffers, including any moved while growing
+    // them. Compared with mTotalBytesRecv this tells us how many times each
+    // received byte gets copied.
+    uint64_t mTotalBytesRecvCopied {0};
+    CNetMessageBufferPoolPtr mRecvBufferPool { std::make_shared<CNetMessageBufferPool>() };
     uint64_t mRecvMsgQueueSize {0};
     std::atomic_bool mPauseRecv {false};
     mapMsgCmdSize mRecvBytesPerMsgCmd {};
@@ -161,6 +189,12 @@ class Stream
     // Maximum receieve queue size
     const uint64_t mMaxRecvBuffSize {0};
 
+    // Result of a single read from our underlying socket
+    enum class RecvResult { MORE, DRAINED, CLOSED };
+
+    // Read once from our underlying socket and process what we got
+    RecvResult ReceiveSocketData(const Config& config, bool& complete, uint64_t& bytesRecv);
+
     // Process some newly read bytes from our underlying socket
     void ReceiveMsgBytes(const Config& config, const char* pch, uint64_t nBytes, bool& complete);
 
@@ -51,6 +51,16 @@ void BasicStreamPolicy::ServiceSockets(StreamMap& streams, fd_set& setRecv,
     }
 }
 
+void BasicStreamPolicy::ServiceSocketEvents(StreamMap& streams, const Config& config,
+    bool& gotNewMsgs, uint64_t& bytesRecv, uint64_t& bytesSent)
+{
+    // Service each stream socket, streams without pending events have nothing to do
+    for(auto& stream : streams)
+    {
+        stream.second->ServiceSocketEvents(config, gotNewMsgs, bytesRecv, bytesSent);
+    }
+}
+
 uint64_t BasicStreamPolicy::PushMessageCommon(StreamMap& streams, StreamType streamType,
     bool exactMatch, std::vector<uint8_t>&& serialisedHeader, CSerializedNetMsg&& msg,
     uint64_t nPayloadLength, uint64_t nTotalSize)
@@ -47,6 +47,10 @@ class StreamPolicy
                                 fd_set& setError, const Config& config, bool& gotNewMsgs,
                                 uint64_t& bytesRecv, uint64_t& bytesSent) = 0;
 
+    // Service the sockets of the streams as reported by the event loop
+    virtual void ServiceSocketEvents(StreamMap& streams, const Config& config, bool& gotNewMsgs,
+                                     uint64_t& bytesRecv, uint64_t& bytesSent) = 0;
+
     // Queue an outgoing message on the appropriate stream
     virtual uint64_t PushMessage(StreamMap& streams, StreamType streamType,
                                  std::vector<uint8_t>&& serialisedHeader, CSerializedNetMsg&& msg,
@@ -71,6 +75,10 @@ class BasicStreamPolicy : public StreamPolicy
                         fd_set& setError, const Config& config, bool& gotNewMsgs,
                         uint64_t& bytesRecv, uint64_t& bytesSent) override;
 
+    // Service the sockets of the streams as reported by the event loop
+    void ServiceSocketEvents(StreamMap& streams, const Config& config, bool& gotNewMsgs,
+                             uint64_t& bytesRecv, uint64_t& bytesSent) override;
+
   protected:
 
     // Common PushMessage functionality
@@ -11,6 +11,12 @@
 #include "serialize.h"
 #include "uint256.h"
 
+#include <memory>
+#include <optional>
+#include <utility>
+
+class CMerkleTree;
+
 /**
  * Nodes collect new transactions into a block, hash them into a hash tree, and
  * scan through nonce values to make the block's hash satisfy proof-of-work
@@ -84,6 +90,12 @@ public:
 
     // memory only
     mutable bool fChecked;
+    // memory only: merkle root of vtx and whether a duplicated subtree was
+    // found, if it was already computed while the block was being received
+    std::optional<std::pair<uint256, bool>> precomputedMerkleRoot;
+    // memory only: merkle tree calculated by CheckBlock, kept until the block
+    // is connected so that it can be stored for merkle proof requests
+    mutable std::shared_ptr<const CMerkleTree> calculatedMerkleTree;
 
     CBlock() { SetNull(); }
 
@@ -114,6 +126,8 @@ public:
         CBlockHeader::SetNull();
         vtx.clear();
         fChecked = false;
+        precomputedMerkleRoot.reset();
+        calculatedMerkleTree.reset();
     }
 
     CBlockHeader GetBlockHeader() const {
@@ -79,7 +79,8 @@ DisconnectResult ProcessingBlockIndex::ApplyBlockUndo(const CBlockUndo &blockUnd
 
 DisconnectResult ProcessingBlockIndex::DisconnectBlock(const CBlock &block,
                                         CCoinsViewCache &view,
-                                        const task::CCancellationToken& shutdownToken) const
+                                        const task::CCancellationToken& shutdownToken,
+                                        std::shared_ptr<const CBlockUndo>* blockUndoOut) const
 {
     auto blockUndo = mIndex.GetBlockUndo();
 
@@ -88,10 +89,17 @@ DisconnectResult ProcessingBlockIndex::DisconnectBlock(const CBlock &block,
         return DISCONNECT_FAILED;
     }
 
-    return
+    DisconnectResult result =
         ApplyBlockUndo(
             blockUndo.value(),
             block,
             view,
             shutdownToken );
+
+    if (blockUndoOut)
+    {
+        *blockUndoOut = std::make_shared<const CBlockUndo>(std::move(blockUndo.value()));
+    }
+
+    return result;
 }
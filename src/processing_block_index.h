@@ -9,6 +9,8 @@
 #include "primitives/block.h"
 #include "undo.h"
 
+#include <memory>
+
 class ProcessingBlockIndex
 {
 public:
@@ -16,10 +18,12 @@ public:
 
     ProcessingBlockIndex( CBlockIndex& index ) : mIndex(index) {}
 
+    // If blockUndoOut is not null it receives the undo data read from disk
     DisconnectResult DisconnectBlock(
         const CBlock& block,
         CCoinsViewCache& view,
-        const task::CCancellationToken& shutdownToken) const;
+        const task::CCancellationToken& shutdownToken,
+        std::shared_ptr<const CBlockUndo>* blockUndoOut = nullptr) const;
 
 private:
 
@@ -10,6 +10,9 @@
 #include <secp256k1.h>
 #include <secp256k1_recovery.h>
 
+#include <map>
+#include <optional>
+
 namespace
 {
     /* Global secp256k1_context object used for verification. */
@@ -172,16 +175,11 @@ static int ecdsa_signature_parse_der_lax(const secp256k1_context *ctx,
     return 1;
 }
 
-bool CPubKey::Verify(const uint256 &hash,
-                     const std::vector<uint8_t> &vchSig) const {
-    if (!IsValid()) return false;
-    secp256k1_pubkey pubkey;
+/** Verify a DER signature with an already parsed public key. */
+static bool VerifyWithParsedKey(const secp256k1_pubkey &pubkey,
+                                const uint256 &hash,
+                                const std::vector<uint8_t> &vchSig) {
     secp256k1_ecdsa_signature sig;
-    if(!secp256k1_ec_pubkey_parse(
-           secp256k1_context_verify.get(), &pubkey, &(*this)[0], size()))
-    {
-        return false;
-    }
     if (vchSig.size() == 0) {
         return false;
     }
@@ -200,6 +198,50 @@ bool CPubKey::Verify(const uint256 &hash,
         secp256k1_context_verify.get(), &sig, hash.begin(), &pubkey);
 }
 
+bool CPubKey::Verify(const uint256 &hash,
+                     const std::vector<uint8_t> &vchSig) const {
+    if (!IsValid()) return false;
+    secp256k1_pubkey pubkey;
+    if(!secp256k1_ec_pubkey_parse(
+           secp256k1_context_verify.get(), &pubkey, &(*this)[0], size()))
+    {
+        return false;
+    }
+    return VerifyWithParsedKey(pubkey, hash, vchSig);
+}
+
+void CSignatureBatch::Add(const CPubKey &pubkey, const uint256 &hash,
+                          const std::vector<uint8_t> &vchSig) {
+    entries.push_back({pubkey, hash, vchSig});
+}
+
+bool CSignatureBatch::Verify() {
+    std::vector<Entry> toVerify;
+    toVerify.swap(entries);
+
+    // Parsed public keys, nullopt for those that failed to parse
+    std::map<CPubKey, std::optional<secp256k1_pubkey>> parsed;
+    for (const Entry &entry : toVerify) {
+        if (!entry.pubkey.IsValid()) {
+            return false;
+        }
+        auto it = parsed.find(entry.pubkey);
+        if (it == parsed.end()) {
+            secp256k1_pubkey pubkey;
+            const bool ok = secp256k1_ec_pubkey_parse(
+                secp256k1_context_verify.get(), &pubkey, entry.pubkey.begin(),
+                entry.pubkey.size());
+            it = parsed.emplace(entry.pubkey, ok ? std::make_optional(pubkey)
+                                                 : std::nullopt).first;
+        }
+        if (!it->second ||
+            !VerifyWithParsedKey(*it->second, entry.hash, entry.vchSig)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool CPubKey::RecoverCompact(const uint256 &hash,
                              const std::vector<uint8_t> &vchSig) {
     if (vchSig.size() != 65) return false;
@@ -155,6 +155,35 @@ public:
                 const ChainCode &cc) const;
 };
 
+/**
+ * Signature checks collected to be verified together at a later point.
+ *
+ * libsecp256k1 has no batch verification for ECDSA, so the signatures are
+ * still verified one at a time, but a public key that occurs several times in
+ * a batch is only parsed (and decompressed) once.
+ */
+class CSignatureBatch {
+private:
+    struct Entry {
+        CPubKey pubkey;
+        uint256 hash;
+        std::vector<uint8_t> vchSig;
+    };
+    std::vector<Entry> entries;
+
+public:
+    //! Add a DER signature to be verified against hash with pubkey.
+    void Add(const CPubKey &pubkey, const uint256 &hash,
+             const std::vector<uint8_t> &vchSig);
+
+    //! Verify and remove all added signatures. Returns false if any of them
+    //! is invalid (as per CPubKey::Verify).
+    bool Verify();
+
+    size_t size() const { return entries.size(); }
+    bool empty() const { return entries.empty(); }
+};
+
 struct CExtPubKey {
     uint8_t nDepth;
     uint8_t vchFingerprint[4];
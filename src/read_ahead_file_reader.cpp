@@ -0,0 +1,238 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "read_ahead_file_reader.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <utility>
+
+#ifdef USE_IO_URING
+#include <cerrno>
+#include <unistd.h>
+#endif
+
+CReadAheadFileReader::CReadAheadFileReader(UniqueCFile file)
+    : mFile{std::move(file)}
+{
+    assert(mFile);
+
+#ifdef USE_IO_URING
+    mRing = CIoUring::Get();
+    if (mRing)
+    {
+        const long offset = ftell(mFile.get());
+        mFileId = fileno(mFile.get());
+        assert(offset >= 0 && mFileId != -1);
+        mSubmittedOffset = static_cast<uint64_t>(offset);
+
+        ScheduleReads();
+    }
+#endif
+}
+
+CReadAheadFileReader::~CReadAheadFileReader()
+{
+#ifdef USE_IO_URING
+    // Buffers and file must outlive reads that are still in flight
+    DropChunks();
+#endif
+}
+
+CReadAheadFileReader::CReadAheadFileReader(CReadAheadFileReader&& other)
+    : mFile{std::move(other.mFile)}
+    , mBuffer{std::move(other.mBuffer)}
+    , mEndOfStream{other.mEndOfStream}
+{
+#ifdef USE_IO_URING
+    mRing = other.mRing;
+    mFileId = other.mFileId;
+    mSubmittedOffset = other.mSubmittedOffset;
+    mNextChunkSize = other.mNextChunkSize;
+    mMaxChunksInFlight = other.mMaxChunksInFlight;
+    mSubmittedEndOfFile = other.mSubmittedEndOfFile;
+    // Chunks are heap allocated so reads that are in flight are not affected
+    mChunks = std::exchange(other.mChunks, {});
+#endif
+}
+
+size_t CReadAheadFileReader::Read(char* pch, size_t maxSize)
+{
+#ifdef USE_IO_URING
+    if (mRing)
+    {
+        size_t read = 0;
+        while (read < maxSize)
+        {
+            CSpan span = Read(maxSize - read);
+            if (span.Size() == 0)
+            {
+                break;
+            }
+
+            std::memcpy(pch + read, span.Begin(), span.Size());
+            read += span.Size();
+        }
+
+        return read;
+    }
+#endif
+
+    size_t read = fread(pch, 1, maxSize, mFile.get());
+    if (read < maxSize)
+    {
+        if (!feof(mFile.get()))
+        {
+            throw std::ios_base::failure{"CReadAheadFileReader::Read: fread failed"};
+        }
+
+        mEndOfStream = true;
+    }
+
+    return read;
+}
+
+bool CReadAheadFileReader::EndOfStream() const
+{
+    return mEndOfStream;
+}
+
+CSpan CReadAheadFileReader::Read(size_t maxSize)
+{
+    // it's not feasible to try and read 0 bytes
+    assert(maxSize > 0);
+
+#ifdef USE_IO_URING
+    if (mRing)
+    {
+        while (!mChunks.empty())
+        {
+            Chunk& chunk = *mChunks.front();
+            mRing->Wait(chunk.request);
+
+            if (chunk.request.result < 0)
+            {
+                throw
+                    std::ios_base::failure{
+                        std::string{"CReadAheadFileReader::Read: read failed: "} +
+                        std::strerror(-chunk.request.result)};
+            }
+
+            const size_t read = static_cast<size_t>(chunk.request.result);
+            if (chunk.consumed < read)
+            {
+                const size_t size = std::min(read - chunk.consumed, maxSize);
+                CSpan span{chunk.data + chunk.consumed, size};
+                chunk.consumed += size;
+
+                return span;
+            }
+
+            if (read < chunk.size)
+            {
+                // Short read - reads that were issued for the following
+                // chunks started at the wrong offset so they are re-issued
+                // (or we reached the end of file).
+                const uint64_t end = chunk.offset + read;
+                DropChunks();
+                mSubmittedOffset = end;
+                mSubmittedEndOfFile = (read == 0);
+            }
+            else
+            {
+                ReleaseChunk(chunk);
+                mChunks.pop_front();
+                mMaxChunksInFlight =
+                    std::min(mMaxChunksInFlight + 1, MAX_CHUNKS_IN_FLIGHT);
+            }
+
+            ScheduleReads();
+        }
+
+        mEndOfStream = true;
+        return {};
+    }
+#endif
+
+    mBuffer.resize(std::min(maxSize, MAX_CHUNK_SIZE));
+    size_t read = Read(reinterpret_cast<char*>(mBuffer.data()), mBuffer.size());
+
+    return {mBuffer.data(), read};
+}
+
+#ifdef USE_IO_URING
+void CReadAheadFileReader::ScheduleReads()
+{
+    while (!mSubmittedEndOfFile && mChunks.size() < mMaxChunksInFlight)
+    {
+        auto chunk = std::make_unique<Chunk>();
+        chunk->fixedBuffer = mRing->AcquireFixedBuffer();
+        if (chunk->fixedBuffer)
+        {
+            chunk->data = chunk->fixedBuffer->data;
+            chunk->size = std::min(mNextChunkSize, chunk->fixedBuffer->size);
+        }
+        else
+        {
+            chunk->buffer.resize(mNextChunkSize);
+            chunk->data = chunk->buffer.data();
+            chunk->size = chunk->buffer.size();
+        }
+        chunk->offset = mSubmittedOffset;
+
+        bool submitted =
+            mRing->SubmitRead(
+                chunk->request,
+                mFileId,
+                chunk->data,
+                chunk->size,
+                chunk->offset,
+                chunk->fixedBuffer ? &*chunk->fixedBuffer : nullptr);
+
+        if (!submitted)
+        {
+            if (!mChunks.empty())
+            {
+                // Ring is full - try again once the next chunk is consumed
+                ReleaseChunk(*chunk);
+                break;
+            }
+
+            // Nothing else to wait for so read synchronously
+            ssize_t read;
+            do
+            {
+                read = pread(mFileId, chunk->data, chunk->size, chunk->offset);
+            } while (read < 0 && errno == EINTR);
+            chunk->request.result = read < 0 ? -errno : static_cast<int32_t>(read);
+            chunk->request.done = true;
+        }
+
+        mSubmittedOffset += chunk->size;
+        mNextChunkSize = std::min(mNextChunkSize * 2, MAX_CHUNK_SIZE);
+        mChunks.push_back(std::move(chunk));
+    }
+}
+
+void CReadAheadFileReader::DropChunks()
+{
+    for (auto& chunk : mChunks)
+    {
+        mRing->Cancel(chunk->request);
+        ReleaseChunk(*chunk);
+    }
+
+    mChunks.clear();
+}
+
+void CReadAheadFileReader::ReleaseChunk(Chunk& chunk)
+{
+    if (chunk.fixedBuffer)
+    {
+        mRing->ReleaseFixedBuffer(*chunk.fixedBuffer);
+        chunk.fixedBuffer.reset();
+    }
+}
+#endif
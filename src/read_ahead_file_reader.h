@@ -0,0 +1,91 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_READ_AHEAD_FILE_READER_H
+#define MVC_READ_AHEAD_FILE_READER_H
+
+#include <cstdio>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "io_uring_ring.h"
+#include "streams.h"
+
+/**
+ * RAII file reader that reads a file front to back while keeping multiple
+ * reads of the following data in flight so that parsing of the current chunk
+ * overlaps with disk reads of the next ones.
+ *
+ * Chunk size and number of chunks in flight start small (reader might only
+ * need the beginning of the file - e.g. a single block from a block file) and
+ * grow up to MAX_CHUNK_SIZE and MAX_CHUNKS_IN_FLIGHT as data is consumed.
+ *
+ * When io_uring is not available data is read synchronously with fread.
+ *
+ * Can be used in place of CFileReader (CBlockStreamReader) or as a source of
+ * CBufferedFile.
+ */
+class CReadAheadFileReader : public CForwardReadonlyStream
+{
+public:
+    static constexpr size_t MIN_CHUNK_SIZE = 16 * 1024;
+    static constexpr size_t MAX_CHUNK_SIZE = 256 * 1024;
+    static constexpr size_t MAX_CHUNKS_IN_FLIGHT = 4;
+
+    CReadAheadFileReader(UniqueCFile file);
+    ~CReadAheadFileReader();
+
+    CReadAheadFileReader(CReadAheadFileReader&& other);
+    // Move assignment is never used - same as for CAsyncFileReader
+    CReadAheadFileReader& operator=(CReadAheadFileReader&&) = delete;
+
+    CReadAheadFileReader(const CReadAheadFileReader&) = delete;
+    CReadAheadFileReader& operator=(const CReadAheadFileReader&) = delete;
+
+    /**
+     * Copy up to maxSize bytes to pch blocking until they are available.
+     * Returns less than maxSize only at the end of file.
+     */
+    size_t Read(char* pch, size_t maxSize);
+
+    bool EndOfStream() const override;
+    //! Blocks until the next chunk is available
+    CSpan Read(size_t maxSize) override;
+
+private:
+    UniqueCFile mFile;
+    std::vector<uint8_t> mBuffer;
+    bool mEndOfStream{false};
+
+#ifdef USE_IO_URING
+    struct Chunk
+    {
+        CIoUring::Request request;
+        std::optional<CIoUring::FixedBuffer> fixedBuffer;
+        std::vector<uint8_t> buffer;
+        uint8_t* data{nullptr};
+        uint64_t offset{0};
+        size_t size{0};
+        size_t consumed{0};
+    };
+
+    void ScheduleReads();
+    //! Cancel reads that are still in flight and release all chunks
+    void DropChunks();
+    void ReleaseChunk(Chunk& chunk);
+
+    CIoUring* mRing{nullptr};
+    int mFileId{-1};
+    uint64_t mSubmittedOffset{0};
+    size_t mNextChunkSize{MIN_CHUNK_SIZE};
+    size_t mMaxChunksInFlight{2};
+    bool mSubmittedEndOfFile{false};
+    // Chunks are kept behind pointers as in-flight requests must not move
+    std::deque<std::unique_ptr<Chunk>> mChunks;
+#endif
+};
+
+#endif // MVC_READ_AHEAD_FILE_READER_H
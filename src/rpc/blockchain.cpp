@@ -1502,7 +1502,8 @@ struct CCoinsStats {
           nDiskSize(0), nTotalAmount(0) {}
 };
 
-static void ApplyStats(CCoinsStats &stats, CHashWriter &ss, const uint256 &hash,
+template <typename Stream>
+static void ApplyStats(CCoinsStats &stats, Stream &ss, const uint256 &hash,
                        const std::map<uint32_t, CoinWithScript> &outputs) {
     assert(!outputs.empty());
     ss << hash;
@@ -1523,35 +1524,64 @@ static void ApplyStats(CCoinsStats &stats, CHashWriter &ss, const uint256 &hash,
     ss << VARINT(0);
 }
 
+//! Statistics and serialized hash input of a key range of the UTXO set
+struct CCoinsRangeStats {
+    CCoinsStats stats;
+    CDataStream serialized{SER_GETHASH, PROTOCOL_VERSION};
+};
+
 //! Calculate statistics about the unspent transaction output set
 static bool GetUTXOStats(CoinsDB& coinsTip, CCoinsStats &stats) {
-    std::unique_ptr<CCoinsViewDBCursor> pcursor(coinsTip.Cursor());
-
-    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
-    stats.hashBlock = pcursor->GetBestBlock();
-    stats.nHeight = mapBlockIndex.Get(stats.hashBlock)->GetHeight();
-    ss << stats.hashBlock;
-    uint256 prevkey;
-    std::map<uint32_t, CoinWithScript> outputs;
-    while (pcursor->Valid()) {
-        boost::this_thread::interruption_point();
-        COutPoint key;
-        CoinWithScript coin;
-        if (pcursor->GetKey(key) && pcursor->GetValue(coin)) {
+    // Ranges are scanned in parallel while their serialized content is hashed
+    // in key order so the result is the same as with a single cursor.
+    auto scanRange = [](CCoinsViewDBCursor &cursor) {
+        CCoinsRangeStats range;
+        range.stats.hashBlock = cursor.GetBestBlock();
+        uint256 prevkey;
+        std::map<uint32_t, CoinWithScript> outputs;
+        while (cursor.Valid()) {
+            COutPoint key;
+            CoinWithScript coin;
+            if (!cursor.GetKey(key) || !cursor.GetValue(coin)) {
+                throw std::runtime_error("unable to read value");
+            }
             if (!outputs.empty() && key.GetTxId() != prevkey) {
-                ApplyStats(stats, ss, prevkey, outputs);
+                ApplyStats(range.stats, range.serialized, prevkey, outputs);
                 outputs.clear();
             }
             prevkey = key.GetTxId();
             outputs[key.GetN()] = std::move(coin);
-        } else {
-            return error("%s: unable to read value", __func__);
+            cursor.Next();
         }
-        pcursor->Next();
-    }
-    if (!outputs.empty()) {
-        ApplyStats(stats, ss, prevkey, outputs);
+        if (!outputs.empty()) {
+            ApplyStats(range.stats, range.serialized, prevkey, outputs);
+        }
+        return range;
+    };
+
+    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    bool first = true;
+    auto consumeRange = [&](CCoinsRangeStats &&range) {
+        boost::this_thread::interruption_point();
+        if (first) {
+            // All ranges see the same database state
+            ss << range.stats.hashBlock;
+            first = false;
+        }
+        ss.write(range.serialized.data(), range.serialized.size());
+        stats.nTransactions += range.stats.nTransactions;
+        stats.nTransactionOutputs += range.stats.nTransactionOutputs;
+        stats.nBogoSize += range.stats.nBogoSize;
+        stats.nTotalAmount += range.stats.nTotalAmount;
+    };
+
+    try {
+        stats.hashBlock = coinsTip.ScanCoins(
+            CoinsDB::DEFAULT_SCAN_RANGES, scanRange, consumeRange);
+    } catch (const std::runtime_error &e) {
+        return error("%s: %s", __func__, e.what());
     }
+    stats.nHeight = mapBlockIndex.Get(stats.hashBlock)->GetHeight();
     stats.hashSerialized = ss.GetHash();
     stats.nDiskSize = coinsTip.EstimateSize();
     return true;
@@ -1626,32 +1656,93 @@ UniValue pruneblockchain(const Config &config, const JSONRPCRequest &request) {
 }
 
 UniValue gettxoutsetinfo(const Config &config, const JSONRPCRequest &request) {
-    if (request.fHelp || request.params.size() != 0) {
+    if (request.fHelp || request.params.size() > 1) {
         throw std::runtime_error(
-            "gettxoutsetinfo\n"
+            "gettxoutsetinfo ( \"mode\" )\n"
             "\nReturns statistics about the unspent transaction output set.\n"
-            "Note this call may take some time.\n"
+            "Note this call may take some time unless \"fast\" mode is used.\n"
+            "\nArguments:\n"
+            "1. \"mode\"   (string, optional, default=\"full\") One of:\n"
+            "             \"full\" - iterate over the whole UTXO set\n"
+            "             \"fast\" - return incrementally maintained statistics "
+            "(fails if they are not available)\n"
+            "             \"verify\" - recalculate incrementally maintained "
+            "statistics by iterating over the whole UTXO set and compare\n"
+            "                        them with maintained values (also "
+            "initializes them if they are not available)\n"
             "\nResult:\n"
             "{\n"
             "  \"height\":n,     (numeric) The current block height (index)\n"
             "  \"bestblock\": \"hex\",   (string) the best block hash hex\n"
-            "  \"transactions\": n,      (numeric) The number of transactions\n"
+            "  \"transactions\": n,      (numeric) The number of transactions "
+            "(\"full\" mode only)\n"
             "  \"txouts\": n,            (numeric) The number of output "
             "transactions\n"
             "  \"bogosize\": n,          (numeric) A database-independent "
             "metric for UTXO set size\n"
-            "  \"hash_serialized\": \"hash\",   (string) The serialized hash\n"
+            "  \"hash_serialized\": \"hash\",   (string) The serialized hash "
+            "(\"full\" mode only)\n"
+            "  \"muhash\": \"hash\",     (string) Order independent hash of the "
+            "UTXO set (if available)\n"
             "  \"disk_size\": n,         (numeric) The estimated size of the "
             "chainstate on disk\n"
             "  \"total_amount\": x.xxx          (numeric) The total amount\n"
+            "  \"verified\": true|false  (boolean) Whether recalculated "
+            "statistics matched maintained ones (\"verify\" mode only)\n"
             "}\n"
             "\nExamples:\n" +
             HelpExampleCli("gettxoutsetinfo", "") +
+            HelpExampleCli("gettxoutsetinfo", "\"fast\"") +
             HelpExampleRpc("gettxoutsetinfo", ""));
     }
 
+    std::string mode = "full";
+    if (!request.params[0].isNull()) {
+        mode = request.params[0].get_str();
+    }
+
     UniValue ret(UniValue::VOBJ);
 
+    auto pushUTXOSetStats =
+        [&ret](const uint256& bestBlock, const UTXOSetStats& utxoStats) {
+            ret.push_back(Pair("height", int64_t(mapBlockIndex.Get(bestBlock)->GetHeight())));
+            ret.push_back(Pair("bestblock", bestBlock.GetHex()));
+            ret.push_back(Pair("txouts", int64_t(utxoStats.GetTransactionOutputs())));
+            ret.push_back(Pair("bogosize", int64_t(utxoStats.GetBogoSize())));
+            ret.push_back(Pair("muhash", utxoStats.GetHash().GetHex()));
+            ret.push_back(Pair("disk_size", pcoinsTip->EstimateSize()));
+            ret.push_back(
+                Pair("total_amount", ValueFromAmount(utxoStats.GetTotalAmount())));
+        };
+
+    if (mode == "fast") {
+        auto utxoStats = pcoinsTip->GetUTXOSetStats();
+        if (!utxoStats) {
+            throw JSONRPCError(RPC_MISC_ERROR,
+                               "UTXO set statistics are not available, use "
+                               "\"verify\" mode to initialize them");
+        }
+        pushUTXOSetStats(utxoStats->first, utxoStats->second);
+        return ret;
+    }
+
+    if (mode == "verify") {
+        FlushStateToDisk();
+        bool matched = false;
+        try {
+            auto [bestBlock, utxoStats] = pcoinsTip->RecalculateUTXOSetStats(matched);
+            pushUTXOSetStats(bestBlock, utxoStats);
+        } catch (const std::runtime_error& e) {
+            throw JSONRPCError(RPC_INTERNAL_ERROR, e.what());
+        }
+        ret.push_back(Pair("verified", matched));
+        return ret;
+    }
+
+    if (mode != "full") {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid mode: " + mode);
+    }
+
     CCoinsStats stats;
     FlushStateToDisk();
     if (GetUTXOStats(*pcoinsTip, stats)) {
@@ -1661,6 +1752,10 @@ UniValue gettxoutsetinfo(const Config &config, const JSONRPCRequest &request) {
         ret.push_back(Pair("txouts", int64_t(stats.nTransactionOutputs)));
         ret.push_back(Pair("bogosize", int64_t(stats.nBogoSize)));
         ret.push_back(Pair("hash_serialized", stats.hashSerialized.GetHex()));
+        if (auto utxoStats = pcoinsTip->GetUTXOSetStats();
+            utxoStats && utxoStats->first == stats.hashBlock) {
+            ret.push_back(Pair("muhash", utxoStats->second.GetHash().GetHex()));
+        }
         ret.push_back(Pair("disk_size", stats.nDiskSize));
         ret.push_back(
             Pair("total_amount", ValueFromAmount(stats.nTotalAmount)));
@@ -2877,6 +2972,40 @@ static UniValue getblockchainactivity(const Config &config,
     return result;
 }
 
+static UniValue getcoinscacheinfo(const Config &config,
+                                  const JSONRPCRequest &request) {
+    if (request.fHelp || request.params.size() != 0) {
+        throw std::runtime_error(
+            "getcoinscacheinfo\n"
+            "\nReturn statistics of the coins database cache and coins "
+            "prefetching\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"cachedcoins\": xx,        (integer) Number of coins in cache\n"
+            "  \"cachesize\": xx,          (integer) Cache size in bytes\n"
+            "  \"prefetchrequested\": xx,  (integer) Number of coins requested to be prefetched\n"
+            "  \"prefetchloaded\": xx,     (integer) Number of coins loaded into cache by prefetch\n"
+            "  \"cachehits\": xx,          (integer) Number of coin lookups served from cache\n"
+            "  \"cachemisses\": xx,        (integer) Number of coin lookups that read from database\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getcoinscacheinfo", "") +
+            HelpExampleRpc("getcoinscacheinfo", ""));
+    }
+
+    auto stats = pcoinsTip->GetPrefetchStats();
+
+    UniValue result{UniValue::VOBJ};
+    result.push_back(Pair("cachedcoins", static_cast<uint64_t>(pcoinsTip->GetCacheSize())));
+    result.push_back(Pair("cachesize", static_cast<uint64_t>(pcoinsTip->DynamicMemoryUsage())));
+    result.push_back(Pair("prefetchrequested", stats.requested));
+    result.push_back(Pair("prefetchloaded", stats.loaded));
+    result.push_back(Pair("cachehits", stats.cacheHits));
+    result.push_back(Pair("cachemisses", stats.cacheMisses));
+
+    return result;
+}
+
 static UniValue waitaftervalidatingblock(const Config &config,
                                          const JSONRPCRequest &request) {
     if (request.fHelp || request.params.size() != 2) {
@@ -3002,7 +3131,7 @@ static const CRPCCommand commands[] = {
     { "blockchain",         "getrawmempool",          getrawmempool,          true,  {"verbose"} },
     { "blockchain",         "getrawnonfinalmempool",  getrawnonfinalmempool,  true,  {} },
     { "blockchain",         "gettxout",               gettxout,               true,  {"txid","n","include_mempool"} },
-    { "blockchain",         "gettxoutsetinfo",        gettxoutsetinfo,        true,  {} },
+    { "blockchain",         "gettxoutsetinfo",        gettxoutsetinfo,        true,  {"mode"} },
     { "blockchain",         "pruneblockchain",        pruneblockchain,        true,  {"height"} },
     { "blockchain",         "verifychain",            verifychain,            true,  {"checklevel","nblocks"} },
     { "blockchain",         "preciousblock",          preciousblock,          true,  {"blockhash"} },
@@ -3015,6 +3144,7 @@ static const CRPCCommand commands[] = {
     { "hidden",             "waitfornewblock",        waitfornewblock,        true,  {"timeout"} },
     { "hidden",             "waitforblockheight",     waitforblockheight,     true,  {"height","timeout"} },
     { "hidden",             "getblockchainactivity",  getblockchainactivity,  true,  {} },
+    { "hidden",             "getcoinscacheinfo",      getcoinscacheinfo,      true,  {} },
     { "hidden",             "getcurrentlyvalidatingblocks",     getcurrentlyvalidatingblocks,     true,  {} },
     { "hidden",             "waitaftervalidatingblock",         waitaftervalidatingblock,         true,  {"blockhash","action"} },
     { "hidden",             "getwaitingblocks",                 getwaitingblocks,            true,  {} },
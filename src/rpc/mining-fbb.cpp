@@ -109,25 +109,11 @@ CMiningCandidateRef mkblocktemplate(const Config& config, bool coinbaseRequired)
     pblock->nNonce = 0;
 
     // Create candidate and return it
-    CMiningCandidateRef candidate  { mining::CMiningFactory::GetCandidateManager().Create(blockref) };
+    CMiningCandidateRef candidate  { mining::CMiningFactory::GetCandidateManager().Create(blockref, pblocktemplate->coinbaseMerkleProof) };
     return candidate;
 }
 
 
-std::vector<uint256> GetMerkleProofBranches(CBlockRef pblock)
-{
-    std::vector<uint256> ret;
-    std::vector<uint256> leaves;
-    int len = pblock->vtx.size();
-
-    for (int i = 0; i < len; i++)
-    {
-        leaves.emplace_back(pblock->vtx[i]->GetHash());
-    }
-
-    return ComputeMerkleBranch(leaves, 0);
-}
-
 void CalculateNextMerkleRoot(uint256 &merkle_root, const uint256 &merkle_branch)
 {
     // Append a branch to the root. Double SHA256 the whole thing:
@@ -180,9 +166,8 @@ UniValue MkMiningCandidateJson(bool coinbaseRequired, CMiningCandidateRef &candi
     ret.push_back(Pair("sizeWithoutCoinbase", static_cast<uint64_t>(block->GetSizeWithoutCoinbase())));
 
     // merkleProof:
-    std::vector<uint256> brancharr = GetMerkleProofBranches(block);
     UniValue merkleProof(UniValue::VARR);
-    for (const auto &i : brancharr)
+    for (const auto &i : candidate->GetCoinbaseMerkleProof())
     {
         merkleProof.push_back(i.GetHex());
     }
@@ -336,9 +321,8 @@ UniValue submitminingsolution(const Config& config, const JSONRPCRequest& reques
 
     // Merkle root
     {
-        std::vector<uint256> merkleProof = GetMerkleProofBranches(block);
         uint256 t = block->vtx[0]->GetHash();
-        block->hashMerkleRoot = CalculateMerkleRoot(t, merkleProof);
+        block->hashMerkleRoot = CalculateMerkleRoot(t, result->GetCoinbaseMerkleProof());
     }
 
     // Submit solution
@@ -25,6 +25,7 @@
 #include "rpc/blockchain.h"
 #include "rpc/server.h"
 #include "script/script_num.h"
+#include "txhasher.h"
 #include "txmempool.h"
 #include "util.h"
 #include "utilstrencodings.h"
@@ -35,6 +36,7 @@
 #include <univalue.h>
 #include <cstdint>
 #include <memory>
+#include <unordered_map>
 
 using mining::CBlockTemplate;
 
@@ -363,6 +365,66 @@ static UniValue BIP22ValidationResult(const Config &config,
     return "valid?";
 }
 
+namespace
+{
+    /**
+     * Serialization stream that sends binary data as HTTP reply chunks,
+     * buffering up to a megabyte at a time.
+     */
+    class CHttpBinaryWriter
+    {
+    public:
+        explicit CHttpBinaryWriter(HTTPRequest& request) : mRequest{request}
+        {
+            mBuffer.reserve(BUFFER_SIZE);
+        }
+
+        ~CHttpBinaryWriter() { Flush(); }
+
+        CHttpBinaryWriter(const CHttpBinaryWriter&) = delete;
+        CHttpBinaryWriter& operator=(const CHttpBinaryWriter&) = delete;
+
+        int GetType() const { return SER_NETWORK; }
+        int GetVersion() const { return PROTOCOL_VERSION; }
+
+        void write(const char* pch, size_t size)
+        {
+            mBuffer.append(pch, size);
+            if (mBuffer.size() >= BUFFER_SIZE)
+            {
+                Flush();
+            }
+        }
+
+        template <typename T> CHttpBinaryWriter& operator<<(const T& obj)
+        {
+            ::Serialize(*this, obj);
+            return *this;
+        }
+
+        void Flush()
+        {
+            if (!mBuffer.empty())
+            {
+                mRequest.WriteReplyChunk(mBuffer);
+                mBuffer.clear();
+            }
+        }
+
+    private:
+        static constexpr size_t BUFFER_SIZE = ONE_MEGABYTE;
+        HTTPRequest& mRequest;
+        std::string mBuffer;
+    };
+
+    // Version of the binary block template format
+    constexpr uint32_t BINARY_BLOCK_TEMPLATE_VERSION = 1;
+
+    // Positions of transactions in a block template, used to report which
+    // transactions each one depends on
+    using TemplateTxIndex = std::unordered_map<uint256, int64_t, SaltedTxidHasher>;
+}
+
 void getblocktemplate(const Config& config,
                       const JSONRPCRequest& request,
                       HTTPRequest* httpReq,
@@ -398,7 +460,10 @@ void getblocktemplate(const Config& config,
             "feature, 'longpoll', 'coinbasetxn', 'coinbasevalue', 'proposal', "
             "'serverlist', 'workid'\n"
             "           ,...\n"
-            "       ]\n"
+            "       ],\n"
+            "       \"format\":\"json\"      (string, optional) \"json\" (the "
+            "default) or \"binary\" for the template in the binary format "
+            "below; binary is not available in batch requests\n"
             "     }\n"
             "\n"
 
@@ -469,6 +534,28 @@ void getblocktemplate(const Config& config,
             "next block\n"
             "}\n"
 
+            "\nBinary result (application/octet-stream, little endian, "
+            "no JSON-RPC envelope):\n"
+            "  uint32        format version (1)\n"
+            "  int32         version\n"
+            "  uint256       previousblockhash\n"
+            "  uint32        curtime\n"
+            "  uint32        bits\n"
+            "  int64         mintime\n"
+            "  int32         height\n"
+            "  int64         coinbasevalue\n"
+            "  int64         sizelimit\n"
+            "  string        longpollid (compact size length and characters)\n"
+            "  bytes         coinbaseaux flags (compact size length and bytes)\n"
+            "  uint256[]     merkle branch of the coinbase (compact size count "
+            "and hashes)\n"
+            "  compact size  number of non-coinbase transactions, each "
+            "followed by:\n"
+            "    int64         fee\n"
+            "    compact size  number of transactions this one depends on, "
+            "each followed by its 1-based index as a compact size\n"
+            "    transaction   serialized transaction\n"
+
             "\nExamples:\n" +
             HelpExampleCli("getblocktemplate", "") +
             HelpExampleRpc("getblocktemplate", ""));
@@ -478,10 +565,17 @@ void getblocktemplate(const Config& config,
         return;
 
     std::string strMode = "template";
+    bool binaryFormat = false;
     UniValue lpval = NullUniValue;
     std::set<std::string> setClientRules;
     if (request.params.size() > 0) {
         const UniValue &oparam = request.params[0].get_obj();
+        const UniValue &formatval = find_value(oparam, "format");
+        if (formatval.isStr() && formatval.get_str() == "binary") {
+            binaryFormat = true;
+        } else if (!formatval.isNull() && !(formatval.isStr() && formatval.get_str() == "json")) {
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid format");
+        }
         const UniValue &modeval = find_value(oparam, "mode");
         if (modeval.isStr()) {
             strMode = modeval.get_str();
@@ -574,6 +668,10 @@ void getblocktemplate(const Config& config,
         throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid mode");
     }
 
+    if (binaryFormat && processedInBatch) {
+        throw JSONRPCError(RPC_INVALID_PARAMETER, "Binary format is not supported in batch requests");
+    }
+
     if (!g_connman) {
         throw JSONRPCError(
             RPC_CLIENT_P2P_DISABLED,
@@ -682,6 +780,66 @@ void getblocktemplate(const Config& config,
     mining::UpdateTime(pblock, config, pindexPrev);
     pblock->nNonce = 0;
 
+    const std::string longPollId { tip->GetBlockHash().GetHex() + i64tostr(nTransactionsUpdatedLast) };
+    const int64_t defaultmaxBlockSize = config.GetChainParams().GetDefaultBlockSizeParams().maxGeneratedBlockSizeAfter;
+
+    // Indexes (in the block) of transactions, filled in as they are written
+    TemplateTxIndex setTxIndex;
+    setTxIndex.reserve(pblock->vtx.size());
+
+    if (binaryFormat)
+    {
+        const std::vector<uint256> coinbaseMerkleProof { currentTemplate->coinbaseMerkleProof ?
+            *currentTemplate->coinbaseMerkleProof : BlockMerkleBranch(*pblock, 0) };
+
+        httpReq->WriteHeader("Content-Type", "application/octet-stream");
+        httpReq->StartWritingChunks(HTTP_OK);
+
+        {
+            CHttpBinaryWriter writer(*httpReq);
+            writer << BINARY_BLOCK_TEMPLATE_VERSION;
+            writer << pblock->nVersion;
+            writer << pblock->hashPrevBlock;
+            writer << pblock->nTime;
+            writer << pblock->nBits;
+            writer << static_cast<int64_t>(pindexPrev->GetMedianTimePast() + 1);
+            writer << static_cast<int32_t>(pindexPrev->GetHeight() + 1);
+            writer << static_cast<int64_t>(pblock->vtx[0]->vout[0].nValue.GetSatoshis());
+            writer << defaultmaxBlockSize;
+            writer << longPollId;
+            writer << std::vector<uint8_t>(COINBASE_FLAGS.begin(), COINBASE_FLAGS.end());
+            writer << coinbaseMerkleProof;
+
+            WriteCompactSize(writer, pblock->vtx.size() - 1);
+            std::vector<uint64_t> depends;
+            for (size_t i = 0; i < pblock->vtx.size(); ++i) {
+                const CTransaction &tx = *pblock->vtx[i];
+                setTxIndex[tx.GetId()] = static_cast<int64_t>(i);
+                if (tx.IsCoinBase()) {
+                    continue;
+                }
+
+                depends.clear();
+                for (const CTxIn &in : tx.vin) {
+                    auto parent = setTxIndex.find(in.prevout.GetTxId());
+                    if (parent != setTxIndex.end()) {
+                        depends.push_back(static_cast<uint64_t>(parent->second));
+                    }
+                }
+
+                writer << static_cast<int64_t>(currentTemplate->vTxFees[i].GetSatoshis());
+                WriteCompactSize(writer, depends.size());
+                for (uint64_t index : depends) {
+                    WriteCompactSize(writer, index);
+                }
+                writer << tx;
+            }
+        }
+
+        httpReq->StopWritingChunks();
+        return;
+    }
+
     // after start of writing chunks no exception must be thrown, otherwise JSON response will be invalid
     if (!processedInBatch)
     {
@@ -705,7 +863,6 @@ void getblocktemplate(const Config& config,
         jWriter.pushKV("previousblockhash", pblock->hashPrevBlock.GetHex());
         jWriter.writeBeginArray("transactions");
 
-        std::map<uint256, int64_t> setTxIndex;
         int i = 0;
         for (const auto &it : pblock->vtx) {
             const CTransaction &tx = *it;
@@ -750,7 +907,7 @@ void getblocktemplate(const Config& config,
 
         jWriter.pushKV("coinbasevalue", (int64_t)pblock->vtx[0]->vout[0].nValue.GetSatoshis());
 
-        jWriter.pushKV("longpollid", tip->GetBlockHash().GetHex() + i64tostr(nTransactionsUpdatedLast));
+        jWriter.pushKV("longpollid", longPollId);
 
         arith_uint256 hashTarget = arith_uint256().SetCompact(pblock->nBits);
         jWriter.pushKV("target", hashTarget.GetHex());
@@ -765,7 +922,6 @@ void getblocktemplate(const Config& config,
 
         jWriter.pushKV("noncerange", "00000000ffffffff");
 
-        int64_t defaultmaxBlockSize = config.GetChainParams().GetDefaultBlockSizeParams().maxGeneratedBlockSizeAfter;
         jWriter.pushKV("sizelimit", defaultmaxBlockSize);
 
         jWriter.pushKV("curtime", pblock->GetBlockTime());
@@ -102,6 +102,9 @@ static UniValue getpeerinfo(const Config &config,
             "          \"lastrecv\": ttt,     (numeric) The time in seconds since epoch (Jan 1 1970 GMT) of the last receive\n"
             "          \"bytessent\": n,      (numeric) The total bytes sent\n"
             "          \"bytesrecv\": n,      (numeric) The total bytes received\n"
+            "          \"recvbytescopied\": n, (numeric) The total bytes copied into receive buffers, including any\n"
+            "                                 moved while growing them\n"
+            "          \"recvbuffersreused\": n, (numeric) The number of receive buffers reused from the stream's pool\n"
             "          \"sendsize\": n,       (numeric) Current size of queued messages for sending\n"
             "          \"recvsize\": n,       (numeric) Current size of queued messages for receiving\n"
             "          \"spotrecvbw\": n,     (numeric) The spot average download bandwidth over this stream (bytes/sec)\n"
@@ -203,6 +206,8 @@ static UniValue getpeerinfo(const Config &config,
             streamDetails.push_back(Pair("lastrecv", streamStats.nLastRecv));
             streamDetails.push_back(Pair("bytessent", streamStats.nSendBytes));
             streamDetails.push_back(Pair("bytesrecv", streamStats.nRecvBytes));
+            streamDetails.push_back(Pair("recvbytescopied", streamStats.nRecvBytesCopied));
+            streamDetails.push_back(Pair("recvbuffersreused", streamStats.nRecvBuffersReused));
             streamDetails.push_back(Pair("sendsize", streamStats.nSendSize));
             streamDetails.push_back(Pair("recvsize", streamStats.nRecvSize));
             streamDetails.push_back(Pair("spotrecvbw", streamStats.nSpotBytesPerSec));
@@ -553,6 +558,21 @@ static UniValue getnetworkinfo(const Config &config,
             "of connections\n"
             "  \"addresscount\": xxxxx,                 (numeric) number of known peer addresses\n"
             "  \"streampolicies\": \"xxxxxxxxxxxxxxx\", (string) list of available stream policies to use\n"
+            "  \"networkworkers\": [                    (array) load of the threads servicing "
+            "peer sockets (empty if select is used)\n"
+            "  {\n"
+            "    \"id\": xxxxx,                         (numeric) worker id\n"
+            "    \"streams\": xxxxx,                    (numeric) number of peer streams "
+            "serviced by the worker\n"
+            "    \"wakeups\": xxxxx,                    (numeric) number of times the worker "
+            "woke up to service sockets\n"
+            "    \"busytime\": x.xxx,                   (numeric) total time in seconds spent "
+            "servicing sockets\n"
+            "    \"bytessent\": xxxxx,                  (numeric) total bytes sent\n"
+            "    \"bytesrecv\": xxxxx                   (numeric) total bytes received\n"
+            "  }\n"
+            "  ,...\n"
+            "  ],\n"
             "  \"networkactive\": true|false,           (bool) whether p2p "
             "networking is enabled\n"
             "  \"networks\": [                          (array) information "
@@ -626,6 +646,22 @@ static UniValue getnetworkinfo(const Config &config,
             streamPoliciesStr << policy;
         }
         obj.push_back(Pair("streampolicies", streamPoliciesStr.str()));
+
+        // Network worker load
+        std::vector<NetworkWorkerStats> workerStats {};
+        g_connman->GetNetworkWorkerStats(workerStats);
+        UniValue workers(UniValue::VARR);
+        for (const NetworkWorkerStats& stats : workerStats) {
+            UniValue worker(UniValue::VOBJ);
+            worker.push_back(Pair("id", static_cast<uint64_t>(stats.id)));
+            worker.push_back(Pair("streams", static_cast<uint64_t>(stats.nStreams)));
+            worker.push_back(Pair("wakeups", stats.nWakeups));
+            worker.push_back(Pair("busytime", static_cast<double>(stats.nBusyMicros) / MICROS_PER_SECOND));
+            worker.push_back(Pair("bytessent", stats.nSendBytes));
+            worker.push_back(Pair("bytesrecv", stats.nRecvBytes));
+            workers.push_back(worker);
+        }
+        obj.push_back(Pair("networkworkers", workers));
     }
 
     obj.push_back(Pair("networks", GetNetworksInfo()));
@@ -345,7 +345,7 @@ static CBlockIndex* GetBlockIndex(const Config& config,
 /*
  * Returns a block file stream reader for a given block index
  */
-static std::unique_ptr<CBlockStreamReader<CFileReader>>  GetBlockStream(CBlockIndex& pblockindex)
+static std::unique_ptr<CBlockStreamReader<CReadAheadFileReader>>  GetBlockStream(CBlockIndex& pblockindex)
 {
     auto stream = pblockindex.GetDiskBlockStreamReader();
     if (!stream)
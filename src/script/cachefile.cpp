@@ -0,0 +1,122 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "script/cachefile.h"
+#include "clientversion.h"
+#include "crypto/sha256.h"
+#include "streams.h"
+#include "util.h"
+
+#include <cstring>
+
+namespace
+{
+    constexpr uint32_t CACHE_FILE_VERSION = 1;
+}
+
+bool WriteCacheFile(const fs::path& path, const std::string& name, const CacheFileContents& contents)
+{
+    fs::path tmpPath { path };
+    tmpPath += ".new";
+
+    try
+    {
+        CAutoFile file { fsbridge::fopen(tmpPath, "wb"), SER_DISK, CLIENT_VERSION };
+        if(file.IsNull())
+        {
+            LogPrintf("Failed to open %s for writing\n", tmpPath.string());
+            return false;
+        }
+
+        CSHA256 hasher {};
+        const auto write = [&file, &hasher](const char* data, size_t size)
+        {
+            file.write(data, size);
+            hasher.Write(reinterpret_cast<const uint8_t*>(data), size);
+        };
+
+        CDataStream header { SER_DISK, CLIENT_VERSION };
+        header << name << CACHE_FILE_VERSION << contents.nonce;
+        WriteCompactSize(header, contents.sets.size());
+        write(header.data(), header.size());
+
+        // Entries are written directly rather than through a stream to avoid
+        // making another copy of a possibly large cache
+        for(const auto& set : contents.sets)
+        {
+            CDataStream count { SER_DISK, CLIENT_VERSION };
+            WriteCompactSize(count, set.size());
+            write(count.data(), count.size());
+            write(reinterpret_cast<const char*>(set.data()), set.size() * sizeof(uint256));
+        }
+
+        uint256 checksum {};
+        hasher.Finalize(checksum.begin());
+        file << checksum;
+
+        FileCommit(file.Get());
+        file.reset();
+        return RenameOver(tmpPath, path);
+    }
+    catch(const std::exception& e)
+    {
+        LogPrintf("Failed to write %s: %s\n", path.string(), e.what());
+        return false;
+    }
+}
+
+std::optional<CacheFileContents> ReadCacheFile(const fs::path& path, const std::string& name, size_t numSets)
+{
+    try
+    {
+        CAutoFile file { fsbridge::fopen(path, "rb"), SER_DISK, CLIENT_VERSION };
+        if(file.IsNull())
+        {
+            return std::nullopt;
+        }
+
+        CSerializeData data(fs::file_size(path));
+        file.read(data.data(), data.size());
+        if(data.size() < sizeof(uint256))
+        {
+            LogPrintf("Cache file %s is truncated\n", path.string());
+            return std::nullopt;
+        }
+
+        uint256 checksum {};
+        CSHA256().Write(reinterpret_cast<const uint8_t*>(data.data()), data.size() - sizeof(uint256))
+                 .Finalize(checksum.begin());
+        if(memcmp(checksum.begin(), data.data() + data.size() - sizeof(uint256), sizeof(uint256)) != 0)
+        {
+            LogPrintf("Cache file %s checksum mismatch\n", path.string());
+            return std::nullopt;
+        }
+
+        CDataStream stream { SER_DISK, CLIENT_VERSION };
+        stream.SwapBuffer(data);
+
+        std::string fileName {};
+        uint32_t version {0};
+        CacheFileContents contents {};
+        stream >> fileName >> version;
+        if(fileName != name || version != CACHE_FILE_VERSION)
+        {
+            LogPrintf("Cache file %s is not a version %u %s file\n", path.string(), CACHE_FILE_VERSION, name);
+            return std::nullopt;
+        }
+        stream >> contents.nonce >> contents.sets;
+        if(contents.sets.size() != numSets || stream.size() != sizeof(uint256))
+        {
+            LogPrintf("Cache file %s has unexpected contents\n", path.string());
+            return std::nullopt;
+        }
+
+        return contents;
+    }
+    catch(const std::exception& e)
+    {
+        LogPrintf("Failed to read %s: %s\n", path.string(), e.what());
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,48 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_SCRIPT_CACHEFILE_H
+#define MVC_SCRIPT_CACHEFILE_H
+
+#include "fs.h"
+#include "uint256.h"
+
+#include <optional>
+#include <string>
+#include <vector>
+
+/**
+ * Contents of a signature or script execution cache saved to disk.
+ *
+ * Cache entries are hashes salted with a random nonce, so the nonce is saved
+ * with them and must be restored together with the entries for them to be
+ * found again.
+ */
+struct CacheFileContents
+{
+    uint256 nonce {};
+    // Entries of each of the cache's sets, oldest first
+    std::vector<std::vector<uint256>> sets {};
+};
+
+/**
+ * Save cache contents to a file, replacing it atomically.
+ *
+ * File format:
+ *
+ *     string   cache-name
+ *     uint32   format-version
+ *     uint256  nonce
+ *     vector   sets                 each a vector of uint256 entries
+ *     uint256  checksum             SHA256 of all preceding bytes
+ */
+bool WriteCacheFile(const fs::path& path, const std::string& name, const CacheFileContents& contents);
+
+/**
+ * Load cache contents from a file. Returns nothing if there is no file or if
+ * it isn't a valid file for the named cache with the given number of sets.
+ */
+std::optional<CacheFileContents> ReadCacheFile(const fs::path& path, const std::string& name, size_t numSets);
+
+#endif // MVC_SCRIPT_CACHEFILE_H
@@ -1337,8 +1337,16 @@ std::optional<bool> EvalScript(
                         // Remove signature for pre-fork scripts
                         CleanupScriptCode(scriptCode, vchSig.GetElement(), flags);
 
-                        bool fSuccess = checker.CheckSig(vchSig.GetElement(), vchPubKey.GetElement(),
-                                                         scriptCode, flags & SCRIPT_ENABLE_SIGHASH_FORKID);
+                        // With NULLFAIL a non-empty signature that fails
+                        // fails the script, so its verification can be
+                        // deferred.
+                        const bool fDeferrable =
+                            (flags & SCRIPT_VERIFY_NULLFAIL) && vchSig.size();
+                        bool fSuccess = fDeferrable
+                            ? checker.CheckSigDeferrable(vchSig.GetElement(), vchPubKey.GetElement(),
+                                                         scriptCode, flags & SCRIPT_ENABLE_SIGHASH_FORKID)
+                            : checker.CheckSig(vchSig.GetElement(), vchPubKey.GetElement(),
+                                               scriptCode, flags & SCRIPT_ENABLE_SIGHASH_FORKID);
 
                         if (!fSuccess && (flags & SCRIPT_VERIFY_NULLFAIL) &&
                             vchSig.size()) {
@@ -1934,6 +1942,18 @@ bool TransactionSignatureChecker::VerifySignature(
 bool TransactionSignatureChecker::CheckSig(
     const std::vector<uint8_t> &vchSigIn, const std::vector<uint8_t> &vchPubKey,
     const CScript &scriptCode, bool enabledSighashForkid) const {
+    return DoCheckSig(vchSigIn, vchPubKey, scriptCode, enabledSighashForkid, false);
+}
+
+bool TransactionSignatureChecker::CheckSigDeferrable(
+    const std::vector<uint8_t> &vchSigIn, const std::vector<uint8_t> &vchPubKey,
+    const CScript &scriptCode, bool enabledSighashForkid) const {
+    return DoCheckSig(vchSigIn, vchPubKey, scriptCode, enabledSighashForkid, true);
+}
+
+bool TransactionSignatureChecker::DoCheckSig(
+    const std::vector<uint8_t> &vchSigIn, const std::vector<uint8_t> &vchPubKey,
+    const CScript &scriptCode, bool enabledSighashForkid, bool deferrable) const {
     CPubKey pubkey(vchPubKey);
     if (!pubkey.IsValid()) {
         return false;
@@ -1950,6 +1970,9 @@ bool TransactionSignatureChecker::CheckSig(
     uint256 sighash = SignatureHash(scriptCode, *txTo, nIn, sigHashType, amount,
                                     this->txdata, enabledSighashForkid);
 
+    if (deferrable) {
+        return DeferSignature(vchSig, pubkey, sighash);
+    }
     if (!VerifySignature(vchSig, pubkey, sighash)) {
         return false;
     }
@@ -46,6 +46,18 @@ public:
         return false;
     }
 
+    /**
+     * Same as CheckSig(), for signatures that make the whole script fail if
+     * they are invalid. The checker may then defer verifying the signature
+     * and report success, as long as it fails the script later if the
+     * signature turns out to be invalid.
+     */
+    virtual bool CheckSigDeferrable(const std::vector<uint8_t> &scriptSig,
+                                    const std::vector<uint8_t> &vchPubKey,
+                                    const CScript &scriptCode, bool enabledSighashForkid) const {
+        return CheckSig(scriptSig, vchPubKey, scriptCode, enabledSighashForkid);
+    }
+
     virtual bool CheckLockTime(const CScriptNum &nLockTime) const {
         return false;
     }
@@ -64,11 +76,23 @@ private:
     const Amount amount;
     const PrecomputedTransactionData *txdata;
 
+    bool DoCheckSig(const std::vector<uint8_t> &scriptSig,
+                    const std::vector<uint8_t> &vchPubKey,
+                    const CScript &scriptCode, bool enabledSighashForkid,
+                    bool deferrable) const;
+
 protected:
     virtual bool VerifySignature(const std::vector<uint8_t> &vchSig,
                                  const CPubKey &vchPubKey,
                                  const uint256 &sighash) const;
 
+    // Called instead of VerifySignature() when verification may be deferred
+    virtual bool DeferSignature(const std::vector<uint8_t> &vchSig,
+                                const CPubKey &vchPubKey,
+                                const uint256 &sighash) const {
+        return VerifySignature(vchSig, vchPubKey, sighash);
+    }
+
 public:
     TransactionSignatureChecker(const CTransaction *txToIn, unsigned int nInIn,
                                 const Amount amountIn)
@@ -80,6 +104,9 @@ public:
     bool CheckSig(const std::vector<uint8_t> &scriptSig,
                   const std::vector<uint8_t> &vchPubKey,
                   const CScript &scriptCode, bool enabledSighashForkid) const override;
+    bool CheckSigDeferrable(const std::vector<uint8_t> &scriptSig,
+                            const std::vector<uint8_t> &vchPubKey,
+                            const CScript &scriptCode, bool enabledSighashForkid) const override;
     bool CheckLockTime(const CScriptNum &nLockTime) const override;
     bool CheckSequence(const CScriptNum &nSequence) const override;
 };
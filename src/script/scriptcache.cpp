@@ -9,6 +9,7 @@
 #include "cuckoocache.h"
 #include "primitives/transaction.h"
 #include "random.h"
+#include "script/cachefile.h"
 #include "script/sigcache.h"
 #include "util.h"
 #include <mutex>
@@ -16,6 +17,7 @@
 std::mutex cs_script_cache;
 static auto scriptExecutionCache =
     std::make_unique<CuckooCache::cache<uint256, SignatureCacheHasher>>();
+// Only changed by LoadScriptExecutionCache() before the cache is used
 static uint256 scriptExecutionCacheNonce(GetRandHash());
 
 static void InitScriptExecutionCacheUnlocked() 
@@ -47,6 +49,10 @@ void ClearCache()
 }
 
 uint256 GetScriptCacheKey(const CTransaction &tx, uint32_t flags) {
+    return GetScriptCacheKey(tx.GetHash(), flags);
+}
+
+uint256 GetScriptCacheKey(const uint256 &txHash, uint32_t flags) {
     uint256 key;
     // We only use the first 19 bytes of nonce to avoid a second SHA round -
     // giving us 19 + 32 + 4 = 55 bytes (+ 8 + 1 = 64)
@@ -54,7 +60,7 @@ uint256 GetScriptCacheKey(const CTransaction &tx, uint32_t flags) {
                   "Want at least 128 bits of nonce for script execution cache");
     CSHA256()
         .Write(scriptExecutionCacheNonce.begin(), 55 - sizeof(flags) - 32)
-        .Write(tx.GetHash().begin(), 32)
+        .Write(txHash.begin(), 32)
         .Write((uint8_t *)&flags, sizeof(flags))
         .Finalize(key.begin());
 
@@ -69,4 +75,28 @@ bool IsKeyInScriptCache(uint256 key, bool erase) {
 void AddKeyInScriptCache(uint256 key) {
     std::lock_guard lock{cs_script_cache};
     scriptExecutionCache->insert(key);
-}
\ No newline at end of file
+}
+
+void DumpScriptExecutionCache() {
+    CacheFileContents contents {scriptExecutionCacheNonce, {{}}};
+    {
+        std::lock_guard lock{cs_script_cache};
+        scriptExecutionCache->for_each_live(
+            [&contents](const uint256 &key) { contents.sets[0].push_back(key); });
+    }
+    if (WriteCacheFile(GetDataDir() / "scriptcache.dat", "scriptcache", contents)) {
+        LogPrintf("Dumped script execution cache: %zu entries\n", contents.sets[0].size());
+    }
+}
+
+void LoadScriptExecutionCache() {
+    const auto contents = ReadCacheFile(GetDataDir() / "scriptcache.dat", "scriptcache", 1);
+    if (contents) {
+        std::lock_guard lock{cs_script_cache};
+        scriptExecutionCacheNonce = contents->nonce;
+        for (const uint256 &key : contents->sets[0]) {
+            scriptExecutionCache->insert(key);
+        }
+        LogPrintf("Loaded script execution cache: %zu entries\n", contents->sets[0].size());
+    }
+}
@@ -29,10 +29,22 @@ void ClearCache();
 /** Compute the cache key for a given transaction and flags. */
 uint256 GetScriptCacheKey(const CTransaction &tx, uint32_t flags);
 
+/** Compute the cache key for a given transaction hash and flags. */
+uint256 GetScriptCacheKey(const uint256 &txHash, uint32_t flags);
+
 /** Check if a given key is in the cache. */
 bool IsKeyInScriptCache(uint256 key, bool erase);
 
 /** Add an entry in the cache. */
 void AddKeyInScriptCache(uint256 key);
 
+/** Save the cache to the data directory. */
+void DumpScriptExecutionCache();
+
+/**
+ * Restore the cache saved by DumpScriptExecutionCache(). Must be called after
+ * InitScriptExecutionCache() and before the cache is used.
+ */
+void LoadScriptExecutionCache();
+
 #endif // MVC_SCRIPT_SCRIPTCACHE_H
@@ -8,10 +8,13 @@
 #include "cuckoocache.h"
 #include "pubkey.h"
 #include "random.h"
+#include "script/cachefile.h"
 #include "uint256.h"
 #include "util.h"
 
-#include <boost/thread.hpp>
+#include <array>
+#include <mutex>
+#include <shared_mutex>
 
 namespace {
 
@@ -22,15 +25,47 @@ namespace {
  * Invalid signature cache, to avoid doing expensive ECDSA signature checking
  * in case of an attack (invalid signature is cached and does not need to be
  * calculated again).
+ *
+ * Lookups come from all script validation threads at once, so rather than
+ * one cache behind a single lock the entries are spread over independent
+ * shards, each with its own lock on its own cache line. Entries are
+ * uniformly distributed hashes, so the shard is picked directly from the
+ * entry's bits.
  */
 class CSignatureCache {
 private:
+    static constexpr size_t NUM_SHARDS = 16;
+    static_assert((NUM_SHARDS & (NUM_SHARDS - 1)) == 0,
+                  "NUM_SHARDS must be a power of two");
+
+    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
+
+    struct alignas(64) Shard {
+        std::shared_mutex cs_sigcache;
+        map_type setValid;
+        map_type setInvalid;
+    };
+
     //! Entries are SHA256(nonce || signature hash || public key || signature):
     uint256 nonce;
-    typedef CuckooCache::cache<uint256, SignatureCacheHasher> map_type;
-    map_type setValid;
-    map_type setInvalid;
-    boost::shared_mutex cs_sigcache;
+    std::array<Shard, NUM_SHARDS> shards;
+
+    // SignatureCacheHasher takes the low bits of each 32 bit word, so use
+    // high bits of the last byte which the per-shard caches are too small
+    // to ever use.
+    Shard &GetShard(const uint256 &entry) {
+        return shards[(entry.begin()[31] >> 4) & (NUM_SHARDS - 1)];
+    }
+
+    // Set up every shard with an equal share of the given size
+    template <typename Setup>
+    uint32_t SetupShards(size_t n, Setup setup) {
+        uint32_t total = 0;
+        for (Shard &shard : shards) {
+            total += setup(shard, n / NUM_SHARDS);
+        }
+        return total;
+    }
 
 public:
     CSignatureCache() { GetRandBytes(nonce.begin(), 32); }
@@ -47,28 +82,61 @@ public:
     }
 
     bool Get(const uint256 &entry, const bool erase) {
-        boost::shared_lock<boost::shared_mutex> lock(cs_sigcache);
-        return setValid.contains(entry, erase);
+        Shard &shard = GetShard(entry);
+        std::shared_lock lock(shard.cs_sigcache);
+        return shard.setValid.contains(entry, erase);
     }
 
     bool GetInvalid(const uint256 &entry, const bool erase) {
-        boost::shared_lock lock(cs_sigcache);
-        return setInvalid.contains(entry, erase);
+        Shard &shard = GetShard(entry);
+        std::shared_lock lock(shard.cs_sigcache);
+        return shard.setInvalid.contains(entry, erase);
+    }
+
+    void Set(const uint256 &entry) {
+        Shard &shard = GetShard(entry);
+        std::unique_lock lock(shard.cs_sigcache);
+        shard.setValid.insert(entry);
+    }
+
+    void SetInvalid(const uint256 &entry) {
+        Shard &shard = GetShard(entry);
+        std::unique_lock lock(shard.cs_sigcache);
+        shard.setInvalid.insert(entry);
     }
 
-    void Set(uint256 &entry) {
-        boost::unique_lock<boost::shared_mutex> lock(cs_sigcache);
-        setValid.insert(entry);
+    uint32_t setup_bytes(size_t n) {
+        return SetupShards(n, [](Shard &shard, size_t bytes) {
+            return shard.setValid.setup_bytes(bytes);
+        });
     }
 
-    void SetInvalid(uint256 &entry) {
-        std::scoped_lock lock(cs_sigcache);
-        setInvalid.insert(entry);
+    uint32_t setup_bytes_invalid(size_t n) {
+        return SetupShards(n, [](Shard &shard, size_t bytes) {
+            return shard.setInvalid.setup_bytes(bytes);
+        });
     }
 
-    uint32_t setup_bytes(size_t n) { return setValid.setup_bytes(n); }
+    CacheFileContents GetContents() {
+        CacheFileContents contents {nonce, {{}, {}}};
+        for (Shard &shard : shards) {
+            std::unique_lock lock(shard.cs_sigcache);
+            shard.setValid.for_each_live([&contents](const uint256 &entry) { contents.sets[0].push_back(entry); });
+            shard.setInvalid.for_each_live([&contents](const uint256 &entry) { contents.sets[1].push_back(entry); });
+        }
+        return contents;
+    }
 
-    uint32_t setup_bytes_invalid(size_t n) { return setInvalid.setup_bytes(n); }
+    // Replaces the nonce, so it must be called before the cache is used
+    void SetContents(const CacheFileContents &contents) {
+        nonce = contents.nonce;
+        for (const uint256 &entry : contents.sets[0]) {
+            Set(entry);
+        }
+        for (const uint256 &entry : contents.sets[1]) {
+            SetInvalid(entry);
+        }
+    }
 };
 
 /**
@@ -97,6 +165,22 @@ void InitSignatureCache() {
     initCache("-maxinvalidsigcachesize", DEFAULT_INVALID_MAX_SIG_CACHE_SIZE, "invalid ", signatureCache, &CSignatureCache::setup_bytes_invalid);
 }
 
+void DumpSignatureCache() {
+    const CacheFileContents contents = signatureCache.GetContents();
+    if (WriteCacheFile(GetDataDir() / "sigcache.dat", "sigcache", contents)) {
+        LogPrintf("Dumped signature cache: %zu valid, %zu invalid entries\n",
+                  contents.sets[0].size(), contents.sets[1].size());
+    }
+}
+
+void LoadSignatureCache() {
+    const auto contents = ReadCacheFile(GetDataDir() / "sigcache.dat", "sigcache", 2);
+    if (contents) {
+        signatureCache.SetContents(*contents);
+        LogPrintf("Loaded signature cache: %zu valid, %zu invalid entries\n",
+                  contents->sets[0].size(), contents->sets[1].size());
+    }
+}
 
 bool CachingTransactionSignatureChecker::VerifySignature(
     const std::vector<uint8_t> &vchSig, const CPubKey &pubkey,
@@ -121,3 +205,23 @@ bool CachingTransactionSignatureChecker::VerifySignature(
     }
     return true;
 }
+
+bool CachingTransactionSignatureChecker::DeferSignature(
+    const std::vector<uint8_t> &vchSig, const CPubKey &pubkey,
+    const uint256 &sighash) const {
+    // Results of deferred signatures are never stored in the cache
+    if (!batch || store) {
+        return VerifySignature(vchSig, pubkey, sighash);
+    }
+
+    uint256 entry;
+    signatureCache.ComputeEntry(entry, sighash, vchSig, pubkey);
+    if (signatureCache.Get(entry, true)) {
+        return true;
+    }
+    if (signatureCache.GetInvalid(entry, true)) {
+        return false;
+    }
+    batch->Add(pubkey, sighash, vchSig);
+    return true;
+}
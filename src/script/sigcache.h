@@ -7,6 +7,7 @@
 #ifndef MVC_SCRIPT_SIGCACHE_H
 #define MVC_SCRIPT_SIGCACHE_H
 
+#include "pubkey.h"
 #include "script/interpreter.h"
 
 #include <vector>
@@ -24,7 +25,8 @@ static const unsigned int DEFAULT_INVALID_MAX_SIG_CACHE_SIZE = 32;
 // Maximum sig cache size allowed
 static const int64_t MAX_MAX_SIG_CACHE_SIZE = 16384;
 
-class CPubKey;
+// Default for -persistsigcache
+static const bool DEFAULT_PERSIST_SIG_CACHE = false;
 
 /**
  * We're hashing a nonce into the entries themselves, so we don't need extra
@@ -49,20 +51,37 @@ public:
 class CachingTransactionSignatureChecker : public TransactionSignatureChecker {
 private:
     bool store;
+    // Where signatures not found in the cache are deferred to, if set
+    CSignatureBatch *batch;
 
 public:
     CachingTransactionSignatureChecker(const CTransaction *txToIn,
                                        unsigned int nInIn, const Amount amount,
                                        bool storeIn,
-                                       PrecomputedTransactionData &txdataIn)
+                                       PrecomputedTransactionData &txdataIn,
+                                       CSignatureBatch *batchIn = nullptr)
         : TransactionSignatureChecker(txToIn, nInIn, amount, txdataIn),
-          store(storeIn) {}
+          store(storeIn), batch(batchIn) {}
 
     bool VerifySignature(const std::vector<uint8_t> &vchSig,
                          const CPubKey &vchPubKey,
                          const uint256 &sighash) const override;
+
+protected:
+    bool DeferSignature(const std::vector<uint8_t> &vchSig,
+                        const CPubKey &vchPubKey,
+                        const uint256 &sighash) const override;
 };
 
 void InitSignatureCache();
 
+/** Save the signature cache to the data directory */
+void DumpSignatureCache();
+
+/**
+ * Restore the signature cache saved by DumpSignatureCache(). Must be called
+ * after InitSignatureCache() and before the cache is used.
+ */
+void LoadSignatureCache();
+
 #endif // MVC_SCRIPT_SIGCACHE_H
@@ -213,6 +213,7 @@ public:
     bool empty() const { return vch.size() == nReadPos; }
     void resize(size_type n, value_type c = 0) { vch.resize(n + nReadPos, c); }
     void reserve(size_type n) { vch.reserve(n + nReadPos); }
+    size_type capacity() const { return vch.capacity() - nReadPos; }
     const_reference operator[](size_type pos) const {
         return vch[pos + nReadPos];
     }
@@ -383,6 +384,16 @@ public:
         clear();
     }
 
+    /**
+     * Exchange our underlying storage with the given buffer and reset the
+     * read position, allowing allocated buffers to be handed between
+     * streams without copying.
+     */
+    void SwapBuffer(CSerializeData &d) {
+        vch.swap(d);
+        nReadPos = 0;
+    }
+
     /**
      * XOR the contents of this stream with a certain key.
      *
@@ -514,6 +525,8 @@ public:
     }
 };
 
+class CForwardReadonlyStream;
+
 /**
  * Non-refcounted RAII wrapper around a FILE* that implements a ring buffer to
  * deserialize from. It guarantees the ability to rewind a given number of
@@ -521,6 +534,9 @@ public:
  *
  * Will automatically close the file when it goes out of scope if not null. If
  * you need to close the file early, use file.fclose() instead of fclose(file).
+ *
+ * Instead of the file the data can be provided by a stream (e.g. a reader that
+ * reads ahead of the consumer) in which case src only carries type and version.
  */
 class CBufferedFile {
 private:
@@ -530,6 +546,8 @@ private:
 
     // source file
     CAutoFile src;
+    // source stream - used instead of src if set
+    std::unique_ptr<CForwardReadonlyStream> source;
     // how many bytes have been read from source
     uint64_t nSrcPos;
     // how many bytes have been read from this
@@ -549,6 +567,7 @@ protected:
         unsigned int nAvail = vchBuf.size() - (nSrcPos - nReadPos) - nRewind;
         if (nAvail < readNow) readNow = nAvail;
         if (readNow == 0) return false;
+        if (source) return FillFromSource(pos, readNow);
         size_t read = fread((void *)&vchBuf[pos], 1, readNow, src.Get());
         if (read == 0) {
             throw std::ios_base::failure(
@@ -560,6 +579,10 @@ protected:
         }
     }
 
+    // defined after CForwardReadonlyStream
+    bool FillFromSource(unsigned int pos, unsigned int readNow);
+    bool SourceEndOfStream() const;
+
 public:
     CBufferedFile( CAutoFile&& fileIn, uint64_t nBufSize, uint64_t nRewindIn )
         : src{ std::move(fileIn) }
@@ -570,6 +593,18 @@ public:
         , vchBuf(nBufSize, 0)
     {}
 
+    CBufferedFile(std::unique_ptr<CForwardReadonlyStream> sourceIn,
+                  uint64_t nBufSize, uint64_t nRewindIn,
+                  int nTypeIn, int nVersionIn)
+        : src{ static_cast<FILE*>(nullptr), nTypeIn, nVersionIn }
+        , source{ std::move(sourceIn) }
+        , nSrcPos(0)
+        , nReadPos(0)
+        , nReadLimit((uint64_t)(-1))
+        , nRewind(nRewindIn)
+        , vchBuf(nBufSize, 0)
+    {}
+
     CBufferedFile(FILE *fileIn, uint64_t nBufSize, uint64_t nRewindIn,
                   int nTypeIn, int nVersionIn)
         : src{ fileIn, nTypeIn, nVersionIn }
@@ -583,10 +618,13 @@ public:
     int GetVersion() const { return src.GetVersion(); }
     int GetType() const { return src.GetType(); }
 
-    void reset() { src.reset(); }
+    void reset() { src.reset(); source.reset(); }
 
     // check whether we're at the end of the source file
-    bool eof() const { return nReadPos == nSrcPos && feof(src.Get()); }
+    bool eof() const {
+        return nReadPos == nSrcPos &&
+               (source ? SourceEndOfStream() : feof(src.Get()));
+    }
 
     // read a number of bytes
     void read(char *pch, size_t nSize) {
@@ -693,6 +731,22 @@ public:
     virtual CSpan Read(size_t maxSize) = 0;
 };
 
+inline bool CBufferedFile::FillFromSource(unsigned int pos, unsigned int readNow) {
+    CSpan span = source->Read(readNow);
+    if (span.Size() == 0) {
+        throw std::ios_base::failure(
+            source->EndOfStream() ? "CBufferedFile::Fill: end of file"
+                                  : "CBufferedFile::Fill: read failed");
+    }
+    memcpy(&vchBuf[pos], span.Begin(), span.Size());
+    nSrcPos += span.Size();
+    return true;
+}
+
+inline bool CBufferedFile::SourceEndOfStream() const {
+    return source->EndOfStream();
+}
+
 /**
  * Base class for forward readlonly streams of data that returns the underlying
  * data in chunks of up to requested size.
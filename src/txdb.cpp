@@ -14,11 +14,15 @@
 #include "hash.h"
 #include "init.h"
 #include "pow.h"
+#include "primitives/block.h"
 #include "random.h"
+#include "task_helpers.h"
 #include "uint256.h"
 #include "util.h"
 #include "ui_interface.h"
+#include "undo.h"
 #include <boost/thread.hpp>
+#include <algorithm>
 #include <string>
 #include <vector>
 
@@ -33,6 +37,7 @@ static const char DB_HEAD_BLOCKS = 'H';
 static const char DB_FLAG = 'F';
 static const char DB_REINDEX_FLAG = 'R';
 static const char DB_LAST_BLOCK = 'l';
+static const char DB_UTXO_STATS = 's';
 
 namespace {
 
@@ -139,6 +144,40 @@ public:
     }
 };
 
+namespace {
+
+/**
+ * Unserialize coin at the current iterator position. Script is only
+ * unserialized if it is not larger than maxScriptSize.
+ */
+std::optional<CoinImpl> GetCoinFromIterator(CDBIterator& iterator, uint64_t maxScriptSize)
+{
+    std::optional<CoinImpl> coin{ CoinImpl{} };
+    // If script is not unserialized, this will be set to the actual size of the script.
+    // Otherwise (i.e. if script is unserialized), value will remain unset.
+    std::optional<std::size_t> actualScriptSize;
+    bool res = iterator.GetValue<CDataStreamInput_NoScr>(coin.value(), maxScriptSize, actualScriptSize);
+    if( res )
+    {
+        if(actualScriptSize.has_value())
+        {
+            // Script was not unserialized
+            return {
+                CoinImpl{
+                    coin->GetTxOut().nValue,
+                    *actualScriptSize,
+                    coin->GetHeight(),
+                    coin->IsCoinBase()}};
+        }
+
+        return coin;
+    }
+
+    return {};
+}
+
+} // anonymous namespace
+
 std::optional<CoinImpl> CoinsDB::DBGetCoin(const COutPoint &outpoint, uint64_t maxScriptSize) const {
     try
     {
@@ -192,21 +231,86 @@ std::vector<uint256> CoinsDB::GetHeadBlocks() const {
     return vhashHeadBlocks;
 }
 
-bool CoinsDB::DBBatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
-    CDBBatch batch(db);
-    size_t count = 0;
+namespace {
+    void WriteCoinToBatch(CDBBatch& batch, const COutPoint& outpoint, const CCoinsCacheEntry& entry)
+    {
+        CoinEntry key(&outpoint);
+        if (entry.GetCoinImpl().IsSpent()) {
+            batch.Erase(key);
+        } else {
+            auto coinWithScript = entry.GetCoinWithScript();
+
+            // coin entries that have DIRTY flag set and are not spent
+            // must always contain the script
+            assert(coinWithScript.has_value());
+
+            batch.Write(key, coinWithScript.value());
+        }
+    }
+}
+
+bool CoinsDB::DBBatchWrite(
+    CCoinsMap &mapCoins,
+    const uint256 &hashBlock,
+    const std::optional<UTXOSetStats>& stats) {
+    const size_t count = mapCoins.size();
     size_t changed = 0;
-    size_t batch_size =
+
+    CoinsStore::DirtyEntries rewritten;
+    for (const auto& outpoint : mTransitionWritten) {
+        auto it = mapCoins.find(outpoint);
+        if (it != mapCoins.end() && (it->second.flags & CCoinsCacheEntry::DIRTY)) {
+            rewritten.emplace_back(&it->first, &it->second);
+        }
+    }
+    DBBeginWrite(hashBlock, rewritten);
+
+    // Entries are dropped as soon as they are written so that memory used by
+    // the written part can be reused while the rest is being written.
+    const size_t chunkSize = GetWriteChunkSize();
+    while (!mapCoins.empty()) {
+        CoinsStore::DirtyEntries chunk;
+        size_t chunkUsage = 0;
+        auto it = mapCoins.begin();
+        for (; it != mapCoins.end() && chunkUsage < chunkSize; ++it) {
+            if (it->second.flags & CCoinsCacheEntry::DIRTY) {
+                chunk.emplace_back(&it->first, &it->second);
+                chunkUsage += sizeof(CCoinsMap::value_type) + it->second.DynamicMemoryUsage();
+            }
+        }
+        DBWriteCoins(chunk);
+        changed += chunk.size();
+        mapCoins.erase(mapCoins.begin(), it);
+    }
+
+    DBEndWrite(hashBlock, stats);
+    ++mBatchWriteCount;
+
+    LogPrint(BCLog::COINDB, "Committed %u changed transaction outputs (out of "
+                            "%u) to coin database...\n",
+             (unsigned int)changed, (unsigned int)count);
+    return true;
+}
+
+size_t CoinsDB::GetWriteChunkSize() const {
+    const size_t batch_size =
         (size_t)gArgs.GetArgAsBytes("-dbbatchsize", nDefaultDbBatchSize);
-    int crash_simulate = gArgs.GetArg("-dbcrashratio", 0);
+    const size_t numberOfThreads = mWorkerThreadPool ? mWorkerThreadPool->getPoolSize() : 0;
+    return batch_size * (numberOfThreads + 1);
+}
+
+void CoinsDB::DBBeginWrite(
+    const uint256& hashBlock,
+    const CoinsStore::DirtyEntries& rewritten) {
     assert(!hashBlock.IsNull());
 
     uint256 old_tip = DBGetBestBlock();
     if (old_tip.IsNull()) {
-        // We may be in the middle of replaying.
+        // We may be in the middle of replaying or continuing an unfinished
+        // transition.
         std::vector<uint256> old_heads = GetHeadBlocks();
         if (old_heads.size() == 2) {
-            assert(old_heads[0] == hashBlock);
+            assert(old_heads[0] == hashBlock || !mTransitionTarget.IsNull());
             old_tip = old_heads[1];
         }
     }
@@ -215,54 +319,112 @@ bool CoinsDB::DBBatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock) {
     // transition from old_tip to hashBlock.
     // A vector is used for future extensibility, as we may want to support
     // interrupting after partial writes from multiple independent reorgs.
+    CDBBatch batch(db);
     batch.Erase(DB_BEST_BLOCK);
+    batch.Erase(DB_UTXO_STATS);
     batch.Write(DB_HEAD_BLOCKS, std::vector<uint256>{hashBlock, old_tip});
-
-    for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
-        if (it->second.flags & CCoinsCacheEntry::DIRTY) {
-            CoinEntry entry(&it->first);
-            if (it->second.GetCoin().IsSpent()) {
-                batch.Erase(entry);
-            } else {
-                auto coinWithScript = it->second.GetCoinWithScript();
-
-                // coin entries that have DIRTY flag set and are not spent must
-                // always contain the script
-                assert(coinWithScript.has_value());
-
-                batch.Write(entry, coinWithScript.value());
-            }
-            changed++;
-        }
-        count++;
-        CCoinsMap::iterator itOld = it++;
-        mapCoins.erase(itOld);
-        if (batch.SizeEstimate() > batch_size) {
-            LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n",
-                     batch.SizeEstimate() * (1.0 / 1048576.0));
-            db.WriteBatch(batch);
-            batch.Clear();
-            if (crash_simulate) {
-                static FastRandomContext rng;
-                if (rng.randrange(crash_simulate) == 0) {
-                    LogPrintf("Simulating a crash. Goodbye.\n");
-                    _Exit(0);
-                }
-            }
-        }
+    for (const auto& [outpoint, entry] : rewritten) {
+        WriteCoinToBatch(batch, *outpoint, *entry);
     }
+    db.WriteBatch(batch);
 
+    mTransitionTarget = hashBlock;
+}
+
+void CoinsDB::DBEndWrite(
+    const uint256& hashBlock,
+    const std::optional<UTXOSetStats>& stats) {
     // In the last batch, mark the database as consistent with hashBlock again.
+    CDBBatch batch(db);
     batch.Erase(DB_HEAD_BLOCKS);
     batch.Write(DB_BEST_BLOCK, hashBlock);
+    if (stats) {
+        batch.Write(DB_UTXO_STATS, stats.value());
+    }
 
     LogPrint(BCLog::COINDB, "Writing final batch of %.2f MiB\n",
              batch.SizeEstimate() * (1.0 / 1048576.0));
-    bool ret = db.WriteBatch(batch);
-    LogPrint(BCLog::COINDB, "Committed %u changed transaction outputs (out of "
-                            "%u) to coin database...\n",
-             (unsigned int)changed, (unsigned int)count);
-    return ret;
+    db.WriteBatch(batch);
+
+    mTransitionTarget.SetNull();
+    mTransitionWritten.clear();
+    mTransitionWritten.shrink_to_fit();
+}
+
+void CoinsDB::DBWriteCoins(const CoinsStore::DirtyEntries& coins) {
+    // Minimum number of coins per shard - smaller shards are not worth the
+    // overhead of an additional task
+    static constexpr size_t MIN_WRITE_SHARD_SIZE = 1024;
+
+    size_t batch_size =
+        (size_t)gArgs.GetArgAsBytes("-dbbatchsize", nDefaultDbBatchSize);
+    int crash_simulate = gArgs.GetArg("-dbcrashratio", 0);
+
+    // Coin keys start with txid so splitting by its first byte gives shards
+    // with disjoint and roughly equally sized key ranges. Order of writes
+    // between shards doesn't matter as each coin is written only once.
+    const size_t numberOfThreads = mWorkerThreadPool ? mWorkerThreadPool->getPoolSize() : 0;
+    const size_t shardsCount =
+        std::max<size_t>(
+            1,
+            std::min(numberOfThreads + 1, coins.size() / MIN_WRITE_SHARD_SIZE));
+    std::vector<CoinsStore::DirtyEntries> shards(shardsCount);
+    for (auto& shard : shards) {
+        shard.reserve(coins.size() / shardsCount + 1);
+    }
+    for (const auto& coin : coins) {
+        shards[*coin.first->GetTxId().begin() * shardsCount / 256].push_back(coin);
+    }
+
+    auto writeShard =
+        [this, batch_size, crash_simulate](const CoinsStore::DirtyEntries& shard)
+        {
+            CDBBatch batch(db);
+            for (const auto& [outpoint, entry] : shard) {
+                WriteCoinToBatch(batch, *outpoint, *entry);
+
+                if (batch.SizeEstimate() > batch_size) {
+                    LogPrint(BCLog::COINDB, "Writing partial batch of %.2f MiB\n",
+                             batch.SizeEstimate() * (1.0 / 1048576.0));
+                    db.WriteBatch(batch);
+                    batch.Clear();
+                    if (crash_simulate) {
+                        FastRandomContext rng;
+                        if (rng.randrange(crash_simulate) == 0) {
+                            LogPrintf("Simulating a crash. Goodbye.\n");
+                            _Exit(0);
+                        }
+                    }
+                }
+            }
+            db.WriteBatch(batch);
+        };
+
+    // The first shard is written on the current thread while the rest are
+    // written by the thread pool. All tasks must finish before we return as
+    // they reference coins so only the first error is rethrown.
+    std::vector<std::future<void>> futures;
+    std::exception_ptr error;
+    try {
+        for (size_t i = 1; i < shards.size(); ++i) {
+            futures.push_back(make_task(*mWorkerThreadPool, writeShard, std::cref(shards[i])));
+        }
+        writeShard(shards[0]);
+    } catch (...) {
+        error = std::current_exception();
+    }
+    for (auto& future : futures) {
+        try {
+            future.get();
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
 }
 
 size_t CoinsDB::EstimateSize() const {
@@ -303,14 +465,7 @@ CCoinsViewDBCursor *CoinsDB::Cursor() const {
      */
     i->pcursor->Seek(DB_COIN);
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
-    } else {
-        // Make sure Valid() and GetKey() return false
-        i->keyTmp.first = 0;
-    }
+    i->UpdateKey();
     return i;
 }
 
@@ -325,18 +480,53 @@ CCoinsViewDBCursor* CoinsDB::Cursor(const TxId &txId) const {
     i->pcursor->Seek(key);
 
     // Cache key of first record
-    if (i->pcursor->Valid()) {
-        CoinEntry entry(&i->keyTmp.second);
-        i->pcursor->GetKey(entry);
-        i->keyTmp.first = entry.key;
-    }
-    else {
-        // Make sure Valid() and GetKey() return false
-        i->keyTmp.first = 0;
-    }
+    i->UpdateKey();
     return i;
 }
 
+uint256 CoinsDB::DBGetBestBlock(const CDBSnapshot &snapshot) const {
+    uint256 hashBestChain;
+    if (!snapshot.Read(DB_BEST_BLOCK, hashBestChain)) return uint256();
+    return hashBestChain;
+}
+
+std::unique_ptr<CCoinsViewDBCursor> CoinsDB::RangeCursor(
+    const CDBSnapshot &snapshot,
+    const uint256 &hashBestChain,
+    size_t index,
+    size_t count) const {
+    assert(count > 0 && count <= MAX_SCAN_RANGES && index < count);
+
+    const uint32_t beginPrefix = CCoinsViewDBCursor::TXID_PREFIX_END * index / count;
+    const uint32_t endPrefix = CCoinsViewDBCursor::TXID_PREFIX_END * (index + 1) / count;
+    std::unique_ptr<CCoinsViewDBCursor> i{
+        new CCoinsViewDBCursor(snapshot.NewIterator(), hashBestChain, endPrefix)};
+
+    uint256 txid;
+    *txid.begin() = static_cast<uint8_t>(beginPrefix >> 8);
+    *(txid.begin() + 1) = static_cast<uint8_t>(beginPrefix);
+    COutPoint op{TxId{txid}, 0};
+    i->pcursor->Seek(CoinEntry(&op));
+
+    // Cache key of first record
+    i->UpdateKey();
+    return i;
+}
+
+void CoinsDB::LogScanCoins(
+    const uint256 &hashBestChain,
+    size_t rangesCount,
+    size_t threadsCount,
+    uint64_t bytesRead,
+    int64_t durationMicros) const {
+    const double mib = bytesRead * (1.0 / 1048576.0);
+    LogPrint(BCLog::COINDB, "Scanned %.2f MiB of coin database at %s in %u "
+                            "ranges using %u threads in %.2fs (%.2f MiB/s)\n",
+             mib, hashBestChain.ToString(), rangesCount, threadsCount,
+             durationMicros * 0.000001,
+             durationMicros ? mib * 1000000.0 / durationMicros : 0.0);
+}
+
 bool CCoinsViewDBCursor::GetKey(COutPoint &key) const {
     // Return cached key
     if (keyTmp.first == DB_COIN) {
@@ -347,28 +537,7 @@ bool CCoinsViewDBCursor::GetKey(COutPoint &key) const {
 }
 
 std::optional<CoinImpl> CCoinsViewDBCursor::GetCoin(uint64_t maxScriptSize) const {
-    std::optional<CoinImpl> coin{ CoinImpl{} };
-    // If script is not unserialized, this will be set to the actual size of the script.
-    // Otherwise (i.e. if script is unserialized), value will remain unset.
-    std::optional<std::size_t> actualScriptSize;
-    bool res = pcursor->GetValue<CDataStreamInput_NoScr>(coin.value(), maxScriptSize, actualScriptSize);
-    if( res )
-    {
-        if(actualScriptSize.has_value())
-        {
-            // Script was not unserialized
-            return {
-                CoinImpl{
-                    coin->GetTxOut().nValue,
-                    *actualScriptSize,
-                    coin->GetHeight(),
-                    coin->IsCoinBase()}};
-        }
-
-        return coin;
-    }
-
-    return {};
+    return GetCoinFromIterator(*pcursor, maxScriptSize);
 }
 
 bool CCoinsViewDBCursor::GetValue(Coin &coin) const {
@@ -398,9 +567,16 @@ bool CCoinsViewDBCursor::Valid() const {
 }
 
 void CCoinsViewDBCursor::Next() {
+    nBytesRead += pcursor->GetKeySize() + pcursor->GetValueSize();
     pcursor->Next();
+    UpdateKey();
+}
+
+void CCoinsViewDBCursor::UpdateKey() {
     CoinEntry entry(&keyTmp.second);
-    if (!pcursor->Valid() || !pcursor->GetKey(entry)) {
+    if (!pcursor->Valid() || !pcursor->GetKey(entry) ||
+        (entry.key == DB_COIN &&
+         GetTxIdPrefix(keyTmp.second.GetTxId()) >= nEndPrefix)) {
         // Invalidate cached key after last record so that Valid() and GetKey()
         // return false
         keyTmp.first = 0;
@@ -473,11 +649,48 @@ CoinsDB::CoinsDB(
         uint64_t cacheSizeThreshold,
         size_t nCacheSize,
         CDBWrapper::MaxFiles maxFiles,
+        size_t workerThreadsCount,
         bool fMemory,
         bool fWipe)
     : db{ GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe, true, maxFiles }
     , mCacheSizeThreshold{cacheSizeThreshold}
-{}
+{
+    if (workerThreadsCount > 0)
+    {
+        mWorkerThreadPool =
+            std::make_unique<CThreadPool<CQueueAdaptor>>(
+                "CoinsDBWorkerPool",
+                workerThreadsCount);
+        mAsyncPrefetchThreadPool =
+            std::make_unique<CThreadPool<CQueueAdaptor>>(
+                "CoinsDBAsyncPrefetchPool",
+                1);
+        mDirtyCoinsWriterThreadPool =
+            std::make_unique<CThreadPool<CQueueAdaptor>>(
+                "CoinsDBDirtyCoinsWriterPool",
+                1);
+    }
+
+    mStatsThreadPool =
+        std::make_unique<CThreadPool<CQueueAdaptor>>(
+            "CoinsDBUTXOStatsPool",
+            1);
+
+    if (UTXOSetStats stats; db.Read(DB_UTXO_STATS, stats))
+    {
+        mDBStats = std::move(stats);
+    }
+    else if (DBGetBestBlock().IsNull() && GetHeadBlocks().empty())
+    {
+        // Empty database - statistics are maintained from the start.
+        mDBStats = UTXOSetStats{};
+    }
+    else
+    {
+        LogPrintf("UTXO set statistics are not available in coins database - "
+                  "use gettxoutsetinfo \"verify\" to initialize them\n");
+    }
+}
 
 size_t CoinsDB::DynamicMemoryUsage() const {
     std::unique_lock lock { mCoinsViewCacheMtx };
@@ -508,18 +721,21 @@ std::optional<CoinImpl> CoinsDB::GetCoin(const COutPoint &outpoint, uint64_t max
                 if (coinFromCache->IsSpent())
                 {
                     guard.release();
+                    ++mCacheHits;
 
                     return {};
                 }
                 else if (coinFromCache->HasScript())
                 {
                     guard.release();
+                    ++mCacheHits;
 
                     return coinFromCache;
                 }
                 else if(maxScriptSize < coinFromCache->GetScriptSize())
                 {
                     guard.release();
+                    ++mCacheHits;
 
                     // make a copy since we will swap the cached value on script load
                     // and we want the child view to re-request the coin from us
@@ -569,6 +785,7 @@ std::optional<CoinImpl> CoinsDB::GetCoin(const COutPoint &outpoint, uint64_t max
     // the rare potential other threads that are waiting for the same outpoint
     // may continue.
 
+    ++mCacheMisses;
     auto coinFromView = DBGetCoin(outpoint, maxScriptLoadingSize);
     if (!coinFromView.has_value())
     {
@@ -611,6 +828,223 @@ std::optional<CoinImpl> CoinsDB::GetCoin(const COutPoint &outpoint, uint64_t max
     return cws.MakeNonOwning();
 }
 
+size_t CoinsDB::PrefetchCoins(std::vector<COutPoint>&& outpoints) const
+{
+    // Don't bother splitting the work into tasks for less than this many coins
+    // per key range.
+    constexpr size_t MIN_PREFETCH_RANGE_SIZE = 1024;
+
+    std::vector<COutPoint> toLoad;
+    toLoad.reserve(outpoints.size());
+    uint64_t maxScriptLoadingSize = 0;
+
+    {
+        std::unique_lock lock { mCoinsViewCacheMtx };
+
+        for (const COutPoint& outpoint : outpoints)
+        {
+            // Skip cached coins and coins that are currently being loaded by
+            // GetCoin() - this also filters out duplicates.
+            if (!mCache.HaveCoin(outpoint) && mFetchingCoins.insert(outpoint).second)
+            {
+                toLoad.push_back(outpoint);
+            }
+        }
+
+        maxScriptLoadingSize = getMaxScriptLoadingSize(0);
+    }
+
+    if (toLoad.empty())
+    {
+        return 0;
+    }
+
+    // Release the outpoints for GetCoin() even if we exit with an exception.
+    auto release =
+        [this](const std::vector<COutPoint>* outpoints)
+        {
+            std::unique_lock lock { mCoinsViewCacheMtx };
+            for (const COutPoint& outpoint : *outpoints)
+            {
+                mFetchingCoins.erase(outpoint);
+            }
+        };
+    std::unique_ptr<const std::vector<COutPoint>, decltype(release)> guard{&toLoad, release};
+
+    // Sorting groups outputs of the same transaction together so lookups
+    // mostly move forward. COutPoint ordering is NOT the same as ordering of
+    // CoinEntry keys in database though: output index is serialized as a
+    // VARINT whose byte order differs from numeric order for n >= 16512
+    // (e.g. key of output 16512 precedes key of output 16511). Hence every
+    // key that is not at the cursor position must be sought - this can't be
+    // replaced with a forward-only scan.
+    std::sort(toLoad.begin(), toLoad.end());
+
+    using LoadedCoins = std::vector<std::pair<COutPoint, CoinImpl>>;
+    auto loadRange =
+        [this, maxScriptLoadingSize](
+            std::vector<COutPoint>::const_iterator begin,
+            std::vector<COutPoint>::const_iterator end)
+        {
+            LoadedCoins loaded;
+            loaded.reserve(std::distance(begin, end));
+
+            // It seems that there are no "const iterators" for LevelDB. Since
+            // we only need read operations on it, use a const-cast to get
+            // around that restriction.
+            std::unique_ptr<CDBIterator> cursor{ const_cast<CDBWrapper&>(db).NewIterator() };
+            COutPoint key;
+            CoinEntry entry(&key);
+
+            auto isAt =
+                [&](const COutPoint& outpoint)
+                {
+                    return cursor->Valid() && cursor->GetKey(entry)
+                        && entry.key == DB_COIN && key == outpoint;
+                };
+
+            for (auto it = begin; it != end; ++it)
+            {
+                // Consecutive outputs of the same transaction are usually
+                // neighbours in database so try to avoid the seek.
+                if (!isAt(*it))
+                {
+                    cursor->Seek(CoinEntry(&*it));
+                    if (!isAt(*it))
+                    {
+                        continue;
+                    }
+                }
+
+                auto coin = GetCoinFromIterator(*cursor, maxScriptLoadingSize);
+                if (!coin.has_value())
+                {
+                    throw std::runtime_error("Unable to unserialize coin");
+                }
+                loaded.emplace_back(*it, std::move(coin.value()));
+
+                cursor->Next();
+            }
+
+            return loaded;
+        };
+
+    const size_t numberOfThreads = mWorkerThreadPool ? mWorkerThreadPool->getPoolSize() : 0;
+    const size_t rangeSize =
+        std::max(
+            MIN_PREFETCH_RANGE_SIZE,
+            (toLoad.size() + numberOfThreads) / (numberOfThreads + 1));
+
+    LoadedCoins loaded;
+    try
+    {
+        // The first range is processed on the current thread while the rest
+        // are processed by the thread pool.
+        auto firstRangeEnd = toLoad.cbegin() + std::min(rangeSize, toLoad.size());
+        std::vector<std::future<LoadedCoins>> futures;
+        for (auto begin = firstRangeEnd; begin != toLoad.cend();)
+        {
+            auto end = begin + std::min<size_t>(rangeSize, std::distance(begin, toLoad.cend()));
+            futures.push_back(make_task(*mWorkerThreadPool, loadRange, begin, end));
+            begin = end;
+        }
+
+        loaded = loadRange(toLoad.cbegin(), firstRangeEnd);
+        for (auto& future : futures)
+        {
+            for (auto& item : future.get())
+            {
+                loaded.push_back(std::move(item));
+            }
+        }
+    }
+    catch (const std::runtime_error& e)
+    {
+        uiInterface.ThreadSafeMessageBox(
+            _("Error reading from database, shutting down."), "",
+            CClientUIInterface::MSG_ERROR);
+        LogPrintf("Error reading from database: %s\n", e.what());
+        // Same as in DBGetCoin() - we can't continue and all writes should be
+        // atomic.
+        abort();
+    }
+
+    std::unique_lock lock { mCoinsViewCacheMtx };
+
+    for (auto& [outpoint, coin] : loaded)
+    {
+        if (coin.HasScript() && !hasSpaceForScript(coin.GetScriptSize()))
+        {
+            mCache.AddCoin(
+                outpoint,
+                CoinImpl{
+                    coin.GetTxOut().nValue,
+                    coin.GetScriptSize(),
+                    coin.GetHeight(),
+                    coin.IsCoinBase()});
+        }
+        else
+        {
+            mCache.AddCoin(outpoint, std::move(coin));
+        }
+    }
+
+    for (const COutPoint& outpoint : toLoad)
+    {
+        mFetchingCoins.erase(outpoint);
+    }
+    guard.release();
+
+    mPrefetchRequested += outpoints.size();
+    mPrefetchLoaded += loaded.size();
+
+    LogPrint(BCLog::COINDB, "Prefetched %u coins (out of %u requested)\n",
+             loaded.size(), outpoints.size());
+
+    return loaded.size();
+}
+
+void CoinsDB::PrefetchCoinsAsync(std::vector<COutPoint>&& outpoints) const
+{
+    // Maximum number of coins loaded while holding a single read lock
+    static constexpr size_t ASYNC_PREFETCH_CHUNK_SIZE = 1 << 16;
+
+    if (!mAsyncPrefetchThreadPool || outpoints.empty())
+    {
+        return;
+    }
+
+    auto prefetch =
+        [this, outpoints = std::move(outpoints)]
+        {
+            for (auto begin = outpoints.cbegin(); begin != outpoints.cend();)
+            {
+                auto end = begin + std::min<size_t>(ASYNC_PREFETCH_CHUNK_SIZE, std::distance(begin, outpoints.cend()));
+
+                WPUSMutex::Lock lock;
+                ReadLock(lock);
+                PrefetchCoins(std::vector<COutPoint>{begin, end});
+
+                begin = end;
+            }
+        };
+
+    try
+    {
+        make_task(*mAsyncPrefetchThreadPool, std::move(prefetch));
+    }
+    catch (const std::runtime_error& e)
+    {
+        // Thread pool is already stopping - prefetch is only an optimization
+        LogPrint(BCLog::COINDB, "Coins prefetch not scheduled: %s\n", e.what());
+    }
+}
+
+auto CoinsDB::GetPrefetchStats() const -> PrefetchStats
+{
+    return {mPrefetchRequested, mPrefetchLoaded, mCacheHits, mCacheMisses};
+}
+
 bool CoinsDB::HaveCoinInCache(const COutPoint &outpoint) const {
     std::unique_lock lock { mCoinsViewCacheMtx };
     return mCache.FetchCoin(outpoint).has_value();
@@ -624,10 +1058,43 @@ uint256 CoinsDB::GetBestBlock() const {
     return hashBlock;
 }
 
+namespace
+{
+    /**
+     * Apply changes to UTXO set statistics. Returns nullopt if stats is nullopt
+     * or if any of the changes couldn't be calculated.
+     */
+    std::optional<UTXOSetStats> ApplyUTXOSetStatsDeltas(
+        std::optional<UTXOSetStats> stats,
+        const std::vector<std::shared_future<UTXOSetStats>>& deltas)
+    {
+        if (!stats)
+        {
+            return std::nullopt;
+        }
+
+        try
+        {
+            for (const auto& delta : deltas)
+            {
+                *stats += delta.get();
+            }
+        }
+        catch (const std::exception& e)
+        {
+            LogPrintf("UTXO set statistics are no longer maintained: %s\n", e.what());
+            return std::nullopt;
+        }
+
+        return stats;
+    }
+}
+
 bool CoinsDB::BatchWrite(
     const WPUSMutex::Lock& writeLock,
     const uint256& hashBlockIn,
-    CCoinsMap&& mapCoins)
+    CCoinsMap&& mapCoins,
+    std::vector<std::shared_future<UTXOSetStats>>&& statsDeltas)
 {
     assert( writeLock.GetLockType() == WPUSMutex::Lock::Type::write );
     std::unique_lock lock { mCoinsViewCacheMtx };
@@ -638,12 +1105,387 @@ bool CoinsDB::BatchWrite(
     }
     else
     {
+        if (mDBStats && hashBlockIn != hashBlock && statsDeltas.empty())
+        {
+            // Coins were changed by a writer that doesn't track statistics.
+            LogPrintf("UTXO set statistics are no longer maintained: best block "
+                      "changed without statistics changes\n");
+            mDBStats.reset();
+        }
+
+        if (mRecalculationStatsDeltas)
+        {
+            if (hashBlockIn != hashBlock && statsDeltas.empty())
+            {
+                mRecalculationStatsDeltas.reset();
+            }
+            else
+            {
+                mRecalculationStatsDeltas->insert(
+                    mRecalculationStatsDeltas->end(),
+                    statsDeltas.begin(),
+                    statsDeltas.end());
+            }
+        }
+
+        if (mDBStats)
+        {
+            mPendingStatsDeltas.insert(
+                mPendingStatsDeltas.end(),
+                std::make_move_iterator(statsDeltas.begin()),
+                std::make_move_iterator(statsDeltas.end()));
+        }
+        else
+        {
+            mPendingStatsDeltas.clear();
+        }
+
         mCache.BatchWrite(mapCoins);
         hashBlock = hashBlockIn;
     }
     return true;
 }
 
+std::shared_future<UTXOSetStats> CoinsDB::GetBlockUTXOSetStatsDeltaAsync(
+    const std::shared_ptr<const CBlock>& block,
+    const std::shared_ptr<const CBlockUndo>& blockUndo,
+    const CBlockIndex& index,
+    bool genesisEnabled,
+    bool connect) const
+{
+    {
+        std::unique_lock lock { mCoinsViewCacheMtx };
+        if (!mDBStats && !mRecalculationStatsDeltas)
+        {
+            return {};
+        }
+    }
+
+    if (!index.GetPrev())
+    {
+        // Genesis block outputs are never added to the UTXO set.
+        std::promise<UTXOSetStats> empty;
+        empty.set_value({});
+        return empty.get_future().share();
+    }
+
+    auto calculate =
+        [block, blockUndo, &index, genesisEnabled, connect]
+        {
+            if (!blockUndo)
+            {
+                throw std::runtime_error(
+                    "undo data of block " + index.GetBlockHash().ToString() +
+                    " is not available");
+            }
+
+            return
+                GetBlockUTXOSetStatsDelta(
+                    *block,
+                    *blockUndo,
+                    genesisEnabled,
+                    index.GetHeight(),
+                    connect);
+        };
+
+    return make_task(*mStatsThreadPool, std::move(calculate)).share();
+}
+
+std::optional<std::pair<uint256, UTXOSetStats>> CoinsDB::GetUTXOSetStats() const
+{
+    uint256 bestBlock;
+    std::optional<UTXOSetStats> stats;
+    std::vector<std::shared_future<UTXOSetStats>> deltas;
+    {
+        std::unique_lock lock { mCoinsViewCacheMtx };
+        bestBlock = hashBlock.IsNull() ? DBGetBestBlock() : hashBlock;
+        stats = mDBStats;
+        deltas = mPendingStatsDeltas;
+    }
+
+    // Waiting for pending changes doesn't require any of the locks.
+    stats = ApplyUTXOSetStatsDeltas(std::move(stats), deltas);
+    if (!stats || bestBlock.IsNull())
+    {
+        return std::nullopt;
+    }
+
+    return std::make_pair(bestBlock, std::move(stats.value()));
+}
+
+std::pair<uint256, UTXOSetStats> CoinsDB::RecalculateUTXOSetStats(bool& matched)
+{
+    std::optional<UTXOSetStats> expected;
+    std::optional<CDBSnapshot> snapshot;
+    {
+        WPUSMutex::Lock writeLock = mMutex.WriteLock();
+        std::unique_lock lock { mCoinsViewCacheMtx };
+
+        if (mRecalculatingStats)
+        {
+            throw std::runtime_error("UTXO set statistics are already being recalculated");
+        }
+
+        expected = ApplyUTXOSetStatsDeltas(mDBStats, mPendingStatsDeltas);
+        if (!hashBlock.IsNull())
+        {
+            auto coins = mCache.MoveOutCoins();
+            DBBatchWrite(coins, hashBlock, expected);
+            mDBStats = expected;
+            mPendingStatsDeltas.clear();
+        }
+
+        // From now on changes of blocks that are applied while we are
+        // scanning are collected so that they can be added to the result.
+        snapshot.emplace(db);
+        mRecalculatingStats = true;
+        mRecalculationStatsDeltas.emplace();
+    }
+
+    auto finish =
+        [this]
+        {
+            std::unique_lock lock { mCoinsViewCacheMtx };
+            mRecalculatingStats = false;
+            return std::exchange(mRecalculationStatsDeltas, std::nullopt);
+        };
+
+    // Snapshot guarantees that database content doesn't change while we are
+    // iterating over it. Statistics are order independent so ranges are
+    // simply added together.
+    UTXOSetStats stats;
+    uint256 bestBlock;
+    try
+    {
+        bestBlock =
+            ScanCoins(
+                snapshot.value(),
+                DEFAULT_SCAN_RANGES,
+                [](CCoinsViewDBCursor& cursor)
+                {
+                    UTXOSetStats range;
+                    for (; cursor.Valid(); cursor.Next())
+                    {
+                        COutPoint key;
+                        CoinWithScript coin;
+                        if (!cursor.GetKey(key) || !cursor.GetValue(coin))
+                        {
+                            throw std::runtime_error("Unable to read UTXO set");
+                        }
+                        range.AddCoin(key, coin.GetTxOut(), coin.GetHeight(), coin.IsCoinBase());
+                    }
+                    return range;
+                },
+                [&stats](UTXOSetStats&& range)
+                {
+                    boost::this_thread::interruption_point();
+                    stats += range;
+                });
+    }
+    catch (...)
+    {
+        finish();
+        throw;
+    }
+    snapshot.reset();
+
+    matched = expected.has_value() && expected.value() == stats;
+
+    // Statistics of the blocks applied during the scan are added to the
+    // result, which then matches the cache. It is only stored together with
+    // the coins it describes, so flush the cache (only changes made during
+    // the scan) under write lock.
+    WPUSMutex::Lock writeLock = mMutex.WriteLock();
+    auto deltas = finish();
+
+    std::unique_lock lock { mCoinsViewCacheMtx };
+    if (!deltas)
+    {
+        LogPrintf("UTXO set statistics are no longer maintained: coins were "
+                  "changed without statistics changes during recalculation\n");
+        mDBStats.reset();
+        mPendingStatsDeltas.clear();
+        return {bestBlock, std::move(stats)};
+    }
+
+    std::optional<UTXOSetStats> current = ApplyUTXOSetStatsDeltas(stats, deltas.value());
+    if (current)
+    {
+        if (!hashBlock.IsNull())
+        {
+            auto coins = mCache.MoveOutCoins();
+            DBBatchWrite(coins, hashBlock, current);
+        }
+        else
+        {
+            // Nothing was written to cache since the snapshot so database
+            // best block is still the scanned one.
+            assert(deltas->empty());
+            CDBBatch batch(db);
+            batch.Write(DB_UTXO_STATS, current.value());
+            db.WriteBatch(batch);
+        }
+    }
+    mDBStats = std::move(current);
+    mPendingStatsDeltas.clear();
+
+    return {bestBlock, std::move(stats)};
+}
+
+bool CoinsDB::WriteDirtyCoins(const uint256& expectedBestBlock)
+{
+    std::vector<COutPoint> outpoints;
+    uint64_t batchWriteCount = 0;
+    {
+        WPUSMutex::Lock readLock;
+        ReadLock(readLock);
+        std::unique_lock lock { mCoinsViewCacheMtx };
+
+        if (hashBlock.IsNull() || hashBlock != expectedBestBlock)
+        {
+            return false;
+        }
+
+        const auto dirty = mCache.GetDirtyEntries();
+        if (dirty.empty() && mTransitionTarget.IsNull())
+        {
+            return false;
+        }
+        outpoints.reserve(dirty.size());
+        for (const auto& [outpoint, entry] : dirty)
+        {
+            outpoints.push_back(*outpoint);
+        }
+
+        // Coins written by an interrupted write and modified since then are
+        // written together with the new transition marker.
+        CoinsStore::DirtyEntries rewritten;
+        for (const auto& outpoint : mTransitionWritten)
+        {
+            if (auto entry = mCache.GetDirtyEntry(outpoint); entry.first)
+            {
+                rewritten.push_back(entry);
+            }
+        }
+        DBBeginWrite(expectedBestBlock, rewritten);
+        mCache.MarkWritten(rewritten);
+
+        batchWriteCount = mBatchWriteCount;
+    }
+
+    // Each chunk is written under its own read lock so that a pending writer
+    // (and the readers queued behind it) only waits for one chunk. Once the
+    // writer has changed the cache this write stops and the next one
+    // continues it.
+    const size_t chunkSize = GetWriteChunkSize();
+    size_t next = 0;
+    size_t written = 0;
+    while (true)
+    {
+        WPUSMutex::Lock readLock;
+        ReadLock(readLock);
+        std::unique_lock lock { mCoinsViewCacheMtx };
+
+        if (mBatchWriteCount != batchWriteCount)
+        {
+            // Everything was written by a full flush in the meantime
+            return false;
+        }
+        if (hashBlock != expectedBestBlock)
+        {
+            LogPrint(BCLog::COINDB, "Incremental write to coin database "
+                                    "interrupted by a new best block after "
+                                    "%u changed transaction outputs\n",
+                     written);
+            return false;
+        }
+
+        if (next == outpoints.size())
+        {
+            std::optional<UTXOSetStats> stats = mDBStats;
+            std::vector<std::shared_future<UTXOSetStats>> statsDeltas = mPendingStatsDeltas;
+            lock.unlock();
+            // Pending changes can only be added under write lock so all of
+            // them are for coins that were written.
+            stats = ApplyUTXOSetStatsDeltas(std::move(stats), statsDeltas);
+            lock.lock();
+
+            DBEndWrite(expectedBestBlock, stats);
+            mDBStats = std::move(stats);
+            mPendingStatsDeltas.clear();
+
+            LogPrint(BCLog::COINDB, "Incrementally written %u changed transaction "
+                                    "outputs to coin database\n",
+                     written);
+            return true;
+        }
+
+        CoinsStore::DirtyEntries chunk;
+        size_t chunkUsage = 0;
+        for (; next < outpoints.size() && chunkUsage < chunkSize; ++next)
+        {
+            if (auto entry = mCache.GetDirtyEntry(outpoints[next]); entry.first)
+            {
+                chunk.push_back(entry);
+                chunkUsage += sizeof(CCoinsMap::value_type) + entry.second->DynamicMemoryUsage();
+            }
+        }
+        lock.unlock();
+
+        // Read lock guarantees that dirty entries are neither modified nor
+        // removed from cache (other readers only add new entries) so we can
+        // write them without holding mCoinsViewCacheMtx.
+        DBWriteCoins(chunk);
+
+        lock.lock();
+        for (const auto& [outpoint, entry] : chunk)
+        {
+            mTransitionWritten.push_back(*outpoint);
+        }
+        mCache.MarkWritten(chunk);
+        written += chunk.size();
+    }
+}
+
+void CoinsDB::WriteDirtyCoinsAsync(const uint256& expectedBestBlock)
+{
+    if (!mDirtyCoinsWriterThreadPool || mDirtyCoinsWriteScheduled.exchange(true))
+    {
+        return;
+    }
+
+    auto write =
+        [this, expectedBestBlock]
+        {
+            try
+            {
+                WriteDirtyCoins(expectedBestBlock);
+            }
+            catch (const std::runtime_error& e)
+            {
+                uiInterface.ThreadSafeMessageBox(
+                    _("Error writing to database, shutting down."), "",
+                    CClientUIInterface::MSG_ERROR);
+                LogPrintf("Error writing to database: %s\n", e.what());
+                // Database is marked as being in transition to the new best
+                // block so it will be fixed by ReplayBlocks() on restart.
+                abort();
+            }
+
+            mDirtyCoinsWriteScheduled = false;
+        };
+
+    try
+    {
+        make_task(*mDirtyCoinsWriterThreadPool, std::move(write));
+    }
+    catch (const std::runtime_error& e)
+    {
+        mDirtyCoinsWriteScheduled = false;
+        LogPrint(BCLog::COINDB, "Dirty coins write not scheduled: %s\n", e.what());
+    }
+}
+
 bool CoinsDB::Flush()
 {
     WPUSMutex::Lock writeLock = mMutex.WriteLock();
@@ -656,8 +1498,13 @@ bool CoinsDB::Flush()
     }
 
     auto coins = mCache.MoveOutCoins();
+    auto stats = ApplyUTXOSetStatsDeltas(mDBStats, mPendingStatsDeltas);
+
+    bool result = DBBatchWrite(coins, hashBlock, stats);
+    mDBStats = std::move(stats);
+    mPendingStatsDeltas.clear();
 
-    return DBBatchWrite(coins, hashBlock);
+    return result;
 }
 
 void CoinsDB::Uncache(const std::vector<COutPoint>& vOutpoints)
@@ -726,7 +1573,7 @@ auto CoinsDBSpan::TryFlush() -> WriteState
     std::unique_ptr<WPUSMutex::Lock, decltype(revertToReadLock)> guard{&mView.mLock, revertToReadLock};
 
     return
-        mDB.BatchWrite(mView.mLock, hashBlock, mCache.MoveOutCoins())
+        mDB.BatchWrite(mView.mLock, hashBlock, mCache.MoveOutCoins(), std::exchange(mStatsDeltas, {}))
         ? WriteState::ok
         : WriteState::error;
 }
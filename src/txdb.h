@@ -10,13 +10,21 @@
 #include "chain.h"
 #include "coins.h"
 #include "dbwrapper.h"
+#include "task_helpers.h"
+#include "threadpool.h"
+#include "utxo_set_stats.h"
 #include "write_preferring_upgradable_mutex.h"
 
+#include <atomic>
+#include <deque>
+#include <future>
 #include <map>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+class CBlock;
 class CBlockFileInfo;
 class CBlockIndex;
 struct CDiskTxPos;
@@ -28,6 +36,8 @@ static constexpr int MAX_BLOCK_COINSDB_USAGE = 10;
 static const int64_t nDefaultDbCache = 450;
 //! -dbbatchsize default (bytes)
 static const int64_t nDefaultDbBatchSize = 16 << 20;
+//! -dbincrementalflush default (percent of coins cache size, 0 = disabled)
+static const int nDefaultDbIncrementalFlush = 0;
 //! max. -dbcache (MiB)
 static const int64_t nMaxDbCache = sizeof(void *) > 4 ? 16384 : 1024;
 //! min. -dbcache (MiB)
@@ -57,13 +67,30 @@ public:
     //! Get best block at the time this cursor was created
     const uint256 &GetBestBlock() const { return hashBlock; }
 
+    //! Size of keys and values that the cursor moved over
+    uint64_t GetBytesRead() const { return nBytesRead; }
+
 private:
-    CCoinsViewDBCursor(CDBIterator *pcursorIn, const uint256 &hashBlockIn)
-        : hashBlock(hashBlockIn), pcursor(pcursorIn) {}
+    CCoinsViewDBCursor(CDBIterator *pcursorIn, const uint256 &hashBlockIn,
+                       uint32_t nEndPrefixIn = TXID_PREFIX_END)
+        : hashBlock(hashBlockIn), pcursor(pcursorIn), nEndPrefix(nEndPrefixIn) {}
     std::optional<CoinImpl> GetCoin(uint64_t maxScriptSize) const;
+    //! Cache key of the current record or invalidate the cursor if there are
+    //! no more records in its range
+    void UpdateKey();
+
+    //! Range cursors only iterate over coins whose txid starts with a 16 bit
+    //! prefix that is below nEndPrefix.
+    static constexpr uint32_t TXID_PREFIX_END = 0x10000;
+    static uint32_t GetTxIdPrefix(const TxId &txid) {
+        return (uint32_t{*txid.begin()} << 8) | *(txid.begin() + 1);
+    }
+
     uint256 hashBlock;
     std::unique_ptr<CDBIterator> pcursor;
     std::pair<char, COutPoint> keyTmp;
+    uint32_t nEndPrefix;
+    uint64_t nBytesRead{0};
 
     friend class CoinsDB;
 };
@@ -105,6 +132,10 @@ public:
      *                        Added coins and coins without scripts do not count
      *                        to this limit and may exceed it.
      * @param[in] nCacheSize  Underlying database cache size
+     * @param[in] workerThreadsCount
+     *                        Number of threads used for loading coins in bulk
+     *                        by PrefetchCoins() and for writing coins to
+     *                        database (0 = use calling thread only).
      * @param[in] fMemory     If true, use leveldb's memory environment.
      * @param[in] fWipe       If true, remove all existing data.
      */
@@ -112,6 +143,7 @@ public:
         uint64_t cacheSizeThreshold,
         size_t nCacheSize,
         MaxFiles maxFiles,
+        size_t workerThreadsCount,
         bool fMemory = false,
         bool fWipe = false);
 
@@ -136,6 +168,43 @@ public:
 
     CCoinsViewDBCursor* Cursor() const;
 
+    //! Maximum number of key ranges that ScanCoins() can split database into
+    static constexpr size_t MAX_SCAN_RANGES = 0x10000;
+    //! Number of key ranges used for scans of the whole database - enough
+    //! for good load balancing while keeping buffered results small
+    static constexpr size_t DEFAULT_SCAN_RANGES = 1024;
+
+    /**
+     * Iterate over all coins in database in parallel.
+     *
+     * Database is split into rangesCount disjoint key ranges (by txid prefix
+     * so all outputs of a transaction are in the same range) that all see the
+     * same database state regardless of concurrent writes. scanRange(cursor)
+     * is called for each range on mWorkerThreadPool and its result is passed
+     * to consumeResult(result) on the calling thread in key order - so
+     * order dependent aggregation (e.g. hashing) is still possible. Only a
+     * limited number of ranges (depending on pool size) are being scanned or
+     * waiting to be consumed at the same time.
+     *
+     * Cache content is not included so caller should flush it first if needed.
+     *
+     * Returns best block of the scanned database state.
+     */
+    template<typename ScanRange, typename ConsumeResult>
+    uint256 ScanCoins(
+        size_t rangesCount,
+        ScanRange&& scanRange,
+        ConsumeResult&& consumeResult) const;
+
+    //! Same as above but iterates over the database state of an existing
+    //! snapshot (which must be a snapshot of this database).
+    template<typename ScanRange, typename ConsumeResult>
+    uint256 ScanCoins(
+        const CDBSnapshot& snapshot,
+        size_t rangesCount,
+        ScanRange&& scanRange,
+        ConsumeResult&& consumeResult) const;
+
     size_t EstimateSize() const;
 
     /**
@@ -151,6 +220,75 @@ public:
      */
     void Uncache(const std::vector<COutPoint>& vOutpoints);
 
+    /**
+     * Schedule loading of coins for the given outpoints into cache and return
+     * immediately. Used for warming up the cache for a block before its
+     * validation reaches ConnectBlock().
+     *
+     * Coins are loaded by PrefetchCoins() in chunks on a dedicated background
+     * thread that holds a read lock only for the duration of each chunk so
+     * that flushing is not blocked for long.
+     */
+    void PrefetchCoinsAsync(std::vector<COutPoint>&& outpoints) const;
+
+    struct PrefetchStats
+    {
+        //! Number of outpoints that were requested to be prefetched
+        uint64_t requested;
+        //! Number of coins that were loaded into cache by prefetch
+        uint64_t loaded;
+        //! Number of GetCoin() requests that were served from cache
+        uint64_t cacheHits;
+        //! Number of GetCoin() requests that had to read from database
+        uint64_t cacheMisses;
+    };
+
+    PrefetchStats GetPrefetchStats() const;
+
+    /**
+     * Schedule writing of modified coins to database without removing them
+     * from cache and return immediately.
+     *
+     * Coins are written by WriteDirtyCoins() on a dedicated background thread
+     * in chunks, each while holding a read lock, so coins can still be read
+     * and blocks connected during the write. Request is ignored if the
+     * previous one is still in progress and the write stops if cache best
+     * block no longer equals expectedBestBlock (caller must make sure that the
+     * block index up to expectedBestBlock is already stored on disk) - the
+     * next write continues where it stopped.
+     */
+    void WriteDirtyCoinsAsync(const uint256& expectedBestBlock);
+
+    /**
+     * Get incrementally maintained UTXO set statistics for the current best
+     * block. Returns nullopt if statistics are not maintained (database was
+     * created by an older version or its last write was interrupted) - in that
+     * case they can be initialized by RecalculateUTXOSetStats().
+     *
+     * May wait for statistics changes of the last blocks to be calculated.
+     */
+    std::optional<std::pair<uint256, UTXOSetStats>> GetUTXOSetStats() const;
+
+    /**
+     * Flush cache and recalculate UTXO set statistics by iterating over the
+     * whole database, then continue maintaining them incrementally from
+     * the recalculated values.
+     *
+     * Write lock (and therefore validation) is only held while flushing
+     * before and after the scan; the database is scanned through a snapshot
+     * taken at the first flush and changes caused by blocks that are applied
+     * in the meantime are added to the scanned statistics, which are then
+     * stored with the second flush.
+     *
+     * Throws std::runtime_error if the statistics are already being
+     * recalculated or if the scan fails.
+     *
+     * @param[out] matched  Set to whether the recalculated statistics are equal
+     *                      to the incrementally maintained ones (false if they
+     *                      were not maintained).
+     */
+    std::pair<uint256, UTXOSetStats> RecalculateUTXOSetStats(bool& matched);
+
 private:
     uint256 GetBestBlock() const;
 
@@ -159,7 +297,23 @@ private:
     bool BatchWrite(
         const WPUSMutex::Lock& writeLock,
         const uint256& hashBlock,
-        CCoinsMap&& mapCoins);
+        CCoinsMap&& mapCoins,
+        std::vector<std::shared_future<UTXOSetStats>>&& statsDeltas);
+
+    /**
+     * Schedule calculation of UTXO set statistics changes caused by connecting
+     * (or disconnecting) the block on mStatsThreadPool. Returns an invalid
+     * future if statistics are not maintained.
+     *
+     * blockUndo is the block's undo data as built by ConnectBlock() (or read by
+     * DisconnectBlock()) so that it doesn't have to be read from disk again.
+     */
+    std::shared_future<UTXOSetStats> GetBlockUTXOSetStatsDeltaAsync(
+        const std::shared_ptr<const CBlock>& block,
+        const std::shared_ptr<const CBlockUndo>& blockUndo,
+        const CBlockIndex& index,
+        bool genesisEnabled,
+        bool connect) const;
 
     //! Get a cursor to iterate over coins by txId. Cursor is positioned at the first key in the source that is at or past target.
     //! If coin with txId is not found then cursor is at position at first record after txId - source is sorted by txId
@@ -179,10 +333,110 @@ private:
     }
 
     std::optional<CoinImpl> GetCoin(const COutPoint &outpoint, uint64_t maxScriptSize) const;
+
+    /**
+     * Load coins for the given outpoints into cache.
+     *
+     * Outpoints that are already cached or are currently being loaded by
+     * GetCoin() are skipped. The rest are sorted by database key and split
+     * into contiguous key ranges, each of which is resolved by a single
+     * database iterator sweeping forward through the range. Ranges are
+     * processed in parallel on mWorkerThreadPool and the results are added
+     * to cache under a single lock.
+     *
+     * Scripts are loaded while there is still space for them in cache (same
+     * as GetCoin()) - the rest of the coins are stored without script.
+     *
+     * Caller must hold a read lock (see CoinsDBView).
+     *
+     * Returns number of coins that were found in database and added to cache.
+     */
+    size_t PrefetchCoins(std::vector<COutPoint>&& outpoints) const;
+
     std::optional<CoinImpl> DBGetCoin(const COutPoint &outpoint, uint64_t maxScriptSize) const;
     uint256 DBGetBestBlock() const;
+    uint256 DBGetBestBlock(const CDBSnapshot &snapshot) const;
     std::vector<uint256> GetHeadBlocks() const;
-    bool DBBatchWrite(CCoinsMap &mapCoins, const uint256 &hashBlock);
+
+    //! Cursor over range with the given index when database is split into
+    //! count ranges (see ScanCoins())
+    std::unique_ptr<CCoinsViewDBCursor> RangeCursor(
+        const CDBSnapshot &snapshot,
+        const uint256 &hashBestChain,
+        size_t index,
+        size_t count) const;
+    void LogScanCoins(
+        const uint256 &hashBestChain,
+        size_t rangesCount,
+        size_t threadsCount,
+        uint64_t bytesRead,
+        int64_t durationMicros) const;
+    /**
+     * Write modified coins of mapCoins to database and mark database as
+     * consistent with hashBlock. Entries are removed from mapCoins as soon as
+     * their chunk is written.
+     *
+     * Caller must hold the write lock.
+     */
+    bool DBBatchWrite(
+        CCoinsMap &mapCoins,
+        const uint256 &hashBlock,
+        const std::optional<UTXOSetStats>& stats);
+
+    /*
+     * Coins are written in three steps: DBBeginWrite() marks the database as
+     * being in transition from its last consistent best block to hashBlock,
+     * any number of DBWriteCoins() calls write coins and DBEndWrite() marks
+     * the database as consistent with hashBlock again. In case of a crash in
+     * the middle ReplayBlocks() brings the database back to a consistent
+     * state.
+     *
+     * A transition may be left unfinished (incremental write was interrupted
+     * by a new best block) and restarted with a different hashBlock. Coins
+     * written since the transition started that were modified again would no
+     * longer be on the replay path, so their new values (rewritten) are
+     * written in the same batch as the new marker.
+     *
+     * UTXO set statistics are removed from database in the first batch and, if
+     * provided, stored in the last one so that they are never out of sync with
+     * the coins (ReplayBlocks() doesn't maintain them).
+     *
+     * Caller must hold at least a read lock and only one thread may write at a
+     * time (the write lock or the dirty coins writer thread).
+     */
+    void DBBeginWrite(
+        const uint256& hashBlock,
+        const CoinsStore::DirtyEntries& rewritten);
+    void DBEndWrite(
+        const uint256& hashBlock,
+        const std::optional<UTXOSetStats>& stats);
+
+    /**
+     * Write coins to database. Coins are split into shards by database key
+     * range which are serialized and written in parallel on
+     * mWorkerThreadPool in batches of up to -dbbatchsize bytes.
+     */
+    void DBWriteCoins(const CoinsStore::DirtyEntries& coins);
+
+    //! Approximate memory usage of coins written by one DBWriteCoins() call -
+    //! about one batch per worker thread
+    size_t GetWriteChunkSize() const;
+
+    /**
+     * Write modified coins from cache to database without removing them from
+     * cache. Modified coins become unmodified and spent coins are removed from
+     * cache.
+     *
+     * Coins are written in chunks of GetWriteChunkSize() each under its own
+     * read lock (which guarantees that cache entries are not modified while
+     * they are being written) so that writers don't have to wait for the
+     * whole write. Caller must not hold a lock.
+     *
+     * Returns false if there was nothing to write or if cache best block is
+     * not (or no longer) expectedBestBlock - in the latter case the database
+     * is left in transition and the next write continues it.
+     */
+    bool WriteDirtyCoins(const uint256& expectedBestBlock);
 
     /**
      * A mutex that guarantees that coins from cache will not be removed and
@@ -225,8 +479,146 @@ private:
      * base view, which can be slow if it is backed by disk.
      */
     mutable std::set<COutPoint> mFetchingCoins;
+
+    mutable std::atomic<uint64_t> mPrefetchRequested{0};
+    mutable std::atomic<uint64_t> mPrefetchLoaded{0};
+    mutable std::atomic<uint64_t> mCacheHits{0};
+    mutable std::atomic<uint64_t> mCacheMisses{0};
+
+    //! Threads used by PrefetchCoins() and DBWriteCoins() - nullptr if they
+    //! run on the calling thread only.
+    std::unique_ptr<CThreadPool<CQueueAdaptor>> mWorkerThreadPool;
+
+    /**
+     * Single thread that runs PrefetchCoinsAsync() requests. It must be
+     * separate from mWorkerThreadPool as it waits for read lock which could
+     * otherwise block tasks of a PrefetchCoins() call whose caller is holding
+     * a read lock and therefore blocks the pending writer.
+     */
+    std::unique_ptr<CThreadPool<CQueueAdaptor>> mAsyncPrefetchThreadPool;
+
+    //! Single thread that runs WriteDirtyCoinsAsync() requests.
+    std::unique_ptr<CThreadPool<CQueueAdaptor>> mDirtyCoinsWriterThreadPool;
+    std::atomic_bool mDirtyCoinsWriteScheduled{false};
+
+    //! Best block the database is in transition to (see DBBeginWrite()),
+    //! null if it is consistent. Protected by mCoinsViewCacheMtx.
+    uint256 mTransitionTarget;
+    //! Coins written since the database went into transition. Protected by
+    //! mCoinsViewCacheMtx.
+    std::vector<COutPoint> mTransitionWritten;
+    //! Number of finished DBBatchWrite() calls - a running WriteDirtyCoins()
+    //! stops once one was done as it has written everything. Protected by
+    //! mCoinsViewCacheMtx.
+    uint64_t mBatchWriteCount{0};
+
+    //! UTXO set statistics of database content - nullopt if not maintained.
+    //! Protected by mCoinsViewCacheMtx.
+    std::optional<UTXOSetStats> mDBStats;
+
+    //! Changes to mDBStats caused by blocks that were written to cache but
+    //! not yet to database. Protected by mCoinsViewCacheMtx.
+    std::vector<std::shared_future<UTXOSetStats>> mPendingStatsDeltas;
+
+    //! Changes caused by all blocks written to cache since the snapshot of
+    //! a running RecalculateUTXOSetStats() was taken - nullopt if there is no
+    //! recalculation in progress or if some changes were not tracked.
+    //! Protected by mCoinsViewCacheMtx.
+    std::optional<std::vector<std::shared_future<UTXOSetStats>>> mRecalculationStatsDeltas;
+    //! Whether RecalculateUTXOSetStats() is running. Protected by
+    //! mCoinsViewCacheMtx.
+    bool mRecalculatingStats{false};
+
+    //! Single thread for calculation of UTXO set statistics changes so that
+    //! it doesn't compete with validation.
+    std::unique_ptr<CThreadPool<CQueueAdaptor>> mStatsThreadPool;
 };
 
+template<typename ScanRange, typename ConsumeResult>
+uint256 CoinsDB::ScanCoins(
+    size_t rangesCount,
+    ScanRange&& scanRange,
+    ConsumeResult&& consumeResult) const
+{
+    CDBSnapshot snapshot{db};
+    return
+        ScanCoins(
+            snapshot,
+            rangesCount,
+            std::forward<ScanRange>(scanRange),
+            std::forward<ConsumeResult>(consumeResult));
+}
+
+template<typename ScanRange, typename ConsumeResult>
+uint256 CoinsDB::ScanCoins(
+    const CDBSnapshot& snapshot,
+    size_t rangesCount,
+    ScanRange&& scanRange,
+    ConsumeResult&& consumeResult) const
+{
+    using Result = std::invoke_result_t<ScanRange&, CCoinsViewDBCursor&>;
+
+    const int64_t startTime = GetTimeMicros();
+    const uint256 hashBestChain = DBGetBestBlock(snapshot);
+    std::atomic<uint64_t> bytesRead{0};
+
+    auto scan =
+        [&](size_t index) -> Result
+        {
+            auto cursor = RangeCursor(snapshot, hashBestChain, index, rangesCount);
+            Result result = scanRange(*cursor);
+            bytesRead += cursor->GetBytesRead();
+            return result;
+        };
+
+    const size_t threadsCount = mWorkerThreadPool ? mWorkerThreadPool->getPoolSize() : 0;
+    if (threadsCount == 0)
+    {
+        for (size_t i = 0; i < rangesCount; ++i)
+        {
+            consumeResult(scan(i));
+        }
+    }
+    else
+    {
+        // One more range than there are threads so that workers can continue
+        // while the oldest result is being consumed.
+        const size_t maxPending = threadsCount + 1;
+        std::deque<std::future<Result>> pending;
+        size_t next = 0;
+
+        try
+        {
+            for (size_t i = 0; i < rangesCount; ++i)
+            {
+                while (next < rangesCount && pending.size() < maxPending)
+                {
+                    pending.push_back(make_task(*mWorkerThreadPool, scan, next++));
+                }
+
+                Result result = pending.front().get();
+                pending.pop_front();
+                consumeResult(std::move(result));
+            }
+        }
+        catch (...)
+        {
+            // Tasks reference snapshot and scan so all of them must finish
+            // before we return - their errors are dropped in favour of the
+            // first one.
+            for (auto& future : pending)
+            {
+                future.wait();
+            }
+            throw;
+        }
+    }
+
+    LogScanCoins(hashBestChain, rangesCount, threadsCount, bytesRead, GetTimeMicros() - startTime);
+
+    return hashBestChain;
+}
+
 /**
  * View for read-only querying of coins providers.
  *
@@ -289,6 +681,11 @@ private:
         return mDB.GetCoin(outpoint, maxScriptSize);
     }
 
+    void PrefetchCoins(std::vector<COutPoint>&& outpoints) const override
+    {
+        mDB.PrefetchCoins(std::move(outpoints));
+    }
+
     const CoinsDB& mDB;
 
     // This variable enforces read only access to mDB
@@ -359,9 +756,32 @@ public:
         return mDB.GetHeadBlocks();
     }
 
+    /**
+     * Schedule calculation of UTXO set statistics changes caused by connecting
+     * (or disconnecting if connect is false) the block to this span. Changes
+     * are pushed to coins database together with coins on TryFlush().
+     *
+     * Must be called for every block that is applied to a span which is then
+     * flushed, otherwise coins database stops maintaining the statistics.
+     */
+    void TrackUTXOSetStats(
+        const std::shared_ptr<const CBlock>& block,
+        const std::shared_ptr<const CBlockUndo>& blockUndo,
+        const CBlockIndex& index,
+        bool genesisEnabled,
+        bool connect)
+    {
+        assert(mThreadId == std::this_thread::get_id());
+        if (auto delta = mDB.GetBlockUTXOSetStatsDeltaAsync(block, blockUndo, index, genesisEnabled, connect); delta.valid())
+        {
+            mStatsDeltas.push_back(std::move(delta));
+        }
+    }
+
 private:
     CoinsDB& mDB;
     CoinsDBView mView;
+    std::vector<std::shared_future<UTXOSetStats>> mStatsDeltas;
 };
 
 /** Access to the block database (blocks/index/) */
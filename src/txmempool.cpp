@@ -9,9 +9,11 @@
 #include "clientversion.h"
 #include "consensus/consensus.h"
 #include "consensus/validation.h"
+#include "crypto/sha256.h"
 #include "mempooltxdb.h"
 #include "policy/fees.h"
 #include "policy/policy.h"
+#include "script/scriptcache.h"
 #include "timedata.h"
 #include "txdb.h"
 #include "util.h"
@@ -20,6 +22,8 @@
 #include "validation.h"
 #include "validationinterface.h"
 #include "txn_validator.h"
+#include "task_helpers.h"
+#include "threadpool.h"
 #include "version.h"
 #include <boost/range/adaptor/reversed.hpp>
 #include <config.h>
@@ -236,7 +240,8 @@ void CTxMemPool::GetMemPoolAncestorsNL(
         const txiter& entryIter,
         setEntries& setAncestors) const
 {
-    auto parentHashes = GetMemPoolParentsNL(entryIter);
+    const linkEntries& entryParents = GetMemPoolParentsNL(entryIter);
+    setEntries parentHashes(entryParents.begin(), entryParents.end());
     
     while (!parentHashes.empty()) {
         txiter stageit = *parentHashes.begin();
@@ -244,7 +249,7 @@ void CTxMemPool::GetMemPoolAncestorsNL(
 
         setAncestors.insert(stageit);
         
-        const setEntries &setMemPoolParents = GetMemPoolParentsNL(stageit);
+        const linkEntries &setMemPoolParents = GetMemPoolParentsNL(stageit);
         for (const txiter &phash : setMemPoolParents)
         {
             // If this is a new ancestor, add it.
@@ -258,9 +263,8 @@ void CTxMemPool::GetMemPoolAncestorsNL(
 
 
 void CTxMemPool::updateAncestorsOfNL(bool add, txiter it) {
-    setEntries parentIters = GetMemPoolParentsNL(it);
     // add or remove this tx as a child of each parent
-    for (txiter piter : parentIters) {
+    for (txiter piter : GetMemPoolParentsNL(it)) {
         updateChildNL(piter, it, add);
     }
 }
@@ -311,23 +315,76 @@ void CTxMemPool::AddUnchecked(
     size_t* pnSecondaryMempoolSize,
     size_t* pnDynamicMemoryUsage) {
 
+    PendingAdd pending {
+        hash,
+        entry,
+        txStorage,
+        changeSet,
+        pnPrimaryMempoolSize,
+        pnSecondaryMempoolSize,
+        pnDynamicMemoryUsage
+    };
+
     {
-        std::unique_lock lock{smtx};
-        
-        AddUncheckedNL(
-            hash,
-            entry,
-            txStorage,
-            changeSet,
-            std::nullopt,
-            pnPrimaryMempoolSize,
-            pnSecondaryMempoolSize,
-            pnDynamicMemoryUsage);
+        std::unique_lock queueLock{mtxPendingAdds};
+        pendingAdds.push_back(&pending);
+
+        // If someone else is already committing they will pick us up in
+        // their next batch, otherwise it's our turn to commit.
+        cvPendingAdds.wait(queueLock, [this, &pending] { return pending.done || !committingPendingAdds; });
+        if (!pending.done) {
+            committingPendingAdds = true;
+            queueLock.unlock();
+            CommitPendingAdds();
+        }
     }
+
+    if (pending.error) {
+        std::rethrow_exception(pending.error);
+    }
+
     // Notify entry added without holding the mempool's lock
     NotifyEntryAdded(*entry.tx);
 }
 
+void CTxMemPool::CommitPendingAdds() {
+    std::vector<PendingAdd*> batch {};
+    {
+        std::unique_lock queueLock{mtxPendingAdds};
+        batch.swap(pendingAdds);
+    }
+
+    {
+        std::unique_lock lock{smtx};
+        for (PendingAdd* pending : batch) {
+            try {
+                AddUncheckedNL(
+                    pending->hash,
+                    pending->entry,
+                    pending->txStorage,
+                    pending->changeSet,
+                    std::nullopt,
+                    pending->pnPrimaryMempoolSize,
+                    pending->pnSecondaryMempoolSize,
+                    pending->pnDynamicMemoryUsage);
+            }
+            catch (...) {
+                pending->error = std::current_exception();
+            }
+        }
+    }
+
+    // Hand over to the next committer, if anything was queued meanwhile
+    {
+        std::unique_lock queueLock{mtxPendingAdds};
+        for (PendingAdd* pending : batch) {
+            pending->done = true;
+        }
+        committingPendingAdds = false;
+    }
+    cvPendingAdds.notify_all();
+}
+
 CTxMemPool::setEntriesTopoSorted CTxMemPool::GetSecondaryMempoolAncestorsNL(CTxMemPool::txiter payingTx) const
 {
     setEntriesTopoSorted ancestors;
@@ -831,7 +888,7 @@ void CTxMemPool::removeUncheckedNL(
         const auto size = entry->GetTxSize();
         const auto removeFromDisk = !entry->IsInMemory();
 
-        setEntries parents;
+        linkEntries parents;
         if (evictionTracker) {
             parents = std::move(mapLinks.at(entry).parents);
         }
@@ -879,7 +936,7 @@ void CTxMemPool::GetDescendantsNL(txiter entryit,
         setDescendants.insert(it);
         stage.erase(it);
 
-        const setEntries &setChildren = GetMemPoolChildrenNL(it);
+        const linkEntries &setChildren = GetMemPoolChildrenNL(it);
         for (const txiter &childiter : setChildren) {
             if (!setDescendants.count(childiter)) {
                 stage.insert(childiter);
@@ -1303,7 +1360,7 @@ void CTxMemPool::CheckMempoolImplNL(
             assert(it3->spentBy->GetTxId() == tx->GetId());
             i++;
         }
-        assert(setParentCheck == GetMemPoolParentsNL(it));
+        assert(GetMemPoolParentsNL(it).ContainsSameAs(setParentCheck));
         assert(ancestorsCount == it->ancestorsCount);
         if(secondaryMempoolAncestorsCount)
         {
@@ -1332,7 +1389,7 @@ void CTxMemPool::CheckMempoolImplNL(
                 setChildrenCheck.insert(nextit->spentBy);
             }
         }
-        assert(setChildrenCheck == GetMemPoolChildrenNL(it));
+        assert(GetMemPoolChildrenNL(it).ContainsSameAs(setChildrenCheck));
 
         if (fDependsWait) {
             waitingOnDependants.push_back(&(*it));
@@ -1562,8 +1619,11 @@ void CTxMemPool::OpenMempoolTxDB(const bool clearDatabase) {
                 (mempoolTxDB_unique
                  ? strprintf("mempoolTxDB-%0*X", hexDigits, mempoolTxDB_uniqueSuffix)
                  : std::string{"mempoolTxDB"});
+            const auto compression = CMempoolTxStore::ParseCompression(
+                gArgs.GetArg("-mempooltxdbcompression", DEFAULT_MEMPOOL_TXDB_COMPRESSION));
             mempoolTxDB = std::make_shared<CAsyncMempoolTxDB>(
-                GetDataDir() / dbName, cacheSize, mempoolTxDB_inMemory);
+                GetDataDir() / dbName, cacheSize, mempoolTxDB_inMemory,
+                compression.value_or(CMempoolTxStore::Compression::NONE));
             if (clearDatabase) {
                 mempoolTxDB->Clear();
             }
@@ -2253,7 +2313,7 @@ void CTxMemPool::updateParentNL(txiter entry, txiter parent, bool add) {
                       static_cast<WhatToDoWithTheEntry>(add));
 }
 
-const CTxMemPool::setEntries &
+const CTxMemPool::linkEntries &
 CTxMemPool::GetMemPoolParentsNL(txiter entry) const {
     assert(entry != mapTx.end());
     txlinksMap::const_iterator it = mapLinks.find(entry);
@@ -2261,7 +2321,7 @@ CTxMemPool::GetMemPoolParentsNL(txiter entry) const {
     return it->second.parents;
 }
 
-const CTxMemPool::setEntries &
+const CTxMemPool::linkEntries &
 CTxMemPool::GetMemPoolChildrenNL(txiter entry) const {
     assert(entry != mapTx.end());
     txlinksMap::const_iterator it = mapLinks.find(entry);
@@ -2318,7 +2378,7 @@ void CTxMemPool::TrackEntryAdded(CTxMemPool::txiter entry)
     }
 }
 
-void CTxMemPool::TrackEntryRemoved(const TxId& txId, const setEntries& immediateParents)
+void CTxMemPool::TrackEntryRemoved(const TxId& txId, const linkEntries& immediateParents)
 {
     if (evictionTracker)
     {
@@ -2643,11 +2703,42 @@ std::vector<CTransactionRef> CTxMemPool::GetTransactions() const
  *
  *     uint64   format-version
  *     (uuid    file-instance)              if format-version >= 2
+ *     (bool    has-trusted-reload-data)    if format-version >= 4
+ *     (trusted-reload-data)                if has-trusted-reload-data
  *     uint64   transaction-count
- *     array    transaction-data            transaction-count elements
+ *     (uint64  chunk-count)                if format-version >= 3
+ *     array    transaction-data            transaction-count elements if format-version < 3
+ *     array    chunk                       chunk-count elements if format-version >= 3
  *     map      fee-deltas-map              {txid -> Amount}
+ *     (uint256 checksum)                   if has-trusted-reload-data; SHA256 of
+ *                                          all preceding bytes of the file
+ *
+ * Version 4 trusted-reload-data:
+ *
+ *     uint256  tip-hash                    chain tip at the time of the dump
+ *     uint32   standard-script-flags       script flags used for mempool acceptance
+ *     uint32   block-script-flags          script flags of the next block
+ *     vector   script-cached-txids         transactions whose scripts were
+ *                                          verified with the above flags
+ *
+ * Trusted reload data is only written and used with -persistmempooltrusted.
+ * If the chain tip and script flags are unchanged when the file is loaded
+ * and the checksum matches, the listed transactions skip script
+ * verification (they still go through all other checks).
+ *
+ * Version 3 chunk:
  *
- * Version 2 transaction-data:
+ *     uint64   chunk-transaction-count
+ *     uint64   chunk-data-size
+ *     bytes    chunk-data                  chunk-transaction-count transaction-data
+ *                                          elements, chunk-data-size bytes
+ *
+ * Transactions are written in mempool insertion order, which is topological
+ * order, both within a chunk and from one chunk to the next, so each chunk
+ * only depends on itself and on chunks before it. Chunks are self-contained
+ * so that they can be serialised and deserialised independently.
+ *
+ * Version 2, 3 and 4 transaction-data:
  *
  *     bool     transaction-in-memory
  *     (txdata  transaction)                if transaction-in-memory
@@ -2663,10 +2754,177 @@ std::vector<CTransactionRef> CTxMemPool::GetTransactions() const
  */
 
 namespace {
-    const uint64_t MEMPOOL_DUMP_VERSION = 2;
+    const uint64_t MEMPOOL_DUMP_VERSION = 4;
     const uint64_t MEMPOOL_DUMP_COMPAT_VERSION = 1;
     const uint64_t MEMPOOL_DUMP_HAS_INSTANCE_ID = 2;
     const uint64_t MEMPOOL_DUMP_HAS_ON_DISK_TXS = 2;
+    const uint64_t MEMPOOL_DUMP_HAS_CHUNKS = 3;
+    const uint64_t MEMPOOL_DUMP_HAS_TRUSTED_RELOAD = 4;
+
+    // Number of transactions in a mempool.dat chunk, which is also the
+    // number of transactions validated together on load.
+    const size_t MEMPOOL_DUMP_CHUNK_TXNS = 10000;
+
+    // Transaction read from the mempool file
+    struct DumpedTx
+    {
+        CTransactionRef tx {nullptr};
+        bool txFromMemory {true};
+        int64_t nTime {0};
+        int64_t nFeeDelta {0};
+    };
+
+    template <typename Stream>
+    void SerializeDumpedTx(Stream& stream, const TxMempoolInfo& info, uint64_t version)
+    {
+        if (version >= MEMPOOL_DUMP_HAS_ON_DISK_TXS) {
+            const bool txFromMemory = info.GetTxStorage() == TxStorage::memory;
+            stream << txFromMemory;
+            if (!txFromMemory) {
+                stream << info.GetTxId();
+            }
+            else {
+                stream << *info.GetTx();
+            }
+        }
+        else {
+            stream << *info.GetTx();
+        }
+        stream << static_cast<int64_t>(info.nTime);
+        stream << static_cast<int64_t>(info.nFeeDelta.GetSatoshis());
+    }
+
+    template <typename Stream>
+    DumpedTx UnserializeDumpedTx(Stream& stream, uint64_t version, CMempoolTxDBReader& txdb)
+    {
+        DumpedTx result;
+        if (version >= MEMPOOL_DUMP_HAS_ON_DISK_TXS) {
+            stream >> result.txFromMemory;
+        }
+        if (!result.txFromMemory) {
+            uint256 txid;
+            stream >> txid;
+            if (!txdb.GetTransaction(txid, result.tx)) {
+                std::stringstream msg;
+                msg << "Transaction was not in mempool database: "
+                    << txid.ToString();
+                throw std::runtime_error(msg.str());
+            }
+        }
+        else {
+            stream >> result.tx;
+        }
+        stream >> result.nTime;
+        stream >> result.nFeeDelta;
+        return result;
+    }
+
+    // Chain state that script verification results in the mempool file
+    // are valid for
+    struct TrustedReloadData
+    {
+        uint256 tipHash {};
+        uint32_t standardScriptFlags {0};
+        uint32_t blockScriptFlags {0};
+        std::vector<uint256> scriptCachedTxIds {};
+
+        ADD_SERIALIZE_METHODS;
+
+        template <typename Stream, typename Operation>
+        inline void SerializationOp(Stream& s, Operation ser_action)
+        {
+            READWRITE(tipHash);
+            READWRITE(standardScriptFlags);
+            READWRITE(blockScriptFlags);
+            READWRITE(scriptCachedTxIds);
+        }
+    };
+
+    // Get current chain tip and the script flags mempool transactions are
+    // verified with on top of it
+    std::optional<TrustedReloadData> GetTrustedReloadState(const Config& config)
+    {
+        LOCK(cs_main);
+        const CBlockIndex* tip = chainActive.Tip();
+        if (!tip) {
+            return std::nullopt;
+        }
+        TrustedReloadData result;
+        result.tipHash = tip->GetBlockHash();
+        result.standardScriptFlags =
+            GetScriptVerifyFlags(config, IsGenesisEnabled(config, tip->GetHeight() + 1));
+        result.blockScriptFlags = GetBlockScriptFlags(config, tip);
+        return result;
+    }
+
+    // Writes to a file and optionally keeps a checksum of everything written
+    class ChecksumFileWriter
+    {
+    public:
+        ChecksumFileWriter(CAutoFile& file, bool checksum)
+        : mFile{file}, mChecksum{checksum}
+        {}
+
+        template <typename T>
+        ChecksumFileWriter& operator<<(const T& obj)
+        {
+            ::Serialize(*this, obj);
+            return *this;
+        }
+
+        void write(const char* pch, size_t size)
+        {
+            mFile.write(pch, size);
+            if (mChecksum) {
+                mHasher.Write(reinterpret_cast<const uint8_t*>(pch), size);
+            }
+        }
+
+        int GetType() const { return mFile.GetType(); }
+        int GetVersion() const { return mFile.GetVersion(); }
+
+        uint256 GetChecksum()
+        {
+            uint256 result;
+            mHasher.Finalize(result.begin());
+            return result;
+        }
+
+    private:
+        CAutoFile& mFile;
+        const bool mChecksum;
+        CSHA256 mHasher {};
+    };
+
+    // Check the checksum at the end of the mempool file
+    bool VerifyDumpChecksum(const fs::path& path)
+    {
+        CAutoFile file{fsbridge::fopen(path, "rb"), SER_DISK, CLIENT_VERSION};
+        const uint64_t fileSize = fs::file_size(path);
+        if (file.IsNull() || fileSize < sizeof(uint256)) {
+            return false;
+        }
+
+        CSHA256 hasher;
+        std::vector<char> buffer(1024 * 1024);
+        for (uint64_t remaining = fileSize - sizeof(uint256); remaining > 0;) {
+            const size_t size = static_cast<size_t>(std::min<uint64_t>(remaining, buffer.size()));
+            file.read(buffer.data(), size);
+            hasher.Write(reinterpret_cast<const uint8_t*>(buffer.data()), size);
+            remaining -= size;
+        }
+        uint256 expected;
+        hasher.Finalize(expected.begin());
+        uint256 checksum;
+        file >> checksum;
+        return checksum == expected;
+    }
+
+    // Number of threads used to (de)serialise mempool file chunks
+    size_t GetMempoolDumpThreadsCount()
+    {
+        return static_cast<size_t>(std::max(1, GetNumCores()));
+    }
 } // namespace
 
 void CTxMemPool::DoInitMempoolTxDB()
@@ -2784,29 +3042,69 @@ bool CTxMemPool::LoadMempool(const Config &config,
 {
     const auto& txValidator = g_connman->getTxnValidator();
     const auto processValidation =
-        [&txValidator](const TxInputDataSPtr& txInputData,
+        [&txValidator](TxInputDataSPtrVec&& txInputData,
                        const mining::CJournalChangeSetPtr& changeSet,
-                       bool limitMempoolSize) -> CValidationState
+                       bool limitMempoolSize) -> LoadRejectedTxns
         {
-            return txValidator->processValidation(txInputData, changeSet, limitMempoolSize);
+            LoadRejectedTxns rejected;
+            const auto result =
+                txValidator->processValidation(std::move(txInputData), changeSet, limitMempoolSize);
+            for (const auto& invalid : result.first) {
+                rejected.insert(invalid.first);
+            }
+            return rejected;
         };
     return LoadMempool(config, shutdownToken, processValidation);
 }
 
 bool CTxMemPool::LoadMempool(const Config &config,
                              const task::CCancellationToken& shutdownToken,
-                             const std::function<CValidationState(
-                                 const TxInputDataSPtr& txInputData,
-                                 const mining::CJournalChangeSetPtr& changeSet,
-                                 bool limitMempoolSize)>& processValidation)
+                             const LoadValidationFunction& processValidation)
 {
     try {
+        const int64_t startTime = GetTimeMicros();
         int64_t nExpiryTimeout = config.GetMemPoolExpiry();
 
         uint64_t version;
         DumpFileID instanceId;
         CAutoFile file{OpenDumpFile(version, instanceId), SER_DISK, CLIENT_VERSION};
 
+        // Script verification results recorded in the file are only reused
+        // if they were made on top of the same chain state with the same
+        // flags and the file is intact.
+        std::optional<TrustedReloadData> trusted;
+        std::unordered_set<uint256, SaltedTxidHasher> trustedTxIds;
+        if (version >= MEMPOOL_DUMP_HAS_TRUSTED_RELOAD) {
+            bool hasTrustedReloadData;
+            file >> hasTrustedReloadData;
+            if (hasTrustedReloadData) {
+                TrustedReloadData dumped;
+                file >> dumped;
+                if (gArgs.GetBoolArg("-persistmempooltrusted", DEFAULT_PERSIST_MEMPOOL_TRUSTED)) {
+                    const auto current = GetTrustedReloadState(config);
+                    if (!current || current->tipHash != dumped.tipHash) {
+                        LogPrintf("Mempool file was written at a different chain tip,"
+                                  " verifying all scripts.\n");
+                    }
+                    else if (current->standardScriptFlags != dumped.standardScriptFlags ||
+                             current->blockScriptFlags != dumped.blockScriptFlags) {
+                        LogPrintf("Mempool file was written with different script flags,"
+                                  " verifying all scripts.\n");
+                    }
+                    else if (!VerifyDumpChecksum(GetDataDir() / "mempool.dat")) {
+                        LogPrintf("Mempool file checksum mismatch, verifying all scripts.\n");
+                    }
+                    else {
+                        trustedTxIds.insert(dumped.scriptCachedTxIds.begin(),
+                                            dumped.scriptCachedTxIds.end());
+                        trusted = std::move(dumped);
+                        LogPrintf("Trusting script verification of %u transactions"
+                                  " from mempool file.\n", trustedTxIds.size());
+                    }
+                }
+            }
+        }
+
         int64_t count = 0;
         int64_t skipped = 0;
         int64_t failed = 0;
@@ -2817,70 +3115,136 @@ bool CTxMemPool::LoadMempool(const Config &config,
         // A pointer to the TxIdTracker.
         const auto& pTxIdTracker = g_connman->GetTxIdTracker();
         const auto txdb = mempoolTxDB->GetDatabase();
-        while (num--) {
-            bool txFromMemory = true;
-            CTransactionRef tx;
-            int64_t nTime;
-            int64_t nFeeDelta;
-
-            if (version >= MEMPOOL_DUMP_HAS_ON_DISK_TXS) {
-                file >> txFromMemory;
-            }
-            if (!txFromMemory) {
-                uint256 txid;
-                file >> txid;
-                if (!txdb->GetTransaction(txid, tx)) {
-                    std::stringstream msg;
-                    msg << "Transaction was not in mempool database: "
-                        << txid.ToString();
-                    throw std::runtime_error(msg.str());
+
+        // Validate a batch of transactions together so that the validator
+        // can spread them over its threads. Transactions in a batch may
+        // depend on each other; the validator retries those whose parents
+        // were not accepted yet.
+        const auto processBatch = [&](std::vector<DumpedTx>&& batch)
+        {
+            TxInputDataSPtrVec txInputData;
+            txInputData.reserve(batch.size());
+            for (const auto& dumped : batch) {
+                const auto& tx = dumped.tx;
+                if (dumped.nFeeDelta != 0) {
+                    const auto& txid = tx->GetId();
+                    PrioritiseTransaction(txid, txid.ToString(), Amount{dumped.nFeeDelta});
                 }
-            }
-            else {
-                file >> tx;
-            }
-            file >> nTime;
-            file >> nFeeDelta;
-            if (nFeeDelta != 0) {
-                const auto& txid = tx->GetId();
-                PrioritiseTransaction(txid, txid.ToString(), Amount{nFeeDelta});
-            }
-            if (nTime + nExpiryTimeout > nNow) {
-                // Mempool Journal ChangeSet
-                CJournalChangeSetPtr changeSet {
-                    getJournalBuilder().getNewChangeSet(JournalUpdateReason::INIT)
-                };
-                const auto txStorage = (txFromMemory ? TxStorage::memory : TxStorage::txdb);
-                const CValidationState state {
-                    // Execute txn validation synchronously.
-                    processValidation(
+                if (dumped.nTime + nExpiryTimeout > nNow) {
+                    const auto txStorage = (dumped.txFromMemory ? TxStorage::memory : TxStorage::txdb);
+                    txInputData.emplace_back(
                         std::make_shared<CTxInputData>(
                             pTxIdTracker, // a pointer to the TxIdTracker
                             tx,    // a pointer to the tx
                             TxSource::file, // tx source
                             TxValidationPriority::normal,  // tx validation priority
                             txStorage, // tx storage
-                            nTime), // nAcceptTime
-                        changeSet, // an instance of the mempool journal
-                        true) // fLimitMempoolSize
-                };
-                // Check results
-                if (state.IsValid()) {
-                    ++count;
+                            dumped.nTime)); // nAcceptTime
                 } else {
-                    ++failed;
-                    if (!txFromMemory) {
+                    ++skipped;
+                    if (!dumped.txFromMemory) {
                         mempoolTxDB->Remove({tx->GetId(), tx->GetTotalSize()});
                     }
                 }
-            } else {
-                ++skipped;
-                if (!txFromMemory) {
-                    mempoolTxDB->Remove({tx->GetId(), tx->GetTotalSize()});
+            }
+            if (txInputData.empty()) {
+                return;
+            }
+
+            // Seed the script cache so that validation finds the scripts of
+            // trusted transactions already verified. Cache keys can't be
+            // taken from the file since they are salted per process.
+            if (trusted) {
+                for (const auto& input : txInputData) {
+                    const auto& txid = input->GetTxnPtr()->GetId();
+                    if (trustedTxIds.count(txid)) {
+                        AddKeyInScriptCache(GetScriptCacheKey(txid, trusted->standardScriptFlags));
+                        AddKeyInScriptCache(GetScriptCacheKey(txid, trusted->blockScriptFlags));
+                    }
                 }
             }
-            if (shutdownToken.IsCanceled()) {
-                return false;
+
+            // Mempool Journal ChangeSet
+            CJournalChangeSetPtr changeSet {
+                getJournalBuilder().getNewChangeSet(JournalUpdateReason::INIT)
+            };
+            const size_t numValidated = txInputData.size();
+            // Execute txn validation synchronously.
+            const auto rejected = processValidation(std::move(txInputData), changeSet, true);
+            count += numValidated - rejected.size();
+            failed += rejected.size();
+            for (const auto& dumped : batch) {
+                if (!dumped.txFromMemory && rejected.count(dumped.tx->GetId())) {
+                    mempoolTxDB->Remove({dumped.tx->GetId(), dumped.tx->GetTotalSize()});
+                }
+            }
+        };
+
+        if (version < MEMPOOL_DUMP_HAS_CHUNKS) {
+            std::vector<DumpedTx> batch;
+            while (num--) {
+                batch.emplace_back(UnserializeDumpedTx(file, version, *txdb));
+                if (batch.size() == MEMPOOL_DUMP_CHUNK_TXNS || num == 0) {
+                    processBatch(std::move(batch));
+                    batch.clear();
+                    if (shutdownToken.IsCanceled()) {
+                        return false;
+                    }
+                }
+            }
+        }
+        else {
+            // Chunks are read from the file in order and deserialised on the
+            // worker threads while earlier chunks are being validated.
+            CThreadPool<CQueueAdaptor> pool {"MempoolLoadPool", GetMempoolDumpThreadsCount()};
+            const size_t maxPending = pool.getPoolSize() + 1;
+            std::deque<std::future<std::vector<DumpedTx>>> pending;
+
+            const uint64_t fileSize = fs::file_size(GetDataDir() / "mempool.dat");
+            uint64_t numChunks;
+            file >> numChunks;
+            uint64_t numRead = 0;
+            for (uint64_t nextChunk = 0; nextChunk < numChunks || !pending.empty();) {
+                while (nextChunk < numChunks && pending.size() < maxPending) {
+                    uint64_t chunkTxns;
+                    uint64_t chunkSize;
+                    file >> chunkTxns;
+                    file >> chunkSize;
+                    numRead += chunkTxns;
+                    const long position = ftell(file.Get());
+                    if (numRead > num || position < 0 ||
+                        chunkSize > fileSize - static_cast<uint64_t>(position)) {
+                        throw std::runtime_error("Mempool file chunk is inconsistent");
+                    }
+                    CSerializeData data(chunkSize);
+                    file.read(data.data(), data.size());
+
+                    pending.emplace_back(
+                        make_task(
+                            pool,
+                            [version, txdb, chunkTxns, chunkData = std::move(data)]() mutable
+                            {
+                                CDataStream stream {SER_DISK, CLIENT_VERSION};
+                                stream.SwapBuffer(chunkData);
+                                std::vector<DumpedTx> chunk;
+                                chunk.reserve(chunkTxns);
+                                for (uint64_t i = 0; i < chunkTxns; ++i) {
+                                    chunk.emplace_back(UnserializeDumpedTx(stream, version, *txdb));
+                                }
+                                return chunk;
+                            }));
+                    ++nextChunk;
+                }
+
+                auto chunk = pending.front().get();
+                pending.pop_front();
+                processBatch(std::move(chunk));
+                if (shutdownToken.IsCanceled()) {
+                    return false;
+                }
+            }
+            if (numRead != num) {
+                throw std::runtime_error("Mempool file chunks don't add up to the transaction count");
             }
         }
 
@@ -2897,9 +3261,11 @@ bool CTxMemPool::LoadMempool(const Config &config,
             throw std::runtime_error("Mempool and transaction database contents do not match");
         }
 
+        const double seconds = (GetTimeMicros() - startTime) * 0.000001;
         LogPrintf("Imported mempool transactions from disk: %i successes, %i "
-                  "failed, %i expired\n",
-                  count, failed, skipped);
+                  "failed, %i expired in %.2fs (%.0f txns/s)\n",
+                  count, failed, skipped, seconds,
+                  seconds > 0 ? (count + failed + skipped) / seconds : 0.0);
 
     }
     catch (const std::exception &e) {
@@ -2924,6 +3290,22 @@ void CTxMemPool::DumpMempool(uint64_t version) {
     std::vector<TxMempoolInfo> vinfo;
     GetDeltasAndInfo(mapDeltas, vinfo);
 
+    // Record which transactions have their scripts verified against the
+    // current tip so that they don't need to be verified again on reload
+    std::optional<TrustedReloadData> trusted;
+    if (version >= MEMPOOL_DUMP_HAS_TRUSTED_RELOAD &&
+        gArgs.GetBoolArg("-persistmempooltrusted", DEFAULT_PERSIST_MEMPOOL_TRUSTED)) {
+        trusted = GetTrustedReloadState(GlobalConfig::GetConfig());
+        if (trusted) {
+            for (const auto& info : vinfo) {
+                const auto& txid = info.GetTxId();
+                if (IsKeyInScriptCache(GetScriptCacheKey(txid, trusted->blockScriptFlags), false)) {
+                    trusted->scriptCachedTxIds.emplace_back(txid);
+                }
+            }
+        }
+    }
+
     int64_t mid = GetTimeMicros();
 
     try {
@@ -2933,40 +3315,84 @@ void CTxMemPool::DumpMempool(uint64_t version) {
         }
 
         CAutoFile file{filestr, SER_DISK, CLIENT_VERSION};
+        ChecksumFileWriter out{file, trusted.has_value()};
 
-        file << version;
+        out << version;
         if (version >= MEMPOOL_DUMP_HAS_INSTANCE_ID) {
             boost::uuids::random_generator gen;
             DumpFileID instanceId = gen();
             mempoolTxDB->SetXrefKey(instanceId);
-            file << instanceId;
+            out << instanceId;
+        }
+        if (version >= MEMPOOL_DUMP_HAS_TRUSTED_RELOAD) {
+            out << trusted.has_value();
+            if (trusted) {
+                out << *trusted;
+            }
         }
 
-        file << (uint64_t)vinfo.size();
+        out << (uint64_t)vinfo.size();
         size_t count = 0;
         size_t txdb = 0;
         for (const auto &i : vinfo) {
-            if (version >= MEMPOOL_DUMP_HAS_ON_DISK_TXS) {
-                const bool txFromMemory = i.GetTxStorage() == TxStorage::memory;
-                file << txFromMemory;
-                if (!txFromMemory) {
-                    file << i.GetTxId();
-                    ++txdb;
-                }
-                else {
-                    file << *i.GetTx();
-                }
-            }
-            else {
-                file << *i.GetTx();
+            if (version >= MEMPOOL_DUMP_HAS_ON_DISK_TXS &&
+                i.GetTxStorage() != TxStorage::memory) {
+                ++txdb;
             }
-            file << static_cast<int64_t>(i.nTime);
-            file << static_cast<int64_t>(i.nFeeDelta.GetSatoshis());
             mapDeltas.erase(i.GetTxId());
             ++count;
         }
 
-        file << mapDeltas;
+        if (version < MEMPOOL_DUMP_HAS_CHUNKS) {
+            for (const auto &i : vinfo) {
+                SerializeDumpedTx(out, i, version);
+            }
+        }
+        else {
+            // Chunks are serialised on the worker threads and written out
+            // in order as they complete.
+            CThreadPool<CQueueAdaptor> pool {"MempoolDumpPool", GetMempoolDumpThreadsCount()};
+            const size_t maxPending = pool.getPoolSize() + 1;
+            std::deque<std::future<CDataStream>> pending;
+
+            const size_t numChunks =
+                (vinfo.size() + MEMPOOL_DUMP_CHUNK_TXNS - 1) / MEMPOOL_DUMP_CHUNK_TXNS;
+            out << static_cast<uint64_t>(numChunks);
+            for (size_t nextChunk = 0; nextChunk < numChunks || !pending.empty();) {
+                while (nextChunk < numChunks && pending.size() < maxPending) {
+                    const size_t begin = nextChunk * MEMPOOL_DUMP_CHUNK_TXNS;
+                    const size_t end = std::min(begin + MEMPOOL_DUMP_CHUNK_TXNS, vinfo.size());
+                    pending.emplace_back(
+                        make_task(
+                            pool,
+                            [&vinfo, version](size_t first, size_t last)
+                            {
+                                CDataStream stream {SER_DISK, CLIENT_VERSION};
+                                for (size_t i = first; i < last; ++i) {
+                                    SerializeDumpedTx(stream, vinfo[i], version);
+                                }
+                                return stream;
+                            },
+                            begin,
+                            end));
+                    ++nextChunk;
+                }
+
+                const size_t chunkIndex = nextChunk - pending.size();
+                const size_t chunkTxns =
+                    std::min(MEMPOOL_DUMP_CHUNK_TXNS, vinfo.size() - chunkIndex * MEMPOOL_DUMP_CHUNK_TXNS);
+                const CDataStream chunk = pending.front().get();
+                pending.pop_front();
+                out << static_cast<uint64_t>(chunkTxns);
+                out << static_cast<uint64_t>(chunk.size());
+                out.write(chunk.data(), chunk.size());
+            }
+        }
+
+        out << mapDeltas;
+        if (trusted) {
+            file << out.GetChecksum();
+        }
         FileCommit(file.Get());
         file.reset();
         RenameOver(GetDataDir() / "mempool.dat.new",
@@ -10,6 +10,7 @@
 #include "amount.h"
 #include "cfile_util.h"
 #include "coins.h"
+#include "compact_set.h"
 #include "mining/journal_entry.h"
 #include "mining/journal_builder.h"
 #include "primitives/transaction.h"
@@ -29,6 +30,8 @@
 #include <boost/signals2/signal.hpp>
 #include <boost/uuid/uuid.hpp>
 
+#include <condition_variable>
+#include <exception>
 #include <functional>
 #include <map>
 #include <memory>
@@ -40,6 +43,7 @@
 #include <mutex>
 #include <shared_mutex>
 #include <unordered_map>
+#include <unordered_set>
 
 class CAutoFile;
 class CBlockIndex;
@@ -490,12 +494,16 @@ private:
     // transaction which is inserted later has larger insertion index. thus if we sort a sequence by insertion index it will be topo sorted
     using setEntriesTopoSorted = std::set<txiter, InsrtionOrderComparator>;
 
-    const setEntries &GetMemPoolParentsNL(txiter entry) const;
-    const setEntries &GetMemPoolChildrenNL(txiter entry) const;
+    // Parent/child links of an entry. Most entries have no more than a few
+    // so these are kept as compact sets to keep per entry overhead down.
+    using linkEntries = CompactSet<txiter, SaltedTxiterHasher>;
+
+    const linkEntries &GetMemPoolParentsNL(txiter entry) const;
+    const linkEntries &GetMemPoolChildrenNL(txiter entry) const;
 
     struct TxLinks {
-        setEntries parents;
-        setEntries children;
+        linkEntries parents;
+        linkEntries children;
     };
 
 
@@ -558,7 +566,7 @@ private:
 
     // Shortcuts for eviction tracking. Must be called with the mempool locked.
     void TrackEntryAdded(CTxMemPool::txiter entry);
-    void TrackEntryRemoved(const TxId& txId, const setEntries& immediateParents);
+    void TrackEntryRemoved(const TxId& txId, const linkEntries& immediateParents);
     void TrackEntryModified(CTxMemPool::txiter entry);
 
     std::vector<COutPoint> GetOutpointsSpentByNL(CTxMemPool::txiter entry) const;
@@ -624,6 +632,11 @@ public:
 
     // AddUnchecked must update the state for all ancestors of a given
     // transaction, to track size/count of descendant transactions.
+    //
+    // Concurrent callers are group committed: whichever thread gets to commit
+    // first adds all transactions queued up to that point under a single
+    // acquisition of the mempool lock, while the others just wait for their
+    // transaction to be done rather than queuing up on the lock themselves.
     void AddUnchecked(
             const uint256 &hash,
             const CTxMemPoolEntry &entry,
@@ -634,6 +647,32 @@ public:
             size_t* pnDynamicMemoryUsage = nullptr);
 
 private:
+    // A transaction waiting in AddUnchecked() to be committed
+    struct PendingAdd
+    {
+        const uint256& hash;
+        const CTxMemPoolEntry& entry;
+        const TxStorage txStorage;
+        const mining::CJournalChangeSetPtr& changeSet;
+        size_t* pnPrimaryMempoolSize;
+        size_t* pnSecondaryMempoolSize;
+        size_t* pnDynamicMemoryUsage;
+
+        // Set once committed, along with any error committing it
+        bool done {false};
+        std::exception_ptr error {nullptr};
+    };
+
+    // Transactions queued for the next group commit and whether a commit is
+    // in progress. Protected by mtxPendingAdds.
+    std::vector<PendingAdd*> pendingAdds {};
+    bool committingPendingAdds {false};
+    std::mutex mtxPendingAdds {};
+    std::condition_variable cvPendingAdds {};
+
+    // Add everything from pendingAdds under one exclusive lock of the mempool
+    void CommitPendingAdds();
+
     // Check the contents of the mempool transaction database against the mempool.
     // hardErrors=true means the implementation will assert() on error.
     bool CheckMempoolTxDBNL(bool hardErrors = true) const;
@@ -1229,15 +1268,20 @@ private:
     using DumpFileID = boost::uuids::uuid;
     UniqueCFile OpenDumpFile(uint64_t& version, DumpFileID& instanceId);
 
+    // Validation of a batch of transactions loaded from the mempool file,
+    // returning the ids of rejected transactions.
+    using LoadRejectedTxns = std::unordered_set<TxId, SaltedTxidHasher>;
+    using LoadValidationFunction = std::function<LoadRejectedTxns(
+        TxInputDataSPtrVec&& txInputData,
+        const mining::CJournalChangeSetPtr& changeSet,
+        bool limitMempoolSize)>;
+
     // Mempool dump and load for testing different file formats
     // and custion validation.
     void DumpMempool(uint64_t version);
     bool LoadMempool(const Config &config,
                      const task::CCancellationToken& shutdownToken,
-                     const std::function<CValidationState(
-                         const TxInputDataSPtr& txInputData,
-                         const mining::CJournalChangeSetPtr& changeSet,
-                         bool limitMempoolSize)>& processValidation);
+                     const LoadValidationFunction& processValidation);
 
 public:
     // Allow access to some mempool internals from unit tests.
@@ -51,12 +51,12 @@ void CEvictionCandidateTracker::PopExpired()
     }
 }
 
-const CTxMemPool::setEntries& CEvictionCandidateTracker::GetParentsNoGroup(CTxMemPool::txiter entry) const
+const CTxMemPool::linkEntries& CEvictionCandidateTracker::GetParentsNoGroup(CTxMemPool::txiter entry) const
 {
     return links.get().at(entry).parents;
 }
 
-const CTxMemPool::setEntries& CEvictionCandidateTracker::GetChildrenNoGroup(CTxMemPool::txiter entry) const
+const CTxMemPool::linkEntries& CEvictionCandidateTracker::GetChildrenNoGroup(CTxMemPool::txiter entry) const
 {
     return links.get().at(entry).children;
 }
@@ -132,7 +132,7 @@ void CEvictionCandidateTracker::EntryAdded(CTxMemPool::txiter entry)
     InsertEntry(entry);
 }
 
-void CEvictionCandidateTracker::EntryRemoved(const TxId& txId, const CTxMemPool::setEntries& immediateParents)
+void CEvictionCandidateTracker::EntryRemoved(const TxId& txId, const CTxMemPool::linkEntries& immediateParents)
 {
     ExpireEntry(txId);
     PopExpired();
@@ -99,9 +99,9 @@ private:
     void PopExpired(); 
 
     // direct parents of the tx
-    const CTxMemPool::setEntries& GetParentsNoGroup(CTxMemPool::txiter entry) const; 
+    const CTxMemPool::linkEntries& GetParentsNoGroup(CTxMemPool::txiter entry) const; 
     // direct children of the tx
-    const CTxMemPool::setEntries& GetChildrenNoGroup(CTxMemPool::txiter entry) const; 
+    const CTxMemPool::linkEntries& GetChildrenNoGroup(CTxMemPool::txiter entry) const; 
 
     // returns true if any of the group members has non-group child
     bool HasChildren(const CPFPGroup& group) const; 
@@ -129,7 +129,7 @@ public:
 
     // notifies the tracker that an entry (transaction) is removed from the mempool
     // call AFTER mapLinks and groups are updated
-    void EntryRemoved(const TxId& txId, const CTxMemPool::setEntries& immediateParents);
+    void EntryRemoved(const TxId& txId, const CTxMemPool::linkEntries& immediateParents);
 
     // notifies the tracker that an entry (transaction) is modified in such way that 
     // that it might change transactions worth (modified fee, added or removed from the primary mempool)
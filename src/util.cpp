@@ -540,21 +540,39 @@ bool TryCreateDirectories(const fs::path &p) {
     return false;
 }
 
-void FileCommit(FILE *file) {
+bool FileCommit(FILE *file) {
     // Harmless if redundantly called.
-    fflush(file);
+    if (fflush(file) != 0) {
+        LogPrintf("%s: fflush failed: %d\n", __func__, errno);
+        return false;
+    }
 #ifdef WIN32
     HANDLE hFile = (HANDLE)_get_osfhandle(_fileno(file));
-    FlushFileBuffers(hFile);
+    if (FlushFileBuffers(hFile) == 0) {
+        LogPrintf("%s: FlushFileBuffers failed: %d\n", __func__,
+                  GetLastError());
+        return false;
+    }
 #else
 #if defined(__linux__) || defined(__NetBSD__)
-    fdatasync(fileno(file));
+    // Ignore EINVAL for filesystems that don't support sync
+    if (fdatasync(fileno(file)) != 0 && errno != EINVAL) {
+        LogPrintf("%s: fdatasync failed: %d\n", __func__, errno);
+        return false;
+    }
 #elif defined(__APPLE__) && defined(F_FULLFSYNC)
-    fcntl(fileno(file), F_FULLFSYNC, 0);
+    if (fcntl(fileno(file), F_FULLFSYNC, 0) == -1) {
+        LogPrintf("%s: fcntl F_FULLFSYNC failed: %d\n", __func__, errno);
+        return false;
+    }
 #else
-    fsync(fileno(file));
+    if (fsync(fileno(file)) != 0 && errno != EINVAL) {
+        LogPrintf("%s: fsync failed: %d\n", __func__, errno);
+        return false;
+    }
 #endif
 #endif
+    return true;
 }
 
 bool TruncateFile(FILE *file, uint64_t length) {
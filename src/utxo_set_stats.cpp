@@ -0,0 +1,145 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "utxo_set_stats.h"
+
+#include "primitives/block.h"
+#include "primitives/transaction.h"
+#include "streams.h"
+#include "undo.h"
+#include "version.h"
+
+namespace
+{
+    uint64_t GetCoinBogoSize(const CTxOut& txOut)
+    {
+        return
+            32 /* txid */ + 4 /* vout index */ + 4 /* height + coinbase */ +
+            8 /* amount */ + 2 /* scriptPubKey len */ +
+            txOut.scriptPubKey.size() /* scriptPubKey */;
+    }
+
+    CDataStream SerializeCoin(
+        const COutPoint& outpoint,
+        const CTxOut& txOut,
+        int32_t height,
+        bool isCoinBase)
+    {
+        CDataStream ss(SER_DISK, PROTOCOL_VERSION);
+        ss << outpoint;
+        ss << static_cast<uint32_t>(height * 2 + isCoinBase);
+        ss << txOut;
+        return ss;
+    }
+}
+
+void UTXOSetStats::AddCoin(
+    const COutPoint& outpoint,
+    const CTxOut& txOut,
+    int32_t height,
+    bool isCoinBase)
+{
+    auto ss = SerializeCoin(outpoint, txOut, height, isCoinBase);
+    mHash.Insert(reinterpret_cast<const uint8_t*>(ss.data()), ss.size());
+
+    ++mTransactionOutputs;
+    mBogoSize += GetCoinBogoSize(txOut);
+    mTotalAmount += txOut.nValue;
+}
+
+void UTXOSetStats::RemoveCoin(
+    const COutPoint& outpoint,
+    const CTxOut& txOut,
+    int32_t height,
+    bool isCoinBase)
+{
+    auto ss = SerializeCoin(outpoint, txOut, height, isCoinBase);
+    mHash.Remove(reinterpret_cast<const uint8_t*>(ss.data()), ss.size());
+
+    --mTransactionOutputs;
+    mBogoSize -= GetCoinBogoSize(txOut);
+    mTotalAmount -= txOut.nValue;
+}
+
+UTXOSetStats& UTXOSetStats::operator+=(const UTXOSetStats& delta)
+{
+    mTransactionOutputs += delta.mTransactionOutputs;
+    mBogoSize += delta.mBogoSize;
+    mTotalAmount += delta.mTotalAmount;
+    mHash *= delta.mHash;
+
+    return *this;
+}
+
+uint256 UTXOSetStats::GetHash() const
+{
+    uint256 hash;
+    mHash.Finalize(*reinterpret_cast<uint8_t (*)[32]>(hash.begin()));
+    return hash;
+}
+
+bool UTXOSetStats::operator==(const UTXOSetStats& other) const
+{
+    return
+        mTransactionOutputs == other.mTransactionOutputs &&
+        mBogoSize == other.mBogoSize &&
+        mTotalAmount == other.mTotalAmount &&
+        GetHash() == other.GetHash();
+}
+
+UTXOSetStats GetBlockUTXOSetStatsDelta(
+    const CBlock& block,
+    const CBlockUndo& blockUndo,
+    bool genesisEnabled,
+    int32_t height,
+    bool connect)
+{
+    UTXOSetStats delta;
+
+    for (size_t i = 0; i < block.vtx.size(); ++i)
+    {
+        const CTransaction& tx = *block.vtx[i];
+        const TxId txid = tx.GetId();
+        const bool isCoinBase = tx.IsCoinBase();
+
+        for (size_t o = 0; o < tx.vout.size(); ++o)
+        {
+            if (tx.vout[o].scriptPubKey.IsUnspendable(genesisEnabled))
+            {
+                continue;
+            }
+
+            const COutPoint outpoint{txid, static_cast<uint32_t>(o)};
+            if (connect)
+            {
+                delta.AddCoin(outpoint, tx.vout[o], height, isCoinBase);
+            }
+            else
+            {
+                delta.RemoveCoin(outpoint, tx.vout[o], height, isCoinBase);
+            }
+        }
+
+        if (isCoinBase)
+        {
+            continue;
+        }
+
+        const CTxUndo& txUndo = blockUndo.vtxundo[i - 1];
+        for (size_t j = 0; j < tx.vin.size(); ++j)
+        {
+            const CoinWithScript& coin = txUndo.vprevout[j];
+            if (connect)
+            {
+                delta.RemoveCoin(tx.vin[j].prevout, coin.GetTxOut(), coin.GetHeight(), coin.IsCoinBase());
+            }
+            else
+            {
+                delta.AddCoin(tx.vin[j].prevout, coin.GetTxOut(), coin.GetHeight(), coin.IsCoinBase());
+            }
+        }
+    }
+
+    return delta;
+}
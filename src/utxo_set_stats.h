@@ -0,0 +1,83 @@
+// Copyright (c) 2021-2024 The MVC developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef MVC_UTXO_SET_STATS_H
+#define MVC_UTXO_SET_STATS_H
+
+#include "amount.h"
+#include "crypto/muhash.h"
+#include "serialize.h"
+#include "uint256.h"
+
+#include <cstdint>
+
+class CBlock;
+class CBlockUndo;
+class COutPoint;
+class CTxOut;
+
+/**
+ * Statistics about the unspent transaction output set that can be maintained
+ * incrementally as coins are added and spent.
+ *
+ * The same class is used for the statistics of the whole set and for changes
+ * to the statistics (e.g. caused by a single block) - changes are combined with
+ * operator+=. Set hash is order independent (MuHash3072) so changes can be
+ * combined in any order and counters of changes are allowed to wrap around.
+ */
+class UTXOSetStats
+{
+public:
+    void AddCoin(const COutPoint& outpoint, const CTxOut& txOut, int32_t height, bool isCoinBase);
+    void RemoveCoin(const COutPoint& outpoint, const CTxOut& txOut, int32_t height, bool isCoinBase);
+
+    UTXOSetStats& operator+=(const UTXOSetStats& delta);
+
+    uint64_t GetTransactionOutputs() const { return mTransactionOutputs; }
+    //! A database-independent metric for UTXO set size
+    uint64_t GetBogoSize() const { return mBogoSize; }
+    Amount GetTotalAmount() const { return mTotalAmount; }
+    //! Finalized set hash (expensive as it requires a modular inverse)
+    uint256 GetHash() const;
+
+    bool operator==(const UTXOSetStats& other) const;
+
+    ADD_SERIALIZE_METHODS
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action) {
+        READWRITE(mTransactionOutputs);
+        READWRITE(mBogoSize);
+        READWRITE(mTotalAmount);
+
+        uint8_t hash[MuHash3072::SERIALIZED_SIZE];
+        if (!ser_action.ForRead()) {
+            mHash.ToBytes(hash);
+        }
+        READWRITE(FLATDATA(hash));
+        if (ser_action.ForRead()) {
+            mHash = MuHash3072::FromBytes(hash);
+        }
+    }
+
+private:
+    uint64_t mTransactionOutputs{0};
+    uint64_t mBogoSize{0};
+    Amount mTotalAmount{0};
+    MuHash3072 mHash;
+};
+
+/**
+ * Calculate changes to UTXO set statistics caused by connecting a block (or
+ * disconnecting it if connect is false). Outputs are treated the same way as
+ * in AddCoins() - unspendable outputs never enter the UTXO set.
+ */
+UTXOSetStats GetBlockUTXOSetStatsDelta(
+    const CBlock& block,
+    const CBlockUndo& blockUndo,
+    bool genesisEnabled,
+    int32_t height,
+    bool connect);
+
+#endif // MVC_UTXO_SET_STATS_H
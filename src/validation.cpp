@@ -25,6 +25,7 @@
 #include "fs.h"
 #include "hash.h"
 #include "init.h"
+#include "merkletreestore.h"
 #include "mining/journal_builder.h"
 #include "net/net.h"
 #include "net/net_processing.h"
@@ -34,6 +35,7 @@
 #include "primitives/block.h"
 #include "primitives/transaction.h"
 #include "processing_block_index.h"
+#include "read_ahead_file_reader.h"
 #include "script/scriptcache.h"
 #include "script/sigcache.h"
 #include "script/standard.h"
@@ -92,6 +94,7 @@ bool fRequireStandard = true;
 bool fCheckBlockIndex = false;
 bool fCheckpointsEnabled = DEFAULT_CHECKPOINTS_ENABLED;
 size_t nCoinCacheUsage = 5000 * 300;
+int nCoinCacheIncrementalFlushPercent = nDefaultDbIncrementalFlush;
 uint64_t nPruneTarget = 0;
 int64_t nMaxTipAge = DEFAULT_MAX_TIP_AGE;
 
@@ -2455,6 +2458,16 @@ void UpdateCoins(const CTransaction &tx, CCoinsViewCache &inputs, int32_t nHeigh
 }
 
 std::optional<bool> CScriptCheck::operator()(const task::CCancellationToken& token)
+{
+    return Run(token, nullptr);
+}
+
+std::optional<bool> CScriptCheck::operator()(const task::CCancellationToken& token, CSignatureBatch& batch)
+{
+    return Run(token, &batch);
+}
+
+std::optional<bool> CScriptCheck::Run(const task::CCancellationToken& token, CSignatureBatch* batch)
 {
     const CScript &scriptSig = ptxTo->vin[nIn].scriptSig;
     return
@@ -2466,7 +2479,7 @@ std::optional<bool> CScriptCheck::operator()(const task::CCancellationToken& tok
             scriptPubKey,
             nFlags,
             CachingTransactionSignatureChecker(
-                ptxTo, nIn, amount, cacheStore, txdata),
+                ptxTo, nIn, amount, cacheStore, txdata, batch),
             &error);
 }
 
@@ -3078,9 +3091,14 @@ public:
         int64_t nTime6 = GetTimeMicros();
         nTimeCallbacks += nTime6 - nTime5;
 
+        mBlockUndo = std::make_shared<const CBlockUndo>(std::move(blockundo));
+
         return true;
     }
 
+    // Undo data of the connected block (null if Connect() didn't write any)
+    const std::shared_ptr<const CBlockUndo>& GetBlockUndo() const { return mBlockUndo; }
+
 private:
     bool checkScripts(
         const task::CCancellationToken& token,
@@ -3166,6 +3184,10 @@ private:
         CDiskTxPos pos(pindex->GetBlockPos(),
                        GetSizeOfCompactSize(block.vtx.size()));
 
+        // Load all coins spent by the block in bulk instead of reading them
+        // from the database one by one in the loop below.
+        view.PrefetchInputs(block.vtx);
+
         for (size_t i = 0; i < block.vtx.size(); i++) {
             auto& txRef = block.vtx[i];
             const CTransaction &tx = *txRef;
@@ -3394,6 +3416,7 @@ private:
     const arith_uint256& mostWorkOnChain;
     bool fJustCheck;
     bool parallelBlockValidation;
+    std::shared_ptr<const CBlockUndo> mBlockUndo;
 };
 
 /**
@@ -3414,6 +3437,8 @@ private:
  *       a better block candidate came in but all the checkers were already in
  *       use so check queue pool cancels the worst one for reuse with the better
  *       candidate).
+ *
+ * If blockUndoOut is not null it receives the undo data written for the block.
  */
 static bool ConnectBlock(
     const task::CCancellationToken& token,
@@ -3424,7 +3449,8 @@ static bool ConnectBlock(
     CBlockIndex *pindex,
     CCoinsViewCache &view,
     const arith_uint256& mostWorkOnChain,
-    bool fJustCheck = false)
+    bool fJustCheck = false,
+    std::shared_ptr<const CBlockUndo>* blockUndoOut = nullptr)
 {
     BlockConnector connector{
         parallelBlockValidation,
@@ -3436,7 +3462,17 @@ static bool ConnectBlock(
         mostWorkOnChain,
         fJustCheck };
 
-    return connector.Connect( token );
+    if (!connector.Connect( token ))
+    {
+        return false;
+    }
+
+    if (blockUndoOut)
+    {
+        *blockUndoOut = connector.GetBlockUndo();
+    }
+
+    return true;
 }
 
 
@@ -3454,6 +3490,7 @@ bool FlushStateToDisk(
     static int64_t nLastWrite = 0;
     static int64_t nLastFlush = 0;
     static int64_t nLastSetChain = 0;
+    static int64_t nLastIncrementalFlushCacheSize = 0;
     std::set<int> setFilesToPrune;
     bool fFlushForPrune = false;
     bool fDoFullFlush = false;
@@ -3516,8 +3553,17 @@ bool FlushStateToDisk(
             // Combine all conditions that result in a full cache flush.
             fDoFullFlush = (mode == FLUSH_STATE_ALWAYS) || fCacheLarge ||
                            fCacheCritical || fPeriodicFlush || fFlushForPrune;
+            // The cache is above the incremental flush limit and has grown
+            // since the last incremental flush. Write modified coins in the
+            // background so that the next full flush has less to write.
+            bool fIncrementalFlush =
+                !fDoFullFlush &&
+                nCoinCacheIncrementalFlushPercent > 0 &&
+                (mode == FLUSH_STATE_PERIODIC || mode == FLUSH_STATE_IF_NEEDED) &&
+                cacheSize > (nCoinCacheIncrementalFlushPercent * nTotalSpace) / 100 &&
+                cacheSize > nLastIncrementalFlushCacheSize + MAX_BLOCK_COINSDB_USAGE * static_cast<int64_t>(ONE_MEBIBYTE);
             // Write blocks and block index to disk.
-            if (fDoFullFlush || fPeriodicWrite) {
+            if (fDoFullFlush || fPeriodicWrite || fIncrementalFlush) {
                 // Depend on nMinDiskSpace to ensure we can write block index
                 if (!CheckDiskSpace(0)) {
                     return state.Error("out of disk space");
@@ -3569,6 +3615,13 @@ bool FlushStateToDisk(
                     return AbortNode(state, "Failed to write to coin database");
                 }
                 nLastFlush = nNow;
+                nLastIncrementalFlushCacheSize = 0;
+            }
+            // Block index was written above so coins database may now refer
+            // to the current tip.
+            if (fIncrementalFlush && chainActive.Tip()) {
+                pcoinsTip->WriteDirtyCoinsAsync(chainActive.Tip()->GetBlockHash());
+                nLastIncrementalFlushCacheSize = cacheSize;
             }
         }
         if (fDoFullFlush ||
@@ -3697,11 +3750,19 @@ static bool DisconnectTip(const Config &config, CValidationState &state,
     {
         CoinsDBSpan pCoinsTipSpan{ *pcoinsTip };
         assert(pCoinsTipSpan.GetBestBlock() == pindexDelete->GetBlockHash());
-        if (ProcessingBlockIndex(*pindexDelete).DisconnectBlock(block, pCoinsTipSpan, task::CCancellationSource::Make()->GetToken()) != DISCONNECT_OK) {
+        std::shared_ptr<const CBlockUndo> blockUndo;
+        if (ProcessingBlockIndex(*pindexDelete).DisconnectBlock(block, pCoinsTipSpan, task::CCancellationSource::Make()->GetToken(), &blockUndo) != DISCONNECT_OK) {
             return error("DisconnectTip(): DisconnectBlock %s failed",
                          pindexDelete->GetBlockHash().ToString());
         }
 
+        pCoinsTipSpan.TrackUTXOSetStats(
+            pblock,
+            blockUndo,
+            *pindexDelete,
+            IsGenesisEnabled(config, pindexDelete->GetHeight()),
+            false);
+
         // NOTE:
         // TryFlush() will never fail as cs_main is used to synchronize
         // the different threads that Flush() or TryFlush() data. If cs_main
@@ -3890,6 +3951,7 @@ static bool ConnectTip(
         // result
         connectTrace.TracePoolEntryRemovedEvents(!parallelBlockValidation);
 
+        std::shared_ptr<const CBlockUndo> blockUndo;
         bool rv =
             ConnectBlock(
                 token,
@@ -3899,7 +3961,9 @@ static bool ConnectTip(
                 state,
                 pindexNew,
                 pCoinsTipSpan,
-                mostWorkOnChain);
+                mostWorkOnChain,
+                false,
+                &blockUndo);
 
         // re-enable tracing of events if it was disabled
         connectTrace.TracePoolEntryRemovedEvents(true);
@@ -3916,6 +3980,13 @@ static bool ConnectTip(
         nTime3 = GetTimeMicros();
         nTimeConnectTotal += nTime3 - nTime2;
 
+        pCoinsTipSpan.TrackUTXOSetStats(
+            pthisBlock,
+            blockUndo,
+            *pindexNew,
+            IsGenesisEnabled(config, pindexNew->GetHeight()),
+            true);
+
         // NOTE:
         // TryFlush() will never fail as cs_main is used to synchronize
         // the different threads that Flush() or TryFlush() data. If cs_main
@@ -3957,6 +4028,18 @@ static bool ConnectTip(
     // Update chainActive & related variables.
     UpdateTip(config, pindexNew);
 
+    // Store merkle tree calculated by CheckBlock() now that the block is
+    // connected. During initial block download trees are not stored since
+    // merkle proofs are rarely requested for old blocks and are calculated
+    // on request.
+    if (blockConnecting.calculatedMerkleTree) {
+        if (pMerkleTreeFactory && !IsInitialBlockDownload()) {
+            pMerkleTreeFactory->StoreMerkleTree(
+                config, blockConnecting.calculatedMerkleTree, pindexNew->GetHeight());
+        }
+        blockConnecting.calculatedMerkleTree.reset();
+    }
+
     int64_t nTime6 = GetTimeMicros();
     nTimePostConnect += nTime6 - nTime5;
     nTimeTotal += nTime6 - nTime1;
@@ -5054,7 +5137,18 @@ bool CheckBlock(const Config &config, const CBlock &block,
     // Check the merkle root.
     if (validationOptions.shouldValidateMerkleRoot()) {
         bool mutated;
-        uint256 hashMerkleRoot2 = BlockMerkleRoot(block, &mutated);
+        uint256 hashMerkleRoot2;
+        // Merkle tree calculated in parallel
+        CMerkleTreeRef merkleTree;
+        if (block.precomputedMerkleRoot) {
+            std::tie(hashMerkleRoot2, mutated) = *block.precomputedMerkleRoot;
+        } else if (pMerkleTreeFactory) {
+            merkleTree = pMerkleTreeFactory->CalculateMerkleTree(block, blockHeight);
+            hashMerkleRoot2 = merkleTree->GetMerkleRoot();
+            mutated = merkleTree->HasDuplicateSiblings();
+        } else {
+            hashMerkleRoot2 = BlockMerkleRoot(block, &mutated);
+        }
         if (config.GetChainParams().NetworkIDString() == CBaseChainParams::MAIN && blockHeight == 0) {
             hashMerkleRoot2 = uint256S("da2b9eb7e8a3619734a17b55c47bdd6fd855b0afa9c7e14e3a164a279e51bba9");
         }
@@ -5068,6 +5162,12 @@ bool CheckBlock(const Config &config, const CBlock &block,
         if (mutated) {
             return state.CorruptionOrDoS("bad-txns-duplicate", "duplicate transaction");
         }
+
+        // Keep trees of blocks that passed the PoW check (not block
+        // templates) - ConnectTip() stores them for merkle proof requests
+        if (merkleTree && validationOptions.shouldValidatePoW()) {
+            block.calculatedMerkleTree = std::move(merkleTree);
+        }
     }
 
     // All potential-corruption validation must be done before we do any
@@ -5740,6 +5840,13 @@ std::function<bool()> ProcessNewBlockWithAsyncBestChainActivation(
         // belt-and-suspenders.
         bool ret = CheckBlock(config, *pblock, state, pindexPrev->GetHeight() + 1, validationOptions);
 
+        // Collect the inputs to prefetch before taking cs_main as walking
+        // every input of a large block takes a while
+        std::vector<COutPoint> externalInputs {};
+        if (ret) {
+            externalInputs = GetExternalInputs(pblock->vtx);
+        }
+
         LOCK(cs_main);
 
         if (ret) {
@@ -5754,6 +5861,13 @@ std::function<bool()> ProcessNewBlockWithAsyncBestChainActivation(
 
             return {};
         }
+
+        // Start warming up coins cache while the block is waiting for best
+        // chain activation if it is going to be connected on top of the tip.
+        if (pindex && pindex->GetPrev() == chainActive.Tip())
+        {
+            pcoinsTip->PrefetchCoinsAsync(std::move(externalInputs));
+        }
     }
 
     NotifyHeaderTip();
@@ -6526,10 +6640,14 @@ bool LoadExternalBlockFile(const Config &config, UniqueCFile fileIn,
     int nLoaded = 0;
     try {
         // This takes over fileIn and calls fclose() on it in the CBufferedFile destructor.
+        // Reader keeps the following reads in flight while blocks are being
+        // processed.
         CBufferedFile blkdat{
-            { std::move(fileIn), SER_DISK, CLIENT_VERSION },
+            std::make_unique<CReadAheadFileReader>(std::move(fileIn)),
             2 * ONE_MEGABYTE,
-            ONE_MEGABYTE + 8};
+            ONE_MEGABYTE + 8,
+            SER_DISK,
+            CLIENT_VERSION};
         uint64_t nRewind = blkdat.GetPos();
         while (!blkdat.eof()) {
             boost::this_thread::interruption_point();
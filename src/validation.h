@@ -48,6 +48,7 @@ class CConnman;
 class CInv;
 class Config;
 class CScriptCheck;
+class CSignatureBatch;
 class CTxMemPool;
 struct CTxnHandlers;
 class CTxUndo;
@@ -189,6 +190,8 @@ static const unsigned int DEFAULT_INVALID_CHECKSUM_FREQUENCY = 100;
 
 /** Default for -persistmempool */
 static const bool DEFAULT_PERSIST_MEMPOOL = true;
+/** Default for -persistmempooltrusted */
+static const bool DEFAULT_PERSIST_MEMPOOL_TRUSTED = false;
 /** Default for using fee filter */
 static const bool DEFAULT_FEEFILTER = true;
 
@@ -227,6 +230,11 @@ extern bool fRequireStandard;
 extern bool fCheckBlockIndex;
 extern bool fCheckpointsEnabled;
 extern size_t nCoinCacheUsage;
+/**
+ * Percent of coins cache size limit above which modified coins are written to
+ * database in the background (0 = disabled).
+ */
+extern int nCoinCacheIncrementalFlushPercent;
 
 /**
  * Absolute maximum transaction fee (in satoshis) used by wallet and mempool
@@ -1006,6 +1014,8 @@ private:
     std::reference_wrapper<const Config> config;
     bool consensus = false;
 
+    std::optional<bool> Run(const task::CCancellationToken& token, CSignatureBatch* batch);
+
 public:
     CScriptCheck(const Config &configIn, bool consensusIn, const CScript &scriptPubKeyIn, const Amount amountIn,
                  const CTransaction &txToIn, unsigned int nInIn,
@@ -1015,7 +1025,12 @@ public:
           nIn(nInIn), nFlags(nFlagsIn), cacheStore(cacheIn),
           error(SCRIPT_ERR_UNKNOWN_ERROR), txdata(txdataIn), config(configIn), consensus(consensusIn) {}
 
+    // Signature checks that can be deferred are collected in batches by the
+    // check queue (see CCheckQueue)
+    using Batch = CSignatureBatch;
+
     std::optional<bool> operator()(const task::CCancellationToken& token);
+    std::optional<bool> operator()(const task::CCancellationToken& token, CSignatureBatch& batch);
 
     ScriptError GetScriptError() const { return error; }
 